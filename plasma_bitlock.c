@@ -0,0 +1,131 @@
+/*
+ * plasma_bitlock - bit spinlocks in caller-owned words and tagged pointers
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define PLASMA_FEATURE_DISABLE_WIN32_FULLHDRS
+#define PLASMA_BITLOCK_C99INLINE_FUNCS
+
+/* inlined functions defined in header
+ * (generate external linkage definition in GCC versions earlier than GCC 4.3)*/
+#if defined(NO_C99INLINE) \
+ || defined(__clang__) || (defined(__GNUC__) && !defined(__GNUC_STDC_INLINE__))
+#define PLASMA_BITLOCK_C99INLINE
+#endif
+
+#include "plasma_bitlock.h"
+#include "plasma_spin.h"
+
+/* (test-and-test-and-set: wait with relaxed loads until bit is clear,
+ *  pausing for PLASMA_BITLOCK_SPIN_NS and then yielding, then retry)
+ * (see plasma_spin_wait_yield()) */
+
+void
+plasma_bitlock_acquire_spin_u32 (uint32_t * const word, const uint32_t mask)
+{
+    uint32_t spins = plasma_spin_wait_budget_ns(PLASMA_BITLOCK_SPIN_NS);
+    do {
+        while (plasma_atomic_load_explicit(word, memory_order_relaxed) & mask)
+            plasma_spin_wait_yield(&spins);
+    } while (plasma_atomic_fetch_or_u32(word, mask, memory_order_acquire)
+             & mask);
+}
+
+void
+plasma_bitlock_acquire_spin_u64 (uint64_t * const word, const uint64_t mask)
+{
+    uint32_t spins = plasma_spin_wait_budget_ns(PLASMA_BITLOCK_SPIN_NS);
+    do {
+        while (plasma_atomic_load_explicit(word, memory_order_relaxed) & mask)
+            plasma_spin_wait_yield(&spins);
+    } while (plasma_atomic_fetch_or_u64(word, mask, memory_order_acquire)
+             & mask);
+}
+
+void
+plasma_bitlock_acquire_spin_ptr (void ** const ptr)
+{
+    uint32_t spins = plasma_spin_wait_budget_ns(PLASMA_BITLOCK_SPIN_NS);
+    do {
+        while ((uintptr_t)plasma_atomic_load_explicit(ptr, memory_order_relaxed)
+               & PLASMA_BITLOCK_PTR_BIT)
+            plasma_spin_wait_yield(&spins);
+    } while (!plasma_bitlock_acquire_try_ptr(ptr));
+}
+
+
+/* inlined functions defined in header
+ * (generate external linkage definition in C99-compliant compilers)
+ * (need to -duplicate- definition from header for non-C99-compliant compilers)
+ */
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__)
+extern inline
+bool
+plasma_bitlock_acquire_try_u32 (uint32_t * const word, const unsigned int bit);
+bool
+plasma_bitlock_acquire_try_u32 (uint32_t * const word, const unsigned int bit);
+
+extern inline
+void
+plasma_bitlock_acquire_u32 (uint32_t * const word, const unsigned int bit);
+void
+plasma_bitlock_acquire_u32 (uint32_t * const word, const unsigned int bit);
+
+extern inline
+void
+plasma_bitlock_release_u32 (uint32_t * const word, const unsigned int bit);
+void
+plasma_bitlock_release_u32 (uint32_t * const word, const unsigned int bit);
+
+extern inline
+bool
+plasma_bitlock_acquire_try_u64 (uint64_t * const word, const unsigned int bit);
+bool
+plasma_bitlock_acquire_try_u64 (uint64_t * const word, const unsigned int bit);
+
+extern inline
+void
+plasma_bitlock_acquire_u64 (uint64_t * const word, const unsigned int bit);
+void
+plasma_bitlock_acquire_u64 (uint64_t * const word, const unsigned int bit);
+
+extern inline
+void
+plasma_bitlock_release_u64 (uint64_t * const word, const unsigned int bit);
+void
+plasma_bitlock_release_u64 (uint64_t * const word, const unsigned int bit);
+
+extern inline
+bool
+plasma_bitlock_acquire_try_ptr (void ** const ptr);
+bool
+plasma_bitlock_acquire_try_ptr (void ** const ptr);
+
+extern inline
+void
+plasma_bitlock_acquire_ptr (void ** const ptr);
+void
+plasma_bitlock_acquire_ptr (void ** const ptr);
+
+extern inline
+void
+plasma_bitlock_release_ptr (void ** const ptr);
+void
+plasma_bitlock_release_ptr (void ** const ptr);
+#endif
@@ -0,0 +1,249 @@
+/*
+ * plasma_bitlock - bit spinlocks in caller-owned words and tagged pointers
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_PLASMA_BITLOCK_H
+#define INCLUDED_PLASMA_BITLOCK_H
+
+#include "plasma_feature.h"
+#include "plasma_attr.h"
+#include "plasma_membar.h"
+#include "plasma_atomic.h"
+PLASMA_ATTR_Pragma_once
+
+#ifndef PLASMA_BITLOCK_C99INLINE
+#define PLASMA_BITLOCK_C99INLINE C99INLINE
+#endif
+#ifndef NO_C99INLINE
+#ifndef PLASMA_BITLOCK_C99INLINE_FUNCS
+#define PLASMA_BITLOCK_C99INLINE_FUNCS
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* plasma_bitlock_acquire_u32()     plasma_bitlock_acquire_u64()
+ * plasma_bitlock_acquire_try_u32() plasma_bitlock_acquire_try_u64()
+ * plasma_bitlock_release_u32()     plasma_bitlock_release_u64()
+ *
+ * Spinlock occupying a single bit of a caller-owned 32-bit or 64-bit word,
+ * e.g. a flag bit in a hash bucket or list node header, avoiding a separate
+ * lock word.  Acquire is plasma_atomic_fetch_or_*() (memory_order_acquire),
+ * and release is plasma_atomic_fetch_and_*() (memory_order_release).  Other
+ * bits in the word are preserved, and may be modified concurrently by the
+ * caller, but only with atomic operations.  Contended acquire spins
+ * (test-and-test-and-set) with plasma_spin_pause() for PLASMA_BITLOCK_SPIN_NS
+ * and then with plasma_spin_yield() between checks.  Lock is not fair and
+ * does not park; use for short critical sections (see plasma_parkinglot.h
+ * plasma_parklock_*() for a compact lock which parks).
+ *
+ * plasma_bitlock_acquire_ptr()
+ * plasma_bitlock_acquire_try_ptr()
+ * plasma_bitlock_release_ptr()
+ * plasma_bitlock_ptr_get()
+ * plasma_bitlock_ptr_set()
+ *
+ * Spinlock in low bit (PLASMA_BITLOCK_PTR_BIT) of a pointer to an object
+ * aligned to at least 2 bytes, e.g. head pointer of a hash bucket chain.
+ * plasma_bitlock_ptr_get() returns pointer with lock bit masked off (relaxed
+ * load; caller holds lock, or otherwise provides ordering).
+ * plasma_bitlock_ptr_set() stores new pointer while lock is held (keeps lock
+ * bit set; lock remains held until plasma_bitlock_release_ptr()).
+ */
+
+#ifndef PLASMA_BITLOCK_SPIN_NS
+#define PLASMA_BITLOCK_SPIN_NS 4000
+#endif
+
+#define PLASMA_BITLOCK_PTR_BIT ((uintptr_t)1u)
+
+#define plasma_bitlock_ptr_get(ptr) \
+        ((void *)((uintptr_t)                                                \
+          plasma_atomic_load_explicit((ptr), memory_order_relaxed)           \
+          & ~PLASMA_BITLOCK_PTR_BIT))
+
+#define plasma_bitlock_ptr_set(ptr, val) \
+        plasma_atomic_store_explicit((ptr),                                  \
+          (void *)((uintptr_t)(val) | PLASMA_BITLOCK_PTR_BIT),               \
+          memory_order_relaxed)
+
+__attribute_noinline__
+__attribute_nonnull__()
+void
+plasma_bitlock_acquire_spin_u32 (uint32_t * const word, const uint32_t mask);
+
+__attribute_noinline__
+__attribute_nonnull__()
+void
+plasma_bitlock_acquire_spin_u64 (uint64_t * const word, const uint64_t mask);
+
+__attribute_noinline__
+__attribute_nonnull__()
+void
+plasma_bitlock_acquire_spin_ptr (void ** const ptr);
+
+__attribute_nonnull__()
+PLASMA_BITLOCK_C99INLINE
+bool
+plasma_bitlock_acquire_try_u32 (uint32_t * const word, const unsigned int bit);
+#ifdef PLASMA_BITLOCK_C99INLINE_FUNCS
+PLASMA_BITLOCK_C99INLINE
+bool
+plasma_bitlock_acquire_try_u32 (uint32_t * const word, const unsigned int bit)
+{
+    const uint32_t mask = (uint32_t)1u << bit;
+    return !(plasma_atomic_fetch_or_u32(word, mask, memory_order_acquire)
+             & mask);
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_BITLOCK_C99INLINE
+void
+plasma_bitlock_acquire_u32 (uint32_t * const word, const unsigned int bit);
+#ifdef PLASMA_BITLOCK_C99INLINE_FUNCS
+PLASMA_BITLOCK_C99INLINE
+void
+plasma_bitlock_acquire_u32 (uint32_t * const word, const unsigned int bit)
+{
+    if (__builtin_expect( (!plasma_bitlock_acquire_try_u32(word, bit)), 0))
+        plasma_bitlock_acquire_spin_u32(word, (uint32_t)1u << bit);
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_BITLOCK_C99INLINE
+void
+plasma_bitlock_release_u32 (uint32_t * const word, const unsigned int bit);
+#ifdef PLASMA_BITLOCK_C99INLINE_FUNCS
+PLASMA_BITLOCK_C99INLINE
+void
+plasma_bitlock_release_u32 (uint32_t * const word, const unsigned int bit)
+{
+    plasma_atomic_fetch_and_u32(word, ~((uint32_t)1u << bit),
+                                memory_order_release);
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_BITLOCK_C99INLINE
+bool
+plasma_bitlock_acquire_try_u64 (uint64_t * const word, const unsigned int bit);
+#ifdef PLASMA_BITLOCK_C99INLINE_FUNCS
+PLASMA_BITLOCK_C99INLINE
+bool
+plasma_bitlock_acquire_try_u64 (uint64_t * const word, const unsigned int bit)
+{
+    const uint64_t mask = (uint64_t)1u << bit;
+    return !(plasma_atomic_fetch_or_u64(word, mask, memory_order_acquire)
+             & mask);
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_BITLOCK_C99INLINE
+void
+plasma_bitlock_acquire_u64 (uint64_t * const word, const unsigned int bit);
+#ifdef PLASMA_BITLOCK_C99INLINE_FUNCS
+PLASMA_BITLOCK_C99INLINE
+void
+plasma_bitlock_acquire_u64 (uint64_t * const word, const unsigned int bit)
+{
+    if (__builtin_expect( (!plasma_bitlock_acquire_try_u64(word, bit)), 0))
+        plasma_bitlock_acquire_spin_u64(word, (uint64_t)1u << bit);
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_BITLOCK_C99INLINE
+void
+plasma_bitlock_release_u64 (uint64_t * const word, const unsigned int bit);
+#ifdef PLASMA_BITLOCK_C99INLINE_FUNCS
+PLASMA_BITLOCK_C99INLINE
+void
+plasma_bitlock_release_u64 (uint64_t * const word, const unsigned int bit)
+{
+    plasma_atomic_fetch_and_u64(word, ~((uint64_t)1u << bit),
+                                memory_order_release);
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_BITLOCK_C99INLINE
+bool
+plasma_bitlock_acquire_try_ptr (void ** const ptr);
+#ifdef PLASMA_BITLOCK_C99INLINE_FUNCS
+PLASMA_BITLOCK_C99INLINE
+bool
+plasma_bitlock_acquire_try_ptr (void ** const ptr)
+{
+    return !((uintptr_t)
+             plasma_atomic_fetch_or_ptr(ptr, PLASMA_BITLOCK_PTR_BIT,
+                                        memory_order_acquire)
+             & PLASMA_BITLOCK_PTR_BIT);
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_BITLOCK_C99INLINE
+void
+plasma_bitlock_acquire_ptr (void ** const ptr);
+#ifdef PLASMA_BITLOCK_C99INLINE_FUNCS
+PLASMA_BITLOCK_C99INLINE
+void
+plasma_bitlock_acquire_ptr (void ** const ptr)
+{
+    if (__builtin_expect( (!plasma_bitlock_acquire_try_ptr(ptr)), 0))
+        plasma_bitlock_acquire_spin_ptr(ptr);
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_BITLOCK_C99INLINE
+void
+plasma_bitlock_release_ptr (void ** const ptr);
+#ifdef PLASMA_BITLOCK_C99INLINE_FUNCS
+PLASMA_BITLOCK_C99INLINE
+void
+plasma_bitlock_release_ptr (void ** const ptr)
+{
+    plasma_atomic_fetch_and_ptr(ptr, ~PLASMA_BITLOCK_PTR_BIT,
+                                memory_order_release);
+}
+#endif
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+
+/* NOTES and REFERENCES
+ *
+ * Linux kernel bit spinlocks (include/linux/bit_spinlock.h)
+ *   bit_spin_lock(), bit_spin_trylock(), bit_spin_unlock()
+ * Linux kernel hlist_bl (include/linux/list_bl.h)
+ *   (hash bucket list head with lock in low bit of pointer)
+ */
@@ -0,0 +1,118 @@
+/*
+ * plasma_cond - condition variable for use with plasma locks
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define PLASMA_FEATURE_DISABLE_WIN32_FULLHDRS
+#define PLASMA_COND_C99INLINE_FUNCS
+
+/* inlined functions defined in header
+ * (generate external linkage definition in GCC versions earlier than GCC 4.3)*/
+#if defined(NO_C99INLINE) \
+ || defined(__clang__) || (defined(__GNUC__) && !defined(__GNUC_STDC_INLINE__))
+#define PLASMA_COND_C99INLINE
+#endif
+
+#include "plasma_cond.h"
+#include "plasma_futex.h"
+
+bool
+plasma_cond_timedwait (plasma_cond_t * const restrict cond, void * const lock,
+                       plasma_cond_lockfn_t acquire,
+                       plasma_cond_lockfn_t release,
+                       const uint64_t timeout_ns)
+{
+    uint32_t seq;
+    bool rc;
+    /* register as waiter and read seq prior to releasing lock
+     * (signal or broadcast after lock release changes seq) */
+    plasma_atomic_fetch_add_u32(&cond->waiters, 1, memory_order_seq_cst);
+    seq = plasma_atomic_load_explicit(&cond->seq, memory_order_seq_cst);
+    release(lock);
+    rc = plasma_futex_wait(&cond->seq, seq, timeout_ns);
+    plasma_atomic_fetch_sub_u32(&cond->waiters, 1, memory_order_relaxed);
+    acquire(lock);
+    return rc;
+}
+
+bool
+plasma_cond_timedwait_futexlock (plasma_cond_t * const restrict cond,
+                                 plasma_spin_futexlock_t * const restrict lock,
+                                 const uint64_t timeout_ns)
+{
+    uint32_t * const lck = &lock->lck;
+    uint32_t seq;
+    bool rc;
+    plasma_atomic_fetch_add_u32(&cond->waiters, 1, memory_order_seq_cst);
+    seq = plasma_atomic_load_explicit(&cond->seq, memory_order_seq_cst);
+    plasma_spin_futexlock_release(lock);
+    rc = plasma_futex_wait(&cond->seq, seq, timeout_ns);
+    plasma_atomic_fetch_sub_u32(&cond->waiters, 1, memory_order_relaxed);
+    /* re-acquire lock marked contended (see plasma_spin_futexlock_t)
+     * (waiter might have been requeued onto lock word with other waiters;
+     *  lock release must then wake next requeued waiter) */
+    while (plasma_atomic_exchange_n_u32(lck, PLASMA_SPIN_FUTEXLOCK_WAITERS,
+                                        memory_order_acquire)
+           != PLASMA_SPIN_FUTEXLOCK_UNLOCKED)
+        plasma_futex_wait(lck, PLASMA_SPIN_FUTEXLOCK_WAITERS,
+                          PLASMA_FUTEX_INFINITE);
+    return rc;
+}
+
+void
+plasma_cond_wake (plasma_cond_t * const restrict cond, const bool all)
+{
+    plasma_atomic_fetch_add_u32(&cond->seq, 1, memory_order_release);
+    if (all)
+        plasma_futex_wake_all(&cond->seq);
+    else
+        plasma_futex_wake_one(&cond->seq);
+}
+
+void
+plasma_cond_broadcast_requeue (plasma_cond_t * const restrict cond,
+                               plasma_spin_futexlock_t * const restrict lock)
+{
+    /* wake one waiter; move remaining waiters to lock word
+     * (falls back to waking all if seq changed concurrently) */
+    uint32_t seq;
+    if (!plasma_atomic_load_explicit(&cond->waiters, memory_order_seq_cst))
+        return;
+    seq = plasma_atomic_fetch_add_u32(&cond->seq, 1, memory_order_release) + 1;
+    plasma_futex_requeue(&cond->seq, seq, 1, &lock->lck);
+}
+
+
+/* inlined functions defined in header
+ * (generate external linkage definition in C99-compliant compilers)
+ * (need to -duplicate- definition from header for non-C99-compliant compilers)
+ */
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__)
+extern inline
+void
+plasma_cond_signal (plasma_cond_t * const restrict cond);
+void
+plasma_cond_signal (plasma_cond_t * const restrict cond);
+
+extern inline
+void
+plasma_cond_broadcast (plasma_cond_t * const restrict cond);
+void
+plasma_cond_broadcast (plasma_cond_t * const restrict cond);
+#endif
@@ -0,0 +1,180 @@
+/*
+ * plasma_cond - condition variable for use with plasma locks
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_PLASMA_COND_H
+#define INCLUDED_PLASMA_COND_H
+
+#include "plasma_feature.h"
+#include "plasma_attr.h"
+#include "plasma_membar.h"
+#include "plasma_atomic.h"
+#include "plasma_spin.h"
+PLASMA_ATTR_Pragma_once
+
+#ifndef PLASMA_COND_C99INLINE
+#define PLASMA_COND_C99INLINE C99INLINE
+#endif
+#ifndef NO_C99INLINE
+#ifndef PLASMA_COND_C99INLINE_FUNCS
+#define PLASMA_COND_C99INLINE_FUNCS
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* plasma_cond_init()
+ * plasma_cond_wait()
+ * plasma_cond_timedwait()
+ * plasma_cond_signal()
+ * plasma_cond_broadcast()
+ *
+ * Condition variable (process-private) usable with any plasma lock (or any
+ * other lock) via lock acquire and release callbacks, which receive the lock
+ * pointer passed to plasma_cond_wait().  PLASMA_COND_LOCKFNS() defines
+ * type-safe callbacks for a lock type, e.g.
+ *   PLASMA_COND_LOCKFNS(tktlock, plasma_spin_tktlock_t,
+ *                       plasma_spin_tktlock_acquire,
+ *                       plasma_spin_tktlock_release)
+ * defines static functions tktlock_acquire_cb() and tktlock_release_cb()
+ *   plasma_spin_tktlock_acquire(&lock);
+ *   while (!condition)
+ *       plasma_cond_wait(&cond, &lock, tktlock_acquire_cb, tktlock_release_cb);
+ *   plasma_spin_tktlock_release(&lock);
+ *
+ * Waiter reads sequence number, releases lock, parks (plasma_futex_wait() on
+ * sequence number) until signalled, and then re-acquires lock.  Signal and
+ * broadcast advance sequence number and wake one or all waiters, skipping
+ * the wake (system call) when no thread is waiting.  Spurious wakeups are
+ * possible; callers must re-check condition in a loop (as with pthreads).
+ * plasma_cond_timedwait() returns false on timeout (lock re-acquired).
+ *
+ * plasma_cond_wait_futexlock()
+ * plasma_cond_timedwait_futexlock()
+ * plasma_cond_broadcast_requeue()
+ *
+ * With plasma_spin_futexlock_t, broadcast can avoid a thundering herd: on
+ * Linux, plasma_cond_broadcast_requeue() wakes one waiter and requeues the
+ * rest onto the lock word (FUTEX_CMP_REQUEUE), so that each subsequent lock
+ * release wakes one more waiter (other platforms wake all waiters).  Waiters
+ * must wait with plasma_cond_wait_futexlock() or
+ * plasma_cond_timedwait_futexlock(), which re-acquire the lock marked
+ * contended (required to propagate wakeups to requeued waiters).  Do not mix
+ * plasma_cond_broadcast_requeue() with waiters using other locks.
+ */
+
+typedef void (*plasma_cond_lockfn_t)(void *lock);
+
+#define PLASMA_COND_LOCKFNS(name, locktype, acquire, release)          \
+        static void name##_acquire_cb (void * const lock)                \
+        { (void)acquire((locktype *)lock); }                             \
+        static void name##_release_cb (void * const lock)                \
+        { release((locktype *)lock); }
+
+typedef __attribute_aligned__(16)
+struct plasma_cond_t {
+    uint32_t seq;     /* (futex word) */
+    uint32_t waiters;
+    uint64_t udata64; /* user data 8-bytes */
+} plasma_cond_t;
+
+#if (defined(__STDC_VERSION__) && __STDC_VERSION__-0 >= 199901L) /* C99 */
+#define PLASMA_COND_INITIALIZER { .seq = 0, .waiters = 0, .udata64 = 0 }
+#else
+#define PLASMA_COND_INITIALIZER { 0, 0, 0 }
+#endif
+#define plasma_cond_init(cond) \
+        ((cond)->seq = 0, (cond)->waiters = 0, (cond)->udata64 = 0)
+
+__attribute_nonnull__((1,3,4))
+bool
+plasma_cond_timedwait (plasma_cond_t * const restrict cond, void * const lock,
+                       plasma_cond_lockfn_t acquire,
+                       plasma_cond_lockfn_t release,
+                       const uint64_t timeout_ns);
+
+#define plasma_cond_wait(cond, lock, acquire, release) \
+        ((void)plasma_cond_timedwait((cond), (lock), (acquire), (release), \
+                                     UINT64_MAX))
+
+__attribute_nonnull__()
+bool
+plasma_cond_timedwait_futexlock (plasma_cond_t * const restrict cond,
+                                 plasma_spin_futexlock_t * const restrict lock,
+                                 const uint64_t timeout_ns);
+
+#define plasma_cond_wait_futexlock(cond, lock) \
+        ((void)plasma_cond_timedwait_futexlock((cond), (lock), UINT64_MAX))
+
+__attribute_nonnull__()
+void
+plasma_cond_wake (plasma_cond_t * const restrict cond, const bool all);
+
+__attribute_nonnull__()
+void
+plasma_cond_broadcast_requeue (plasma_cond_t * const restrict cond,
+                               plasma_spin_futexlock_t * const restrict lock);
+
+__attribute_nonnull__()
+PLASMA_COND_C99INLINE
+void
+plasma_cond_signal (plasma_cond_t * const restrict cond);
+#ifdef PLASMA_COND_C99INLINE_FUNCS
+PLASMA_COND_C99INLINE
+void
+plasma_cond_signal (plasma_cond_t * const restrict cond)
+{
+    /* (seq_cst pairs with waiter registration in plasma_cond_timedwait()) */
+    if (plasma_atomic_load_explicit(&cond->waiters, memory_order_seq_cst))
+        plasma_cond_wake(cond, false);
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_COND_C99INLINE
+void
+plasma_cond_broadcast (plasma_cond_t * const restrict cond);
+#ifdef PLASMA_COND_C99INLINE_FUNCS
+PLASMA_COND_C99INLINE
+void
+plasma_cond_broadcast (plasma_cond_t * const restrict cond)
+{
+    if (plasma_atomic_load_explicit(&cond->waiters, memory_order_seq_cst))
+        plasma_cond_wake(cond, true);
+}
+#endif
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+
+/* NOTES and REFERENCES
+ *
+ * Ulrich Drepper, "Futexes Are Tricky" (condvar with FUTEX_REQUEUE)
+ * http://www.akkadia.org/drepper/futex.pdf
+ * http://man7.org/linux/man-pages/man2/futex.2.html (FUTEX_CMP_REQUEUE)
+ */
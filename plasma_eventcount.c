@@ -0,0 +1,86 @@
+/*
+ * plasma_eventcount - eventcount for blocking on lock-free conditions
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define PLASMA_FEATURE_DISABLE_WIN32_FULLHDRS
+#define PLASMA_EVENTCOUNT_C99INLINE_FUNCS
+
+/* inlined functions defined in header
+ * (generate external linkage definition in GCC versions earlier than GCC 4.3)*/
+#if defined(NO_C99INLINE) \
+ || defined(__clang__) || (defined(__GNUC__) && !defined(__GNUC_STDC_INLINE__))
+#define PLASMA_EVENTCOUNT_C99INLINE
+#endif
+
+#include "plasma_eventcount.h"
+
+void
+plasma_eventcount_notify_waiters (plasma_eventcount_t * const restrict ec,
+                                  const bool all)
+{
+    /* advance epoch (invalidating keys of registered waiters) and wake */
+    plasma_atomic_fetch_add_u32(&ec->epoch, 1, memory_order_release);
+    if (all)
+        plasma_futex_wake_all(&ec->epoch);
+    else
+        plasma_futex_wake_one(&ec->epoch);
+}
+
+void
+plasma_eventcount_commit_wait (plasma_eventcount_t * const restrict ec,
+                               const uint32_t key)
+{
+    /* (loop on spurious wakeup; return once epoch advances past key) */
+    while (plasma_atomic_load_explicit(&ec->epoch, memory_order_acquire)
+           == key)
+        plasma_futex_wait(&ec->epoch, key, PLASMA_FUTEX_INFINITE);
+    plasma_atomic_fetch_sub_u32(&ec->waiters, 1, memory_order_relaxed);
+}
+
+
+/* inlined functions defined in header
+ * (generate external linkage definition in C99-compliant compilers)
+ * (need to -duplicate- definition from header for non-C99-compliant compilers)
+ */
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__)
+extern inline
+uint32_t
+plasma_eventcount_prepare_wait (plasma_eventcount_t * const restrict ec);
+uint32_t
+plasma_eventcount_prepare_wait (plasma_eventcount_t * const restrict ec);
+
+extern inline
+void
+plasma_eventcount_cancel_wait (plasma_eventcount_t * const restrict ec);
+void
+plasma_eventcount_cancel_wait (plasma_eventcount_t * const restrict ec);
+
+extern inline
+void
+plasma_eventcount_notify (plasma_eventcount_t * const restrict ec);
+void
+plasma_eventcount_notify (plasma_eventcount_t * const restrict ec);
+
+extern inline
+void
+plasma_eventcount_notify_all (plasma_eventcount_t * const restrict ec);
+void
+plasma_eventcount_notify_all (plasma_eventcount_t * const restrict ec);
+#endif
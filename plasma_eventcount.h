@@ -0,0 +1,193 @@
+/*
+ * plasma_eventcount - eventcount for blocking on lock-free conditions
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_PLASMA_EVENTCOUNT_H
+#define INCLUDED_PLASMA_EVENTCOUNT_H
+
+#include "plasma_feature.h"
+#include "plasma_attr.h"
+#include "plasma_membar.h"
+#include "plasma_atomic.h"
+#include "plasma_futex.h"
+PLASMA_ATTR_Pragma_once
+
+#ifndef PLASMA_EVENTCOUNT_C99INLINE
+#define PLASMA_EVENTCOUNT_C99INLINE C99INLINE
+#endif
+#ifndef NO_C99INLINE
+#ifndef PLASMA_EVENTCOUNT_C99INLINE_FUNCS
+#define PLASMA_EVENTCOUNT_C99INLINE_FUNCS
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* plasma_eventcount_init()
+ * plasma_eventcount_prepare_wait()
+ * plasma_eventcount_cancel_wait()
+ * plasma_eventcount_commit_wait()
+ * plasma_eventcount_notify()
+ * plasma_eventcount_notify_all()
+ *
+ * Eventcount permits consumers to block on an arbitrary lock-free condition
+ * (e.g. lock-free queue not empty) without producers taking a lock.  Consumer
+ * registers as a waiter and obtains a key, re-checks the condition, and then
+ * either cancels (condition satisfied) or commits to waiting (parks until
+ * next notify).  Producer makes condition true and then calls notify, which
+ * is a single (seq_cst) load of waiters count when nobody is waiting, and
+ * which otherwise advances epoch and wakes waiters (plasma_futex on epoch).
+ *
+ * Typical usage:
+ *   consumer:
+ *     while (!(item = try_dequeue(q))) {
+ *         uint32_t key = plasma_eventcount_prepare_wait(&ec);
+ *         if ((item = try_dequeue(q))) {
+ *             plasma_eventcount_cancel_wait(&ec);
+ *             break;
+ *         }
+ *         plasma_eventcount_commit_wait(&ec, key);
+ *     }
+ *   producer:
+ *     enqueue(q, item);             (must be seq_cst; see NB below)
+ *     plasma_eventcount_notify(&ec);
+ *
+ * NB: the store (or atomic read-modify-write) which makes the condition true
+ * must be memory_order_seq_cst (e.g. the CAS or exchange publishing an item
+ * to a lock-free queue), so that it is ordered before the load of the waiters
+ * count in notify.  Otherwise, caller must issue
+ * atomic_thread_fence(memory_order_seq_cst) prior to notify.  (prepare_wait
+ * is a seq_cst read-modify-write on consumer side.)
+ *
+ * NB: plasma_eventcount_commit_wait() might return spuriously, and the
+ * condition might already have been consumed by another consumer; callers
+ * must always re-check condition (loop as in example above).
+ * (epoch is 32-bit; key would be stale only if 2^32 notifies occurred between
+ *  prepare_wait and commit_wait, in which case commit_wait parks until next
+ *  notify)
+ */
+
+typedef __attribute_aligned__(16)
+struct plasma_eventcount_t {
+    uint32_t epoch;   /* (futex word) */
+    uint32_t waiters;
+    uint32_t udata32; /* user data 4-bytes */
+    uint32_t pad;
+} plasma_eventcount_t;
+
+#if (defined(__STDC_VERSION__) && __STDC_VERSION__-0 >= 199901L) /* C99 */
+#define PLASMA_EVENTCOUNT_INITIALIZER \
+        { .epoch = 0, .waiters = 0, .udata32 = 0, .pad = 0 }
+#else
+#define PLASMA_EVENTCOUNT_INITIALIZER { 0, 0, 0, 0 }
+#endif
+#define plasma_eventcount_init(ec) \
+        ((ec)->epoch = 0, (ec)->waiters = 0, (ec)->udata32 = 0, (ec)->pad = 0)
+
+__attribute_nonnull__()
+void
+plasma_eventcount_notify_waiters (plasma_eventcount_t * const restrict ec,
+                                  const bool all);
+
+__attribute_nonnull__()
+void
+plasma_eventcount_commit_wait (plasma_eventcount_t * const restrict ec,
+                               const uint32_t key);
+
+__attribute_nonnull__()
+PLASMA_EVENTCOUNT_C99INLINE
+uint32_t
+plasma_eventcount_prepare_wait (plasma_eventcount_t * const restrict ec);
+#ifdef PLASMA_EVENTCOUNT_C99INLINE_FUNCS
+PLASMA_EVENTCOUNT_C99INLINE
+uint32_t
+plasma_eventcount_prepare_wait (plasma_eventcount_t * const restrict ec)
+{
+    /* register as waiter prior to reading epoch (and re-checking condition)*/
+    plasma_atomic_fetch_add_u32(&ec->waiters, 1, memory_order_seq_cst);
+    return plasma_atomic_load_explicit(&ec->epoch, memory_order_seq_cst);
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_EVENTCOUNT_C99INLINE
+void
+plasma_eventcount_cancel_wait (plasma_eventcount_t * const restrict ec);
+#ifdef PLASMA_EVENTCOUNT_C99INLINE_FUNCS
+PLASMA_EVENTCOUNT_C99INLINE
+void
+plasma_eventcount_cancel_wait (plasma_eventcount_t * const restrict ec)
+{
+    plasma_atomic_fetch_sub_u32(&ec->waiters, 1, memory_order_relaxed);
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_EVENTCOUNT_C99INLINE
+void
+plasma_eventcount_notify (plasma_eventcount_t * const restrict ec);
+#ifdef PLASMA_EVENTCOUNT_C99INLINE_FUNCS
+PLASMA_EVENTCOUNT_C99INLINE
+void
+plasma_eventcount_notify (plasma_eventcount_t * const restrict ec)
+{
+    /* (seq_cst load is plain load on x86; no fence on producer fast path) */
+    if (__builtin_expect(
+          (plasma_atomic_load_explicit(&ec->waiters, memory_order_seq_cst)
+           != 0), 0))
+        plasma_eventcount_notify_waiters(ec, false);
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_EVENTCOUNT_C99INLINE
+void
+plasma_eventcount_notify_all (plasma_eventcount_t * const restrict ec);
+#ifdef PLASMA_EVENTCOUNT_C99INLINE_FUNCS
+PLASMA_EVENTCOUNT_C99INLINE
+void
+plasma_eventcount_notify_all (plasma_eventcount_t * const restrict ec)
+{
+    if (__builtin_expect(
+          (plasma_atomic_load_explicit(&ec->waiters, memory_order_seq_cst)
+           != 0), 0))
+        plasma_eventcount_notify_waiters(ec, true);
+}
+#endif
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+
+/* NOTES and REFERENCES
+ *
+ * D. P. Reed and R. K. Kanodia, "Synchronization with Eventcounts and
+ *   Sequencers", CACM 22(2), 1979
+ * Dmitry Vyukov, "eventcount" (1024cores.net, comp.programming.threads)
+ * http://www.1024cores.net/home/lock-free-algorithms/eventcounts
+ * folly EventCount (folly/experimental/EventCount.h)
+ */
@@ -0,0 +1,361 @@
+/*
+ * plasma_futex - portable wait-on-address (park/unpark on 32-bit word)
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* _GNU_SOURCE for syscall() (Linux futex) */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#define PLASMA_FEATURE_DISABLE_WIN32_FULLHDRS
+
+#include "plasma_futex.h"
+#include "plasma_atomic.h"
+#include "plasma_membar.h"
+#include "plasma_spin.h"     /* plasma_spin_yield() */
+
+/* select implementation (see plasma_futex.h) */
+#if defined(PLASMA_FUTEX_CONDVAR)
+#elif defined(__linux__)
+#define PLASMA_FUTEX_LINUX
+#elif defined(__APPLE__) && defined(__MACH__)
+#define PLASMA_FUTEX_ULOCK
+#elif defined(_WIN32)
+#define PLASMA_FUTEX_WIN32
+#elif defined(PLASMA_FEATURE_POSIX)
+#define PLASMA_FUTEX_CONDVAR
+#endif
+
+
+#if defined(PLASMA_FUTEX_LINUX)
+
+#include <errno.h>
+#include <time.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static bool
+plasma_futex_wait_impl (uint32_t * const addr, const uint32_t val,
+                        const uint64_t timeout_ns, const bool shared)
+{
+    /* FUTEX_WAIT timeout is relative (CLOCK_MONOTONIC) */
+    struct timespec ts;
+    struct timespec *tsp = NULL;
+    if (timeout_ns / 1000000000u <= INT32_MAX) { /*(else treat as infinite)*/
+        ts.tv_sec  = (time_t)(timeout_ns / 1000000000u);
+        ts.tv_nsec = (long)(timeout_ns % 1000000000u);
+        tsp = &ts;
+    }
+    return 0 == syscall(SYS_futex, addr,
+                        shared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE,
+                        val, tsp, NULL, 0)
+        || errno != ETIMEDOUT;
+}
+
+static void
+plasma_futex_wake_impl (uint32_t * const addr, const uint32_t n,
+                        const bool shared)
+{
+    (void)syscall(SYS_futex, addr, shared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE,
+                  n < INT32_MAX ? (int)n : INT32_MAX, NULL, NULL, 0);
+}
+
+#define PLASMA_FUTEX_REQUEUE
+
+static bool
+plasma_futex_requeue_impl (uint32_t * const addr, const uint32_t val,
+                           const uint32_t n, uint32_t * const addr2)
+{
+    /* (val2 (max num to requeue) passed in timeout parameter slot) */
+    return 0 <= syscall(SYS_futex, addr, FUTEX_CMP_REQUEUE_PRIVATE,
+                        n < INT32_MAX ? (int)n : INT32_MAX,
+                        (unsigned long)INT32_MAX, addr2, val);
+}
+
+#elif defined(PLASMA_FUTEX_ULOCK)
+
+#include <errno.h>
+
+/* (private interfaces; see xnu bsd/sys/ulock.h) */
+extern int
+__ulock_wait (uint32_t operation, void *addr, uint64_t value,
+              uint32_t timeout_us);
+extern int
+__ulock_wake (uint32_t operation, void *addr, uint64_t wake_value);
+
+#define UL_COMPARE_AND_WAIT          1
+#define UL_COMPARE_AND_WAIT_SHARED   3
+#define ULF_WAKE_ALL        0x00000100
+#define ULF_NO_ERRNO        0x01000000
+
+static bool
+plasma_futex_wait_impl (uint32_t * const addr, const uint32_t val,
+                        const uint64_t timeout_ns, const bool shared)
+{
+    /* __ulock_wait() timeout is microseconds; 0 is infinite
+     * (long timeouts are clamped and reported as spurious wakeup) */
+    const uint64_t us = timeout_ns / 1000u + (timeout_ns % 1000u != 0);
+    const bool clamped = (us > UINT32_MAX);
+    const int rc =
+      __ulock_wait((shared ? UL_COMPARE_AND_WAIT_SHARED : UL_COMPARE_AND_WAIT)
+                   | ULF_NO_ERRNO, addr, val,
+                   timeout_ns == PLASMA_FUTEX_INFINITE
+                     ? 0
+                     : clamped ? UINT32_MAX : (us ? (uint32_t)us : 1));
+    return rc != -ETIMEDOUT || clamped;
+}
+
+static void
+plasma_futex_wake_impl (uint32_t * const addr, uint32_t n,
+                        const bool shared)
+{
+    const uint32_t op =
+      (shared ? UL_COMPARE_AND_WAIT_SHARED : UL_COMPARE_AND_WAIT)|ULF_NO_ERRNO;
+    if (n == UINT32_MAX)
+        (void)__ulock_wake(op | ULF_WAKE_ALL, addr, 0);
+    else {  /*(-ENOENT if no waiters)*/
+        while (n-- && __ulock_wake(op, addr, 0) != -ENOENT) ;
+    }
+}
+
+#elif defined(PLASMA_FUTEX_WIN32)
+
+/* WaitOnAddress() requires _WIN32_WINNT >= 0x0602 (Windows 8) */
+#include <windows.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "Synchronization.lib")
+#endif
+
+static bool
+plasma_futex_wait_impl (uint32_t * const addr, uint32_t val,
+                        const uint64_t timeout_ns, const bool shared)
+{
+    /* WaitOnAddress() timeout is milliseconds
+     * (long timeouts are clamped and reported as spurious wakeup) */
+    const uint64_t ms = timeout_ns / 1000000u + (timeout_ns % 1000000u != 0);
+    const bool clamped = (ms >= INFINITE);
+    if (shared) {  /*(WaitOnAddress() is process-private)*/
+        plasma_spin_yield();
+        return true;
+    }
+    return WaitOnAddress(addr, &val, sizeof(val),
+                         timeout_ns == PLASMA_FUTEX_INFINITE
+                           ? INFINITE
+                           : clamped ? INFINITE-1 : (DWORD)ms)
+        || GetLastError() != ERROR_TIMEOUT
+        || clamped;
+}
+
+static void
+plasma_futex_wake_impl (uint32_t * const addr, uint32_t n,
+                        const bool shared)
+{
+    if (shared)
+        return;
+    if (n == UINT32_MAX)
+        WakeByAddressAll(addr);
+    else {
+        while (n--)
+            WakeByAddressSingle(addr);
+    }
+}
+
+#elif defined(PLASMA_FUTEX_CONDVAR)
+
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+/* hashed table of mutex and condition variable
+ * Waiter increments bucket waiters count under bucket mutex, and then checks
+ * *addr prior to waiting on bucket condition variable.  Waker modifies *addr
+ * prior to wake, and then checks bucket waiters count, skipping mutex and
+ * condition variable when there are no waiters.  (seq_cst fences on both
+ * sides: waiter sees modified *addr, or waker sees waiters != 0)
+ * Multiple addresses might hash to same bucket, so wake is always broadcast.
+ * (table is process-private; *_shared() yields CPU) */
+
+#define PLASMA_FUTEX_BUCKETS 64  /* (power of 2; see initializer below) */
+#if (PLASMA_FUTEX_BUCKETS & (PLASMA_FUTEX_BUCKETS-1)) \
+ || PLASMA_FUTEX_BUCKETS > 65536
+#error "PLASMA_FUTEX_BUCKETS must be power of 2 no larger than 65536"
+#endif
+
+typedef struct __attribute_aligned__(64) plasma_futex_bucket_t {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    uint32_t waiters;
+} plasma_futex_bucket_t;
+
+#define PLASMA_FUTEX_BUCKET_INITIALIZER \
+  { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0 }
+#define PLASMA_FUTEX_BUCKET_INITIALIZER_8 \
+  PLASMA_FUTEX_BUCKET_INITIALIZER, PLASMA_FUTEX_BUCKET_INITIALIZER, \
+  PLASMA_FUTEX_BUCKET_INITIALIZER, PLASMA_FUTEX_BUCKET_INITIALIZER, \
+  PLASMA_FUTEX_BUCKET_INITIALIZER, PLASMA_FUTEX_BUCKET_INITIALIZER, \
+  PLASMA_FUTEX_BUCKET_INITIALIZER, PLASMA_FUTEX_BUCKET_INITIALIZER
+
+static plasma_futex_bucket_t plasma_futex_buckets[PLASMA_FUTEX_BUCKETS] = {
+  PLASMA_FUTEX_BUCKET_INITIALIZER_8, PLASMA_FUTEX_BUCKET_INITIALIZER_8,
+  PLASMA_FUTEX_BUCKET_INITIALIZER_8, PLASMA_FUTEX_BUCKET_INITIALIZER_8,
+  PLASMA_FUTEX_BUCKET_INITIALIZER_8, PLASMA_FUTEX_BUCKET_INITIALIZER_8,
+  PLASMA_FUTEX_BUCKET_INITIALIZER_8, PLASMA_FUTEX_BUCKET_INITIALIZER_8
+};
+
+/* (multiplicative hash; high 16 bits of product masked to table size) */
+#define plasma_futex_bucket(addr) \
+  (plasma_futex_buckets                                                \
+   + ((((uint32_t)((uintptr_t)(addr) >> 2) * 2654435761u) >> 16)       \
+      & (PLASMA_FUTEX_BUCKETS-1)))
+
+static bool
+plasma_futex_wait_impl (uint32_t * const addr, const uint32_t val,
+                        const uint64_t timeout_ns, const bool shared)
+{
+    plasma_futex_bucket_t * const b = plasma_futex_bucket(addr);
+    struct timespec ts;
+    const bool infinite = (timeout_ns / 1000000000u > INT32_MAX);
+    bool rc = true;
+    if (shared) {
+        plasma_spin_yield();
+        return true;
+    }
+    /* (pthread_cond_timedwait() deadline is absolute CLOCK_REALTIME) */
+    if (!infinite) {
+        if (0 != clock_gettime(CLOCK_REALTIME, &ts))
+            ts.tv_sec = ts.tv_nsec = 0;
+        ts.tv_sec  += (time_t)(timeout_ns / 1000000000u);
+        ts.tv_nsec += (long)(timeout_ns % 1000000000u);
+        if (ts.tv_nsec >= 1000000000L) {
+            ts.tv_nsec -= 1000000000L;
+            ++ts.tv_sec;
+        }
+    }
+    pthread_mutex_lock(&b->mutex);
+    plasma_atomic_store_explicit(&b->waiters, b->waiters+1,
+                                 memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    if (plasma_atomic_load_explicit(addr, memory_order_relaxed) == val) {
+        if (infinite)
+            pthread_cond_wait(&b->cond, &b->mutex);
+        else
+            rc = (ETIMEDOUT != pthread_cond_timedwait(&b->cond,&b->mutex,&ts));
+    }
+    plasma_atomic_store_explicit(&b->waiters, b->waiters-1,
+                                 memory_order_relaxed);
+    pthread_mutex_unlock(&b->mutex);
+    return rc;
+}
+
+static void
+plasma_futex_wake_impl (uint32_t * const addr, const uint32_t n,
+                        const bool shared)
+{
+    plasma_futex_bucket_t * const b = plasma_futex_bucket(addr);
+    (void)n;
+    if (shared)
+        return;
+    atomic_thread_fence(memory_order_seq_cst);
+    if (0 == plasma_atomic_load_explicit(&b->waiters, memory_order_relaxed))
+        return;
+    pthread_mutex_lock(&b->mutex);
+    pthread_cond_broadcast(&b->cond);
+    pthread_mutex_unlock(&b->mutex);
+}
+
+#else  /* no wait-on-address; yield CPU (spurious wakeup) */
+
+static bool
+plasma_futex_wait_impl (uint32_t * const addr, const uint32_t val,
+                        const uint64_t timeout_ns, const bool shared)
+{
+    (void)addr; (void)val; (void)timeout_ns; (void)shared;
+    plasma_spin_yield();
+    return true;
+}
+
+static void
+plasma_futex_wake_impl (uint32_t * const addr, const uint32_t n,
+                        const bool shared)
+{
+    (void)addr; (void)n; (void)shared;
+}
+
+#endif
+
+
+bool
+plasma_futex_wait (uint32_t * const addr, const uint32_t val,
+                   const uint64_t timeout_ns)
+{
+    return plasma_futex_wait_impl(addr, val, timeout_ns, false);
+}
+
+void
+plasma_futex_wake_one (uint32_t * const addr)
+{
+    plasma_futex_wake_impl(addr, 1, false);
+}
+
+void
+plasma_futex_wake_all (uint32_t * const addr)
+{
+    plasma_futex_wake_impl(addr, UINT32_MAX, false);
+}
+
+void
+plasma_futex_wake_n (uint32_t * const addr, const uint32_t n)
+{
+    if (n)
+        plasma_futex_wake_impl(addr, n, false);
+}
+
+void
+plasma_futex_requeue (uint32_t * const addr, const uint32_t val,
+                      const uint32_t n, uint32_t * const addr2)
+{
+  #ifdef PLASMA_FUTEX_REQUEUE
+    if (plasma_futex_requeue_impl(addr, val, n, addr2))
+        return;  /*(else EAGAIN if *addr != val)*/
+  #else
+    (void)val; (void)n; (void)addr2;
+  #endif
+    plasma_futex_wake_impl(addr, UINT32_MAX, false);
+}
+
+bool
+plasma_futex_wait_shared (uint32_t * const addr, const uint32_t val,
+                          const uint64_t timeout_ns)
+{
+    return plasma_futex_wait_impl(addr, val, timeout_ns, true);
+}
+
+void
+plasma_futex_wake_one_shared (uint32_t * const addr)
+{
+    plasma_futex_wake_impl(addr, 1, true);
+}
+
+void
+plasma_futex_wake_all_shared (uint32_t * const addr)
+{
+    plasma_futex_wake_impl(addr, UINT32_MAX, true);
+}
@@ -0,0 +1,158 @@
+/*
+ * plasma_futex - portable wait-on-address (park/unpark on 32-bit word)
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_PLASMA_FUTEX_H
+#define INCLUDED_PLASMA_FUTEX_H
+
+#include "plasma_feature.h"
+#include "plasma_attr.h"
+#include "plasma_stdtypes.h"
+PLASMA_ATTR_Pragma_once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* plasma_futex_wait()
+ * plasma_futex_wake_one()
+ * plasma_futex_wake_all()
+ * plasma_futex_wake_n()
+ * plasma_futex_requeue()
+ * plasma_futex_wait_shared()
+ * plasma_futex_wake_one_shared()
+ * plasma_futex_wake_all_shared()
+ *
+ * Park calling thread while 32-bit word at addr contains val, until woken by
+ * plasma_futex_wake_*() on same addr, or until timeout_ns nanoseconds elapse
+ * (relative timeout; PLASMA_FUTEX_INFINITE to wait without timeout).
+ * Comparison of *addr with val and parking are atomic with respect to wake,
+ * so a waker which modifies *addr and then calls plasma_futex_wake_*() does
+ * not lose a wakeup.  plasma_futex_wake_n() wakes up to n waiters (single
+ * system call on Linux; repeated wake of one waiter on other platforms).
+ * plasma_futex_requeue() wakes up to n waiters on addr, and moves remaining
+ * waiters to wait on addr2 (without waking them) if *addr still equals val
+ * (Linux FUTEX_CMP_REQUEUE; other platforms wake all waiters on addr instead,
+ * as they do if *addr != val).  Requeued waiters return from
+ * plasma_futex_wait() when woken on addr2, and must re-check accordingly.
+ * plasma_futex_wait() returns false on timeout, and true otherwise (woken,
+ * *addr != val, interrupted, or spurious wakeup).  Callers must always
+ * re-check the condition for which they waited, and should loop (with a
+ * deadline) if timeout is required to be exact, since timeouts might be
+ * rounded or clamped by the underlying platform interface.
+ *
+ * Private (default) interfaces are for addresses used only within a single
+ * process, and are faster on Linux.  *_shared() interfaces are for addresses
+ * in memory shared between processes (e.g. mmap MAP_SHARED); on platforms
+ * without a process-shared wait-on-address, *_shared() wait yields CPU and
+ * returns (spurious wakeup), and *_shared() wake is a no-op.
+ *
+ * Implementation:
+ *   Linux    futex() FUTEX_WAIT and FUTEX_WAKE (FUTEX_PRIVATE_FLAG if private)
+ *   Mac OSX  __ulock_wait() and __ulock_wake() (Darwin 16 (macOS 10.12)+)
+ *   Windows  WaitOnAddress() and WakeByAddress*() (Windows 8+)
+ *            (link with Synchronization.lib)
+ *   other    hashed table of pthread mutex and condition variable
+ *            (define PLASMA_FUTEX_CONDVAR to select on any POSIX platform)
+ *
+ * Memory ordering: plasma_futex_wait() and plasma_futex_wake_*() are not
+ * guaranteed to be memory barriers.  Modify *addr with an atomic operation
+ * (release or stronger) prior to plasma_futex_wake_*(), and re-check *addr
+ * with an atomic load (acquire) after plasma_futex_wait() returns.
+ *
+ * Users within plasma: plasma_spin_futexlock, plasma_spin_mcslock and
+ * plasma_spin_clhlock park contended waiters, as do plasma_cond,
+ * plasma_eventcount, plasma_once, plasma_sem, plasma_latch and
+ * plasma_parkinglot (plasma_parklock).
+ * plasma_spin_lock, plasma_spin_tktlock, plasma_spin_taglock (and their
+ * variants), plasma_spin_clhtolock and plasma_spin_rwlock remain pure spin
+ * locks (spin, then yield):  plasma_spin_lock might be Apple OSSpinLock, and
+ * its lock word has no spare state to mark parked waiters; ticket locks hand
+ * off to one specific waiter among all waiters on a shared word, which would
+ * require waking all parked waiters on each release; and plasma_spin_clhtolock
+ * waiters spin on a pointer-sized predecessor link (which is also how aborted
+ * nodes are skipped), while plasma_futex waits on 32-bit words.  Use
+ * plasma_spin_futexlock, plasma_spin_mcslock, plasma_spin_clhlock or
+ * plasma_parklock where waiters should park.
+ */
+
+#define PLASMA_FUTEX_INFINITE UINT64_MAX
+
+__attribute_nonnull__()
+bool
+plasma_futex_wait (uint32_t * const addr, const uint32_t val,
+                   const uint64_t timeout_ns);
+
+__attribute_nonnull__()
+void
+plasma_futex_wake_one (uint32_t * const addr);
+
+__attribute_nonnull__()
+void
+plasma_futex_wake_all (uint32_t * const addr);
+
+__attribute_nonnull__()
+void
+plasma_futex_wake_n (uint32_t * const addr, const uint32_t n);
+
+__attribute_nonnull__()
+void
+plasma_futex_requeue (uint32_t * const addr, const uint32_t val,
+                      const uint32_t n, uint32_t * const addr2);
+
+__attribute_nonnull__()
+bool
+plasma_futex_wait_shared (uint32_t * const addr, const uint32_t val,
+                          const uint64_t timeout_ns);
+
+__attribute_nonnull__()
+void
+plasma_futex_wake_one_shared (uint32_t * const addr);
+
+__attribute_nonnull__()
+void
+plasma_futex_wake_all_shared (uint32_t * const addr);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+
+/*
+ * References
+ *
+ * Ulrich Drepper, "Futexes Are Tricky"
+ * http://www.akkadia.org/drepper/futex.pdf
+ * http://man7.org/linux/man-pages/man2/futex.2.html
+ *
+ * Darwin ulock (xnu bsd/sys/ulock.h)
+ * https://github.com/apple-oss-distributions/xnu/blob/main/bsd/sys/ulock.h
+ *
+ * WaitOnAddress
+ * https://learn.microsoft.com/en-us/windows/win32/api/synchapi/nf-synchapi-waitonaddress
+ *
+ * hashed wait queues (condvar fallback)
+ * WebKit "Locking in WebKit" (ParkingLot), 2016
+ * https://webkit.org/blog/6161/locking-in-webkit/
+ */
@@ -0,0 +1,151 @@
+/*
+ * plasma_lockstripe - striped lock table with cache-line-padded locks
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define PLASMA_FEATURE_DISABLE_WIN32_FULLHDRS
+#define PLASMA_LOCKSTRIPE_C99INLINE_FUNCS
+
+/* inlined functions defined in header
+ * (generate external linkage definition in GCC versions earlier than GCC 4.3)*/
+#if defined(NO_C99INLINE) \
+ || defined(__clang__) || (defined(__GNUC__) && !defined(__GNUC_STDC_INLINE__))
+#define PLASMA_LOCKSTRIPE_C99INLINE
+#endif
+
+#include "plasma_lockstripe.h"
+#include "plasma_sysconf.h"
+
+#include <stdlib.h>  /* posix_memalign() aligned_alloc() malloc() free() */
+#ifdef _WIN32
+#include <malloc.h>  /* _aligned_malloc() _aligned_free() */
+#endif
+#include <string.h>  /* memset() */
+
+static uint32_t
+plasma_lockstripe_pow2 (uint32_t n)
+{
+    /* round up to power of 2, clamped to [1, PLASMA_LOCKSTRIPE_MAX] */
+    uint32_t p = 1;
+    while (p < n && p < PLASMA_LOCKSTRIPE_MAX)
+        p <<= 1;
+    return p;
+}
+
+uint32_t
+plasma_lockstripe_nstripes (uint32_t per_cpu)
+{
+    long nprocs_onln = plasma_sysconf_nprocessors_onln();
+    if (nprocs_onln < 1)
+        nprocs_onln = 1;
+    if (nprocs_onln > PLASMA_LOCKSTRIPE_MAX)
+        nprocs_onln = PLASMA_LOCKSTRIPE_MAX;
+    if (per_cpu == 0)
+        per_cpu = PLASMA_LOCKSTRIPE_PER_CPU;
+    if (per_cpu > PLASMA_LOCKSTRIPE_MAX)
+        per_cpu = PLASMA_LOCKSTRIPE_MAX;
+    return plasma_lockstripe_pow2((uint32_t)nprocs_onln * per_cpu);
+}
+
+bool
+plasma_lockstripe_init (plasma_lockstripe_t * const restrict ls,
+                        uint32_t nstripes, const size_t locksz)
+{
+    const size_t stride = (locksz + PLASMA_LOCKSTRIPE_ALIGN - 1)
+                        & ~(size_t)(PLASMA_LOCKSTRIPE_ALIGN - 1);
+    void *stripes;
+    uint32_t shift = 64;
+    nstripes = (nstripes == 0)
+      ? plasma_lockstripe_nstripes(0)
+      : plasma_lockstripe_pow2(nstripes);
+  #ifdef PLASMA_FEATURE_POSIX
+    if (0 != posix_memalign(&stripes, PLASMA_LOCKSTRIPE_ALIGN,
+                            (size_t)nstripes * stride))
+        return false;
+  #elif defined(_WIN32)
+    stripes = _aligned_malloc((size_t)nstripes * stride,
+                              PLASMA_LOCKSTRIPE_ALIGN);
+    if (stripes == NULL)
+        return false;
+  #elif defined(__STDC_VERSION__) && __STDC_VERSION__-0 >= 201112L /* C11 */
+    /*(size is multiple of alignment, as required by aligned_alloc())*/
+    stripes = aligned_alloc(PLASMA_LOCKSTRIPE_ALIGN, (size_t)nstripes * stride);
+    if (stripes == NULL)
+        return false;
+  #else
+    stripes = malloc((size_t)nstripes * stride);  /*(alignment not assured)*/
+    if (stripes == NULL)
+        return false;
+  #endif
+    memset(stripes, 0, (size_t)nstripes * stride);
+    ls->stripes = (char *)stripes;
+    ls->mask    = nstripes - 1;
+    ls->stride  = (uint32_t)stride;
+    while ((1u << (64 - shift)) < nstripes)
+        --shift;
+    ls->shift   = (shift < 64) ? shift : 63;
+    return true;
+}
+
+void
+plasma_lockstripe_destroy (plasma_lockstripe_t * const restrict ls)
+{
+  #if !defined(PLASMA_FEATURE_POSIX) && defined(_WIN32)
+    _aligned_free(ls->stripes);
+  #else
+    free(ls->stripes);
+  #endif
+    ls->stripes = NULL;
+    ls->mask    = 0;
+    ls->stride  = 0;
+    ls->shift   = 63;
+}
+
+uint32_t
+plasma_lockstripe_order (uint32_t * const restrict idx, const uint32_t n)
+{
+    /* insertion sort (n expected to be small), then remove duplicates */
+    uint32_t i, j, v;
+    for (i = 1; i < n; ++i) {
+        v = idx[i];
+        for (j = i; j && idx[j-1] > v; --j)
+            idx[j] = idx[j-1];
+        idx[j] = v;
+    }
+    for (i = 0, j = 0; i < n; ++i) {
+        if (j == 0 || idx[j-1] != idx[i])
+            idx[j++] = idx[i];
+    }
+    return j;
+}
+
+
+/* inlined functions defined in header
+ * (generate external linkage definition in C99-compliant compilers)
+ * (need to -duplicate- definition from header for non-C99-compliant compilers)
+ */
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__)
+extern inline
+uint32_t
+plasma_lockstripe_index (const plasma_lockstripe_t * const restrict ls,
+                         const uint64_t hash);
+uint32_t
+plasma_lockstripe_index (const plasma_lockstripe_t * const restrict ls,
+                         const uint64_t hash);
+#endif
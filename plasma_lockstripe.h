@@ -0,0 +1,196 @@
+/*
+ * plasma_lockstripe - striped lock table with cache-line-padded locks
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_PLASMA_LOCKSTRIPE_H
+#define INCLUDED_PLASMA_LOCKSTRIPE_H
+
+#include "plasma_feature.h"
+#include "plasma_attr.h"
+#include "plasma_stdtypes.h"
+PLASMA_ATTR_Pragma_once
+
+#ifndef PLASMA_LOCKSTRIPE_C99INLINE
+#define PLASMA_LOCKSTRIPE_C99INLINE C99INLINE
+#endif
+#ifndef NO_C99INLINE
+#ifndef PLASMA_LOCKSTRIPE_C99INLINE_FUNCS
+#define PLASMA_LOCKSTRIPE_C99INLINE_FUNCS
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* plasma_lockstripe_init()
+ * plasma_lockstripe_destroy()
+ * plasma_lockstripe_nstripes()
+ * plasma_lockstripe_index()
+ * plasma_lockstripe_index_ptr()
+ * plasma_lockstripe_lock_at()
+ * plasma_lockstripe_order()
+ *
+ * Striped lock table: power-of-two number of locks (stripes), each padded to
+ * (a multiple of) PLASMA_LOCKSTRIPE_ALIGN bytes so that locks on different
+ * stripes do not share a cache line (no false sharing), e.g. for sharded maps
+ * protected by one lock per shard.  PLASMA_LOCKSTRIPE_ALIGN is 128 on POWER
+ * and on Apple arm64 (128-byte cache lines), and 64 elsewhere.  Address or
+ * hash selects the stripe from the top log2(nstripes) bits of a Fibonacci
+ * (multiplicative) hash, so low-quality hashes and aligned addresses spread
+ * well.
+ *
+ * Table is type-erased; plasma_lockstripe_init() takes sizeof(locktype), and
+ * PLASMA_LOCKSTRIPE_LOCKFNS() defines type-safe accessors for a lock type, e.g.
+ *   PLASMA_LOCKSTRIPE_LOCKFNS(tktstripe, plasma_spin_tktlock_t,
+ *                             plasma_spin_tktlock_acquire,
+ *                             plasma_spin_tktlock_release)
+ * defines static functions
+ *   plasma_spin_tktlock_t * tktstripe_lock_for(ls, ptr)
+ *   plasma_spin_tktlock_t * tktstripe_lock_for_hash(ls, hash)
+ *   uint32_t tktstripe_acquire_n(ls, idx, n)
+ *   void tktstripe_release_n(ls, idx, n)
+ * tktstripe_acquire_n() acquires the stripes in idx[] (from
+ * plasma_lockstripe_index*()) in ascending stripe order to avoid deadlock
+ * between threads locking multiple stripes; idx[] is sorted in place and
+ * duplicates removed (plasma_lockstripe_order()).  Pass idx and the returned
+ * count to tktstripe_release_n().
+ *
+ * plasma_lockstripe_nstripes(per_cpu) returns a suggested number of stripes:
+ * plasma_sysconf_nprocessors_onln() * per_cpu (PLASMA_LOCKSTRIPE_PER_CPU if 0)
+ * rounded up to a power of two, at most PLASMA_LOCKSTRIPE_MAX.
+ * plasma_lockstripe_init() rounds nstripes up to a power of two (0 selects
+ * plasma_lockstripe_nstripes(0)), allocates table, and zero-fills it; returns
+ * false if allocation fails.  Lock type must be initialized by all-zero bytes
+ * (e.g. plasma_spin_lock_t, plasma_spin_tktlock_t, plasma_spin_futexlock_t,
+ * plasma_spin_rwlock_t; not plasma_spin_brlock_t or plasma_spin_clhlock_t).
+ * (plasma_spin_rwlock_t stripes are PLASMA_SPIN_RWLOCK_WRPREF only; zero-fill
+ *  can not select PLASMA_SPIN_RWLOCK_PHASEFAIR)
+ */
+
+#ifndef PLASMA_LOCKSTRIPE_ALIGN
+#if defined(__ppc__)   || defined(_ARCH_PPC)  || \
+    defined(_ARCH_PWR) || defined(_ARCH_PWR2) || defined(_POWER) || \
+    (defined(__APPLE__) && (defined(__aarch64__) || defined(__arm64__)))
+#define PLASMA_LOCKSTRIPE_ALIGN 128
+#else
+#define PLASMA_LOCKSTRIPE_ALIGN 64
+#endif
+#endif
+#ifndef PLASMA_LOCKSTRIPE_PER_CPU
+#define PLASMA_LOCKSTRIPE_PER_CPU 4
+#endif
+#ifndef PLASMA_LOCKSTRIPE_MAX
+#define PLASMA_LOCKSTRIPE_MAX 65536  /* (power of 2) */
+#endif
+
+typedef struct plasma_lockstripe_t {
+    char *stripes;
+    uint32_t mask;    /* nstripes - 1 */
+    uint32_t stride;  /* bytes per stripe (padded lock) */
+    uint32_t shift;   /* 64 - log2(nstripes) (63 if nstripes == 1) */
+} plasma_lockstripe_t;
+
+__attribute_nonnull__()
+bool
+plasma_lockstripe_init (plasma_lockstripe_t * const restrict ls,
+                        uint32_t nstripes, const size_t locksz);
+
+__attribute_nonnull__()
+void
+plasma_lockstripe_destroy (plasma_lockstripe_t * const restrict ls);
+
+uint32_t
+plasma_lockstripe_nstripes (uint32_t per_cpu);
+
+__attribute_nonnull__()
+uint32_t
+plasma_lockstripe_order (uint32_t * const restrict idx, const uint32_t n);
+
+#define plasma_lockstripe_count(ls) ((ls)->mask + 1)
+
+#define plasma_lockstripe_lock_at(ls, i) \
+        ((void *)((ls)->stripes + (size_t)(i) * (ls)->stride))
+
+#define plasma_lockstripe_index_ptr(ls, ptr) \
+        plasma_lockstripe_index((ls), (uint64_t)(uintptr_t)(ptr))
+
+__attribute_nonnull__()
+PLASMA_LOCKSTRIPE_C99INLINE
+uint32_t
+plasma_lockstripe_index (const plasma_lockstripe_t * const restrict ls,
+                         const uint64_t hash);
+#ifdef PLASMA_LOCKSTRIPE_C99INLINE_FUNCS
+PLASMA_LOCKSTRIPE_C99INLINE
+uint32_t
+plasma_lockstripe_index (const plasma_lockstripe_t * const restrict ls,
+                         const uint64_t hash)
+{
+    /* (Fibonacci hashing; take top bits of product, which are best mixed)
+     * (mask is needed only if nstripes == 1, since shift by 64 is undefined)*/
+    return (uint32_t)((hash * UINT64_C(0x9E3779B97F4A7C15)) >> ls->shift)
+         & ls->mask;
+}
+#endif
+
+#define PLASMA_LOCKSTRIPE_LOCKFNS(name, locktype, acquire, release)          \
+        __attribute_unused__                                                   \
+        static locktype *                                                      \
+        name##_lock_for_hash (const plasma_lockstripe_t * const ls,            \
+                              const uint64_t hash)                             \
+        { return (locktype *)                                                  \
+            plasma_lockstripe_lock_at(ls, plasma_lockstripe_index(ls, hash)); }\
+        __attribute_unused__                                                   \
+        static locktype *                                                      \
+        name##_lock_for (const plasma_lockstripe_t * const ls,                 \
+                         const void * const ptr)                               \
+        { return name##_lock_for_hash(ls, (uint64_t)(uintptr_t)ptr); }         \
+        __attribute_unused__                                                   \
+        static uint32_t                                                        \
+        name##_acquire_n (const plasma_lockstripe_t * const ls,                \
+                          uint32_t * const idx, uint32_t n)                    \
+        { uint32_t i;                                                          \
+          n = plasma_lockstripe_order(idx, n);                                 \
+          for (i = 0; i < n; ++i)                                              \
+              (void)acquire((locktype *)plasma_lockstripe_lock_at(ls,idx[i])); \
+          return n; }                                                          \
+        __attribute_unused__                                                   \
+        static void                                                            \
+        name##_release_n (const plasma_lockstripe_t * const ls,                \
+                          const uint32_t * const idx, uint32_t n)              \
+        { while (n)                                                            \
+              release((locktype *)plasma_lockstripe_lock_at(ls, idx[--n])); }
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+
+/* NOTES and REFERENCES
+ *
+ * Lock striping (e.g. Java ConcurrentHashMap segments)
+ * Maurice Herlihy and Nir Shavit, "The Art of Multiprocessor Programming",
+ *   section 13.2.2 (StripedHashSet); lock ordering to avoid deadlock
+ * Fibonacci hashing (Knuth, TAOCP vol 3, 6.4 multiplicative hashing)
+ */
@@ -0,0 +1,71 @@
+/*
+ * plasma_once - once-only initialization
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define PLASMA_FEATURE_DISABLE_WIN32_FULLHDRS
+#define PLASMA_ONCE_C99INLINE_FUNCS
+
+/* inlined functions defined in header
+ * (generate external linkage definition in GCC versions earlier than GCC 4.3)*/
+#if defined(NO_C99INLINE) \
+ || defined(__clang__) || (defined(__GNUC__) && !defined(__GNUC_STDC_INLINE__))
+#define PLASMA_ONCE_C99INLINE
+#endif
+
+#include "plasma_once.h"
+#include "plasma_futex.h"
+
+void
+plasma_call_once_slow (plasma_once_t * const restrict once,
+                       void (*func)(void))
+{
+    uint32_t * const state = &once->state;
+    uint32_t s = PLASMA_ONCE_UNINIT;
+    if (plasma_atomic_CAS_32(state, s, PLASMA_ONCE_RUNNING)) {
+        func();
+        /* publish results of func; wake waiters (if any) */
+        s = plasma_atomic_exchange_n_u32(state, PLASMA_ONCE_DONE,
+                                         memory_order_acq_rel);
+        if (s == PLASMA_ONCE_WAITERS)
+            plasma_futex_wake_all(state);
+        return;
+    }
+    /* another thread is running func; wait until done */
+    while ((s = plasma_atomic_load_explicit(state, memory_order_acquire))
+           != PLASMA_ONCE_DONE) {
+        if (s == PLASMA_ONCE_RUNNING
+            && !plasma_atomic_CAS_32(state, s, PLASMA_ONCE_WAITERS))
+            continue;
+        plasma_futex_wait(state, PLASMA_ONCE_WAITERS, PLASMA_FUTEX_INFINITE);
+    }
+}
+
+
+/* inlined functions defined in header
+ * (generate external linkage definition in C99-compliant compilers)
+ * (need to -duplicate- definition from header for non-C99-compliant compilers)
+ */
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__)
+extern inline
+void
+plasma_call_once (plasma_once_t * const restrict once, void (*func)(void));
+void
+plasma_call_once (plasma_once_t * const restrict once, void (*func)(void));
+#endif
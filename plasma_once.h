@@ -0,0 +1,109 @@
+/*
+ * plasma_once - once-only initialization
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_PLASMA_ONCE_H
+#define INCLUDED_PLASMA_ONCE_H
+
+#include "plasma_feature.h"
+#include "plasma_attr.h"
+#include "plasma_membar.h"
+#include "plasma_atomic.h"
+PLASMA_ATTR_Pragma_once
+
+#ifndef PLASMA_ONCE_C99INLINE
+#define PLASMA_ONCE_C99INLINE C99INLINE
+#endif
+#ifndef NO_C99INLINE
+#ifndef PLASMA_ONCE_C99INLINE_FUNCS
+#define PLASMA_ONCE_C99INLINE_FUNCS
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* plasma_call_once()
+ * plasma_once_is_done()
+ *
+ * Run func exactly once for a given plasma_once_t (similar to C11 call_once()
+ * and pthread_once()), e.g. for lazy initialization of globals or singletons.
+ * Fast path (after initialization) is a single acquire load and predictable
+ * branch, inlined into caller (no function call).  First caller runs func,
+ * and concurrent callers block (plasma_futex_wait()) until func completes.
+ * All callers observe stores made by func after plasma_call_once() returns.
+ *
+ * NB: func must not call plasma_call_once() on the same plasma_once_t
+ * (deadlock), and func must return (must not longjmp() or cancel thread).
+ */
+
+typedef struct plasma_once_t {
+    uint32_t state;
+} plasma_once_t;
+
+#define PLASMA_ONCE_UNINIT  0u
+#define PLASMA_ONCE_RUNNING 1u
+#define PLASMA_ONCE_WAITERS 2u
+#define PLASMA_ONCE_DONE    3u
+
+#define PLASMA_ONCE_INITIALIZER { PLASMA_ONCE_UNINIT }
+#define plasma_once_init(once) ((once)->state = PLASMA_ONCE_UNINIT)
+
+__attribute_cold__
+__attribute_noinline__
+__attribute_nonnull__()
+void
+plasma_call_once_slow (plasma_once_t * const restrict once,
+                       void (*func)(void));
+
+#define plasma_once_is_done(once) \
+        (plasma_atomic_load_explicit(&(once)->state, memory_order_acquire) \
+         == PLASMA_ONCE_DONE)
+
+__attribute_nonnull__()
+PLASMA_ONCE_C99INLINE
+void
+plasma_call_once (plasma_once_t * const restrict once, void (*func)(void));
+#ifdef PLASMA_ONCE_C99INLINE_FUNCS
+PLASMA_ONCE_C99INLINE
+void
+plasma_call_once (plasma_once_t * const restrict once, void (*func)(void))
+{
+    if (__builtin_expect( (!plasma_once_is_done(once)), 0))
+        plasma_call_once_slow(once, func);
+}
+#endif
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+
+/* NOTES and REFERENCES
+ *
+ * Mike Burrows, "Fast once-only initialization" (described in)
+ * http://www.open-std.org/jtc1/sc22/wg21/docs/papers/2007/n2444.html
+ * http://pubs.opengroup.org/onlinepubs/9699919799/functions/pthread_once.html
+ */
@@ -0,0 +1,93 @@
+/*
+ * plasma_optlock - optimistic version lock (optimistic lock coupling)
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define PLASMA_FEATURE_DISABLE_WIN32_FULLHDRS
+#define PLASMA_OPTLOCK_C99INLINE_FUNCS
+
+/* inlined functions defined in header
+ * (generate external linkage definition in GCC versions earlier than GCC 4.3)*/
+#if defined(NO_C99INLINE) \
+ || defined(__clang__) || (defined(__GNUC__) && !defined(__GNUC_STDC_INLINE__))
+#define PLASMA_OPTLOCK_C99INLINE
+#endif
+
+#include "plasma_optlock.h"
+#include "plasma_spin.h"
+
+uint64_t
+plasma_optlock_wait_unlocked (const plasma_optlock_t * const restrict ol)
+{
+    uint32_t spins = plasma_spin_wait_budget_ns(PLASMA_OPTLOCK_SPIN_NS);
+    uint64_t v;
+    while (plasma_optlock_is_locked(
+             v = plasma_atomic_load_explicit(&ol->word, memory_order_relaxed)))
+        plasma_spin_wait_yield(&spins);
+    return v;
+}
+
+
+/* inlined functions defined in header
+ * (generate external linkage definition in C99-compliant compilers)
+ * (need to -duplicate- definition from header for non-C99-compliant compilers)
+ */
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__)
+extern inline
+bool
+plasma_optlock_read_begin (const plasma_optlock_t * const restrict ol,
+                           uint64_t * const restrict version);
+bool
+plasma_optlock_read_begin (const plasma_optlock_t * const restrict ol,
+                           uint64_t * const restrict version);
+
+extern inline
+bool
+plasma_optlock_read_validate (const plasma_optlock_t * const restrict ol,
+                              const uint64_t version);
+bool
+plasma_optlock_read_validate (const plasma_optlock_t * const restrict ol,
+                              const uint64_t version);
+
+extern inline
+bool
+plasma_optlock_upgrade (plasma_optlock_t * const restrict ol,
+                        const uint64_t version);
+bool
+plasma_optlock_upgrade (plasma_optlock_t * const restrict ol,
+                        const uint64_t version);
+
+extern inline
+bool
+plasma_optlock_write_lock (plasma_optlock_t * const restrict ol);
+bool
+plasma_optlock_write_lock (plasma_optlock_t * const restrict ol);
+
+extern inline
+void
+plasma_optlock_write_unlock (plasma_optlock_t * const restrict ol);
+void
+plasma_optlock_write_unlock (plasma_optlock_t * const restrict ol);
+
+extern inline
+void
+plasma_optlock_write_unlock_obsolete (plasma_optlock_t * const restrict ol);
+void
+plasma_optlock_write_unlock_obsolete (plasma_optlock_t * const restrict ol);
+#endif
@@ -0,0 +1,235 @@
+/*
+ * plasma_optlock - optimistic version lock (optimistic lock coupling)
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_PLASMA_OPTLOCK_H
+#define INCLUDED_PLASMA_OPTLOCK_H
+
+#include "plasma_feature.h"
+#include "plasma_attr.h"
+#include "plasma_membar.h"
+#include "plasma_atomic.h"
+PLASMA_ATTR_Pragma_once
+
+#ifndef PLASMA_OPTLOCK_C99INLINE
+#define PLASMA_OPTLOCK_C99INLINE C99INLINE
+#endif
+#ifndef NO_C99INLINE
+#ifndef PLASMA_OPTLOCK_C99INLINE_FUNCS
+#define PLASMA_OPTLOCK_C99INLINE_FUNCS
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* plasma_optlock_init()
+ * plasma_optlock_read_begin()
+ * plasma_optlock_read_validate()
+ * plasma_optlock_upgrade()
+ * plasma_optlock_write_lock()
+ * plasma_optlock_write_unlock()
+ * plasma_optlock_write_unlock_obsolete()
+ *
+ * Optimistic version lock for read-mostly nodes of in-memory trees and
+ * indexes (optimistic lock coupling).  Single 64-bit word: bit 0 is the
+ * obsolete bit (node removed from structure), bit 1 is the write lock bit,
+ * and bits 2-63 are the version, incremented by each write unlock.
+ * Readers perform zero stores to shared memory: reader takes a version
+ * snapshot (waiting while write-locked), reads node, and then validates that
+ * version is unchanged, restarting otherwise.  Writer locks with
+ * plasma_atomic_CAS_64(), either directly (plasma_optlock_write_lock()) or by
+ * upgrading a version snapshot (plasma_optlock_upgrade(); fails if node
+ * changed since snapshot, and reader must restart).
+ *
+ * plasma_optlock_read_begin() and plasma_optlock_write_lock() return false if
+ * node is obsolete (caller must restart from parent or root).
+ * plasma_optlock_write_unlock_obsolete() unlocks and marks node obsolete
+ * (node must not be freed until no reader can still access it, e.g. with
+ *  epoch-based reclamation; not provided here).
+ *
+ * Typical usage (lock coupling: validate parent after reading child pointer):
+ *   uint64_t v;
+ *   if (!plasma_optlock_read_begin(&node->lock, &v)) goto restart;
+ *   ... read node (relaxed atomic loads); must not trust values yet ...
+ *   if (!plasma_optlock_read_validate(&node->lock, v)) goto restart;
+ *
+ * NB: as with plasma_seqlock, readers might observe inconsistent data prior to
+ * validation, and must not act on it (e.g. must bounds-check array indexes
+ * and must validate before dereferencing pointers read from node).  Reads and
+ * writes of protected data should be plasma_atomic_load_explicit() and
+ * plasma_atomic_store_explicit() with memory_order_relaxed (or volatile).
+ *
+ * NB: waits spin (plasma_spin_pause(), then plasma_spin_yield()); writers do
+ * not park.  Keep write sections short.
+ */
+
+typedef __attribute_aligned__(8)
+struct plasma_optlock_t {
+    uint64_t word;
+} plasma_optlock_t;
+
+#define PLASMA_OPTLOCK_OBSOLETE UINT64_C(0x1)
+#define PLASMA_OPTLOCK_LOCKED   UINT64_C(0x2)
+
+#ifndef PLASMA_OPTLOCK_SPIN_NS
+#define PLASMA_OPTLOCK_SPIN_NS 4000
+#endif
+
+#define PLASMA_OPTLOCK_INITIALIZER { 0 }
+#define plasma_optlock_init(ol) ((ol)->word = 0)
+
+#define plasma_optlock_is_locked(v)   (((v) & PLASMA_OPTLOCK_LOCKED) != 0)
+#define plasma_optlock_is_obsolete(v) (((v) & PLASMA_OPTLOCK_OBSOLETE) != 0)
+
+/*(plasma_optlock_wait_unlocked() returns version observed while unlocked)*/
+__attribute_noinline__
+__attribute_nonnull__()
+uint64_t
+plasma_optlock_wait_unlocked (const plasma_optlock_t * const restrict ol);
+
+__attribute_nonnull__()
+PLASMA_OPTLOCK_C99INLINE
+bool
+plasma_optlock_read_begin (const plasma_optlock_t * const restrict ol,
+                           uint64_t * const restrict version);
+#ifdef PLASMA_OPTLOCK_C99INLINE_FUNCS
+PLASMA_OPTLOCK_C99INLINE
+bool
+plasma_optlock_read_begin (const plasma_optlock_t * const restrict ol,
+                           uint64_t * const restrict version)
+{
+    uint64_t v = plasma_atomic_load_explicit(&ol->word, memory_order_relaxed);
+    if (__builtin_expect( (plasma_optlock_is_locked(v)), 0))
+        v = plasma_optlock_wait_unlocked(ol);
+    plasma_membar_ld_acq();   /* order version load before data loads */
+    *version = v;
+    return !plasma_optlock_is_obsolete(v);
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_OPTLOCK_C99INLINE
+bool
+plasma_optlock_read_validate (const plasma_optlock_t * const restrict ol,
+                              const uint64_t version);
+#ifdef PLASMA_OPTLOCK_C99INLINE_FUNCS
+PLASMA_OPTLOCK_C99INLINE
+bool
+plasma_optlock_read_validate (const plasma_optlock_t * const restrict ol,
+                              const uint64_t version)
+{
+    plasma_membar_LoadLoad(); /* order data loads before version load */
+    return (plasma_atomic_load_explicit(&ol->word, memory_order_relaxed)
+            == version);
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_OPTLOCK_C99INLINE
+bool
+plasma_optlock_upgrade (plasma_optlock_t * const restrict ol,
+                        const uint64_t version);
+#ifdef PLASMA_OPTLOCK_C99INLINE_FUNCS
+PLASMA_OPTLOCK_C99INLINE
+bool
+plasma_optlock_upgrade (plasma_optlock_t * const restrict ol,
+                        const uint64_t version)
+{
+    /* (version from plasma_optlock_read_begin() is unlocked, not obsolete) */
+    if (!plasma_atomic_CAS_64(&ol->word, version,
+                              version | PLASMA_OPTLOCK_LOCKED))
+        return false;
+    plasma_membar_atomic_thread_fence_acq_rel();
+    return true;
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_OPTLOCK_C99INLINE
+bool
+plasma_optlock_write_lock (plasma_optlock_t * const restrict ol);
+#ifdef PLASMA_OPTLOCK_C99INLINE_FUNCS
+PLASMA_OPTLOCK_C99INLINE
+bool
+plasma_optlock_write_lock (plasma_optlock_t * const restrict ol)
+{
+    uint64_t v;
+    do {
+        if (!plasma_optlock_read_begin(ol, &v))
+            return false;
+    } while (!plasma_optlock_upgrade(ol, v));
+    return true;
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_OPTLOCK_C99INLINE
+void
+plasma_optlock_write_unlock (plasma_optlock_t * const restrict ol);
+#ifdef PLASMA_OPTLOCK_C99INLINE_FUNCS
+PLASMA_OPTLOCK_C99INLINE
+void
+plasma_optlock_write_unlock (plasma_optlock_t * const restrict ol)
+{
+    /* clear lock bit and increment version (carry from lock bit) */
+    plasma_membar_st_rel();   /* order data stores before version store */
+    plasma_atomic_store_explicit(&ol->word,
+                                 ol->word + PLASMA_OPTLOCK_LOCKED,
+                                 memory_order_relaxed);
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_OPTLOCK_C99INLINE
+void
+plasma_optlock_write_unlock_obsolete (plasma_optlock_t * const restrict ol);
+#ifdef PLASMA_OPTLOCK_C99INLINE_FUNCS
+PLASMA_OPTLOCK_C99INLINE
+void
+plasma_optlock_write_unlock_obsolete (plasma_optlock_t * const restrict ol)
+{
+    plasma_membar_st_rel();
+    plasma_atomic_store_explicit(&ol->word,
+                                 (ol->word + PLASMA_OPTLOCK_LOCKED)
+                                   | PLASMA_OPTLOCK_OBSOLETE,
+                                 memory_order_relaxed);
+}
+#endif
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+
+/* NOTES and REFERENCES
+ *
+ * Viktor Leis, Florian Scheibner, Alfons Kemper, Thomas Neumann,
+ *   "The ART of Practical Synchronization", DaMoN 2016
+ *   (optimistic lock coupling; version lock with obsolete bit)
+ * https://db.in.tum.de/~leis/papers/artsync.pdf
+ * Hans-J. Boehm, "Can Seqlocks Get Along With Programming Language Memory
+ *   Models?", MSPC 2012
+ */
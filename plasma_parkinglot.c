@@ -0,0 +1,297 @@
+/*
+ * plasma_parkinglot - address-hashed wait queues for compact locks
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define PLASMA_FEATURE_DISABLE_WIN32_FULLHDRS
+#define PLASMA_PARKINGLOT_C99INLINE_FUNCS
+
+/* inlined functions defined in header
+ * (generate external linkage definition in GCC versions earlier than GCC 4.3)*/
+#if defined(NO_C99INLINE) \
+ || defined(__clang__) || (defined(__GNUC__) && !defined(__GNUC_STDC_INLINE__))
+#define PLASMA_PARKINGLOT_C99INLINE
+#endif
+
+#include "plasma_parkinglot.h"
+#include "plasma_futex.h"
+#include "plasma_spin.h"
+
+/* queue node for a parked thread (on stack of parked thread)
+ * word is set non-zero (under bucket lock) when node is dequeued by
+ * plasma_parkinglot_unpark_one(), and parked thread waits on word with
+ * plasma_futex_wait().
+ * (unparker calls plasma_futex_wake_one(&node->word) after releasing bucket
+ *  lock, by which time parked thread might have returned; a wake on a stale
+ *  address is harmless: at most a spurious wakeup of an unrelated waiter,
+ *  which plasma_futex_wait() callers tolerate)
+ * plasma_parkinglot_unpark_all() detaches nodes (marking node addr NULL)
+ * under bucket lock and sets word after releasing bucket lock; a parked thread
+ * which times out with its node detached waits for word to be set instead of
+ * dequeuing its node, so node remains valid until word is set */
+#define PLASMA_PARKINGLOT_BUCKETS 256  /* (power of 2; see hash below) */
+#if (PLASMA_PARKINGLOT_BUCKETS & (PLASMA_PARKINGLOT_BUCKETS-1)) \
+ || PLASMA_PARKINGLOT_BUCKETS > 65536
+#error "PLASMA_PARKINGLOT_BUCKETS must be power of 2 no larger than 65536"
+#endif
+
+typedef struct plasma_parkinglot_node_t {
+    const void *addr;
+    struct plasma_parkinglot_node_t *next;
+    uint32_t word;
+} plasma_parkinglot_node_t;
+
+typedef struct __attribute_aligned__(64) plasma_parkinglot_bucket_t {
+    plasma_spin_futexlock_t lock;
+    plasma_parkinglot_node_t *head;
+    plasma_parkinglot_node_t *tail;
+} plasma_parkinglot_bucket_t;
+
+/* (zero-initialized: PLASMA_SPIN_FUTEXLOCK_UNLOCKED and empty queues) */
+static plasma_parkinglot_bucket_t
+  plasma_parkinglot_buckets[PLASMA_PARKINGLOT_BUCKETS];
+
+#define plasma_parkinglot_bucket(addr) \
+  (plasma_parkinglot_buckets                                            \
+   + ((((uint32_t)((uintptr_t)(addr) >> 2) * 2654435761u) >> 16)       \
+      & (PLASMA_PARKINGLOT_BUCKETS-1)))
+
+static void
+plasma_parkinglot_dequeue (plasma_parkinglot_bucket_t * const restrict b,
+                           plasma_parkinglot_node_t * const restrict prev,
+                           plasma_parkinglot_node_t * const restrict node)
+{
+    if (prev)
+        prev->next = node->next;
+    else
+        b->head = node->next;
+    if (b->tail == node)
+        b->tail = prev;
+}
+
+plasma_parkinglot_result_t
+plasma_parkinglot_park (const void * const addr,
+                        bool (*validate)(void *), void * const arg,
+                        const uint64_t timeout_ns)
+{
+    plasma_parkinglot_bucket_t * const b = plasma_parkinglot_bucket(addr);
+    plasma_parkinglot_node_t node;
+    uint64_t deadline = 0;
+    uint64_t now;
+    bool infinite = (timeout_ns == PLASMA_FUTEX_INFINITE);
+
+    plasma_spin_futexlock_acquire(&b->lock);
+    if (validate && !validate(arg)) {
+        plasma_spin_futexlock_release(&b->lock);
+        return PLASMA_PARKINGLOT_INVALID;
+    }
+    node.addr = addr;
+    node.next = NULL;
+    node.word = 0;
+    if (b->tail)
+        b->tail->next = &node;
+    else
+        b->head = &node;
+    b->tail = &node;
+    plasma_spin_futexlock_release(&b->lock);
+
+    if (!infinite)
+        deadline = plasma_spin_clock_ns() + timeout_ns;
+    while (!plasma_atomic_load_explicit(&node.word, memory_order_acquire)) {
+        if (infinite)
+            plasma_futex_wait(&node.word, 0, PLASMA_FUTEX_INFINITE);
+        else if ((now = plasma_spin_clock_ns()) < deadline)
+            plasma_futex_wait(&node.word, 0, deadline - now);
+        else {
+            /* timeout; dequeue node unless concurrently unparked
+             * (unpark_one sets node.word under bucket lock; unpark_all
+             *  detaches node under bucket lock and sets node.word later) */
+            plasma_parkinglot_node_t *prev = NULL, *n;
+            plasma_spin_futexlock_acquire(&b->lock);
+            if (!plasma_atomic_load_explicit(&node.word,memory_order_relaxed)
+                && node.addr != NULL) {
+                for (n = b->head; n != &node; prev = n, n = n->next) ;
+                plasma_parkinglot_dequeue(b, prev, &node);
+                plasma_spin_futexlock_release(&b->lock);
+                return PLASMA_PARKINGLOT_TIMEOUT;
+            }
+            plasma_spin_futexlock_release(&b->lock);
+            infinite = true; /*(unparked; wait (briefly) for node.word)*/
+        }
+    }
+    return PLASMA_PARKINGLOT_UNPARKED;
+}
+
+bool
+plasma_parkinglot_unpark_one (const void * const addr,
+                              void (*callback)(void *, bool, bool),
+                              void * const arg)
+{
+    plasma_parkinglot_bucket_t * const b = plasma_parkinglot_bucket(addr);
+    plasma_parkinglot_node_t *prev = NULL, *node, *n;
+    uint32_t *word = NULL;
+    bool more = false;
+
+    plasma_spin_futexlock_acquire(&b->lock);
+    for (node = b->head; node && node->addr != addr; node = node->next)
+        prev = node;
+    if (node) {
+        plasma_parkinglot_dequeue(b, prev, node);
+        for (n = node->next; n && n->addr != addr; n = n->next) ;
+        more = (n != NULL);
+        word = &node->word;
+    }
+    if (callback)
+        callback(arg, (node != NULL), more);
+    if (word)  /* (node must not be accessed after word is set) */
+        plasma_atomic_store_explicit(word, 1, memory_order_release);
+    plasma_spin_futexlock_release(&b->lock);
+
+    if (word)
+        plasma_futex_wake_one(word);
+    return (word != NULL);
+}
+
+uint32_t
+plasma_parkinglot_unpark_all (const void * const addr)
+{
+    /* detach nodes for addr under bucket lock; wake after releasing lock
+     * (see plasma_parkinglot_node_t) */
+    plasma_parkinglot_bucket_t * const b = plasma_parkinglot_bucket(addr);
+    plasma_parkinglot_node_t *prev = NULL, *node, *next;
+    plasma_parkinglot_node_t *head = NULL, **tailp = &head;
+    uint32_t n = 0;
+
+    plasma_spin_futexlock_acquire(&b->lock);
+    for (node = b->head; node; node = next) {
+        next = node->next;
+        if (node->addr != addr) {
+            prev = node;
+            continue;
+        }
+        plasma_parkinglot_dequeue(b, prev, node);
+        node->addr = NULL; /*(detached)*/
+        *tailp = node;
+        tailp = &node->next;
+        ++n;
+    }
+    *tailp = NULL;
+    plasma_spin_futexlock_release(&b->lock);
+
+    for (node = head; node; node = next) {
+        uint32_t * const word = &node->word;
+        next = node->next; /* (node must not be accessed after word is set) */
+        plasma_atomic_store_explicit(word, 1, memory_order_release);
+        plasma_futex_wake_one(word);
+    }
+    return n;
+}
+
+
+/* plasma_parklock_*() slow paths */
+
+static bool
+plasma_parklock_validate (void * const arg)
+{
+    /* park only if lock is still held and marked as having parked threads */
+    const uint32_t v =
+      plasma_atomic_load_explicit((uint32_t *)arg, memory_order_relaxed);
+    return ((v & (PLASMA_PARKLOCK_HELD|PLASMA_PARKLOCK_PARKED))
+            ==   (PLASMA_PARKLOCK_HELD|PLASMA_PARKLOCK_PARKED));
+}
+
+static void
+plasma_parklock_unparked (void * const arg, const bool did_unpark,
+                          const bool may_have_more)
+{
+    /* release lock; clear PARKED if no threads remain parked
+     * (runs under bucket lock, so PARKED can not be set concurrently by a
+     *  thread about to park without its validate seeing the update) */
+    uint32_t * const word = (uint32_t *)arg;
+    const uint32_t clr = may_have_more
+      ? PLASMA_PARKLOCK_HELD
+      : PLASMA_PARKLOCK_HELD|PLASMA_PARKLOCK_PARKED;
+    uint32_t v;
+    (void)did_unpark;
+    do {
+        v = plasma_atomic_load_explicit(word, memory_order_relaxed);
+    } while (!plasma_atomic_CAS_32(word, v, v & ~clr));
+}
+
+void
+plasma_parklock_acquire_park (uint32_t * const word)
+{
+    uint32_t spins = plasma_spin_wait_budget_ns(PLASMA_PARKLOCK_SPIN_NS);
+    uint32_t v;
+    for (;;) {
+        v = plasma_atomic_load_explicit(word, memory_order_relaxed);
+        if (!(v & PLASMA_PARKLOCK_HELD)) {
+            if (plasma_atomic_CAS_32(word, v, v | PLASMA_PARKLOCK_HELD))
+                break;
+        }
+        else if (!(v & PLASMA_PARKLOCK_PARKED)) {
+            if (!plasma_spin_wait_pause(&spins)
+                && plasma_atomic_CAS_32(word, v, v|PLASMA_PARKLOCK_PARKED))
+                plasma_parkinglot_park(word, plasma_parklock_validate, word,
+                                       PLASMA_FUTEX_INFINITE);
+        }
+        else
+            plasma_parkinglot_park(word, plasma_parklock_validate, word,
+                                   PLASMA_FUTEX_INFINITE);
+    }
+    plasma_membar_atomic_thread_fence_acq_rel();
+}
+
+void
+plasma_parklock_release_unpark (uint32_t * const word)
+{
+    uint32_t v;
+    do {
+        v = plasma_atomic_load_explicit(word, memory_order_relaxed);
+        if (v & PLASMA_PARKLOCK_PARKED) {
+            plasma_parkinglot_unpark_one(word, plasma_parklock_unparked, word);
+            return;
+        }
+    } while (!plasma_atomic_CAS_32(word, v, v & ~PLASMA_PARKLOCK_HELD));
+}
+
+
+/* inlined functions defined in header
+ * (generate external linkage definition in C99-compliant compilers)
+ * (need to -duplicate- definition from header for non-C99-compliant compilers)
+ */
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__)
+extern inline
+bool
+plasma_parklock_acquire_try (uint32_t * const word);
+bool
+plasma_parklock_acquire_try (uint32_t * const word);
+
+extern inline
+void
+plasma_parklock_acquire (uint32_t * const word);
+void
+plasma_parklock_acquire (uint32_t * const word);
+
+extern inline
+void
+plasma_parklock_release (uint32_t * const word);
+void
+plasma_parklock_release (uint32_t * const word);
+#endif
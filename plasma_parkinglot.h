@@ -0,0 +1,196 @@
+/*
+ * plasma_parkinglot - address-hashed wait queues for compact locks
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_PLASMA_PARKINGLOT_H
+#define INCLUDED_PLASMA_PARKINGLOT_H
+
+#include "plasma_feature.h"
+#include "plasma_attr.h"
+#include "plasma_membar.h"
+#include "plasma_atomic.h"
+PLASMA_ATTR_Pragma_once
+
+#ifndef PLASMA_PARKINGLOT_C99INLINE
+#define PLASMA_PARKINGLOT_C99INLINE C99INLINE
+#endif
+#ifndef NO_C99INLINE
+#ifndef PLASMA_PARKINGLOT_C99INLINE_FUNCS
+#define PLASMA_PARKINGLOT_C99INLINE_FUNCS
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* plasma_parkinglot_park()
+ * plasma_parkinglot_unpark_one()
+ * plasma_parkinglot_unpark_all()
+ *
+ * Global table of wait queues, hashed by address, so that a lock (or other
+ * synchronization object) need not contain its own wait queue or futex word.
+ * Lock state can then be as small as a couple of bits in a caller-owned word.
+ *
+ * plasma_parkinglot_park() locks the bucket for addr, calls validate(arg)
+ * (if validate is not NULL) while bucket is locked, and parks the calling
+ * thread on addr if validate returns true, until unparked or timeout_ns
+ * nanoseconds elapse (PLASMA_FUTEX_INFINITE to wait without timeout).
+ * plasma_parkinglot_unpark_one() unparks the first (FIFO) thread parked on
+ * addr, calling callback(arg, did_unpark, may_have_more) while the bucket is
+ * locked, so that caller can atomically update its state, e.g. clear a
+ * "has parked threads" bit if no threads remain parked on addr.
+ * plasma_parkinglot_unpark_all() unparks all threads parked on addr.
+ *
+ * Parked threads wait on a word in a stack-allocated queue node using
+ * plasma_futex_wait() (see plasma_futex.h for platform implementations).
+ * Buckets are locked with plasma_spin_futexlock_t.  Callbacks run while the
+ * bucket is locked and must be short, and must not park or unpark.
+ * (Table has a fixed number of buckets; unrelated addresses might share a
+ *  bucket (and bucket lock), but parked threads are matched by address)
+ *
+ * plasma_parklock_acquire()
+ * plasma_parklock_acquire_try()
+ * plasma_parklock_release()
+ *
+ * Compact lock occupying two bits (PLASMA_PARKLOCK_HELD and
+ * PLASMA_PARKLOCK_PARKED) of a caller-owned 32-bit word; remaining 30 bits
+ * are preserved and are available to the caller (modify those bits only with
+ * atomic operations).  Uncontended acquire and release are each a single CAS.
+ * Contended acquire spins briefly (PLASMA_PARKLOCK_SPIN_NS) and then sets
+ * PARKED and parks in the parking lot; release unparks one thread if PARKED
+ * is set.  Lock is not fair (barging), similar to WebKit WTF::Lock.
+ * (1-byte lock would require 8-bit atomics, not provided by plasma_atomic)
+ */
+
+typedef enum plasma_parkinglot_result_t {
+    PLASMA_PARKINGLOT_UNPARKED = 0,
+    PLASMA_PARKINGLOT_INVALID,      /* validate() returned false */
+    PLASMA_PARKINGLOT_TIMEOUT
+} plasma_parkinglot_result_t;
+
+__attribute_nonnull__((1))
+plasma_parkinglot_result_t
+plasma_parkinglot_park (const void * const addr,
+                        bool (*validate)(void *), void * const arg,
+                        const uint64_t timeout_ns);
+
+__attribute_nonnull__((1))
+bool
+plasma_parkinglot_unpark_one (const void * const addr,
+                              void (*callback)(void *, bool, bool),
+                              void * const arg);
+
+__attribute_nonnull__()
+uint32_t
+plasma_parkinglot_unpark_all (const void * const addr);
+
+
+#define PLASMA_PARKLOCK_HELD   0x1u
+#define PLASMA_PARKLOCK_PARKED 0x2u
+
+#ifndef PLASMA_PARKLOCK_SPIN_NS
+#define PLASMA_PARKLOCK_SPIN_NS 2000
+#endif
+
+#define plasma_parklock_is_free(word) \
+        (!(plasma_atomic_load_explicit((word), memory_order_relaxed) \
+           & PLASMA_PARKLOCK_HELD))
+
+__attribute_nonnull__()
+void
+plasma_parklock_acquire_park (uint32_t * const word);
+
+__attribute_nonnull__()
+void
+plasma_parklock_release_unpark (uint32_t * const word);
+
+__attribute_nonnull__()
+PLASMA_PARKINGLOT_C99INLINE
+bool
+plasma_parklock_acquire_try (uint32_t * const word);
+#ifdef PLASMA_PARKINGLOT_C99INLINE_FUNCS
+PLASMA_PARKINGLOT_C99INLINE
+bool
+plasma_parklock_acquire_try (uint32_t * const word)
+{
+    uint32_t v;
+    do {
+        v = plasma_atomic_load_explicit(word, memory_order_relaxed);
+        if (v & PLASMA_PARKLOCK_HELD)
+            return false;
+    } while (!plasma_atomic_CAS_32(word, v, v | PLASMA_PARKLOCK_HELD));
+    plasma_membar_atomic_thread_fence_acq_rel();
+    return true;
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_PARKINGLOT_C99INLINE
+void
+plasma_parklock_acquire (uint32_t * const word);
+#ifdef PLASMA_PARKINGLOT_C99INLINE_FUNCS
+PLASMA_PARKINGLOT_C99INLINE
+void
+plasma_parklock_acquire (uint32_t * const word)
+{
+    const uint32_t v = plasma_atomic_load_explicit(word, memory_order_relaxed);
+    if (__builtin_expect(
+          ((v & PLASMA_PARKLOCK_HELD)
+           || !plasma_atomic_CAS_32(word, v, v | PLASMA_PARKLOCK_HELD)), 0))
+        plasma_parklock_acquire_park(word);
+    else
+        plasma_membar_atomic_thread_fence_acq_rel();
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_PARKINGLOT_C99INLINE
+void
+plasma_parklock_release (uint32_t * const word);
+#ifdef PLASMA_PARKINGLOT_C99INLINE_FUNCS
+PLASMA_PARKINGLOT_C99INLINE
+void
+plasma_parklock_release (uint32_t * const word)
+{
+    const uint32_t v = plasma_atomic_load_explicit(word, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    if (__builtin_expect(
+          ((v & PLASMA_PARKLOCK_PARKED)
+           || !plasma_atomic_CAS_32(word, v, v & ~PLASMA_PARKLOCK_HELD)), 0))
+        plasma_parklock_release_unpark(word);
+}
+#endif
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+
+/* NOTES and REFERENCES
+ *
+ * Filip Pizlo, "Locking in WebKit", 2016  (ParkingLot, WTF::Lock)
+ * https://webkit.org/blog/6161/locking-in-webkit/
+ * Linux kernel futex hash table of wait queues (kernel/futex)
+ */
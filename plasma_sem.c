@@ -0,0 +1,131 @@
+/*
+ * plasma_sem - counting semaphore and countdown latch
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define PLASMA_FEATURE_DISABLE_WIN32_FULLHDRS
+#define PLASMA_SEM_C99INLINE_FUNCS
+
+/* inlined functions defined in header
+ * (generate external linkage definition in GCC versions earlier than GCC 4.3)*/
+#if defined(NO_C99INLINE) \
+ || defined(__clang__) || (defined(__GNUC__) && !defined(__GNUC_STDC_INLINE__))
+#define PLASMA_SEM_C99INLINE
+#endif
+
+#include "plasma_sem.h"
+#include "plasma_futex.h"
+#include "plasma_spin.h"
+
+void
+plasma_sem_wait_park (plasma_sem_t * const restrict sem)
+{
+    /* (count already decremented; wait for a wakeup token from post) */
+    uint32_t * const tokens = &sem->tokens;
+    uint32_t spins = plasma_spin_wait_budget_ns(PLASMA_SEM_SPIN_NS);
+    uint32_t t;
+    for (;;) {
+        t = plasma_atomic_load_explicit(tokens, memory_order_relaxed);
+        if (t != 0) {
+            if (plasma_atomic_CAS_32(tokens, t, t-1))
+                break;
+        }
+        else if (!plasma_spin_wait_pause(&spins))
+            plasma_futex_wait(tokens, 0, PLASMA_FUTEX_INFINITE);
+    }
+    plasma_membar_atomic_thread_fence_acq_rel();
+}
+
+void
+plasma_sem_post_wake (plasma_sem_t * const restrict sem, const uint32_t n)
+{
+    plasma_atomic_fetch_add_u32(&sem->tokens, n, memory_order_release);
+    plasma_futex_wake_n(&sem->tokens, n);
+}
+
+void
+plasma_latch_wait_park (plasma_latch_t * const restrict latch)
+{
+    uint32_t * const count = &latch->count;
+    uint32_t spins = plasma_spin_wait_budget_ns(PLASMA_SEM_SPIN_NS);
+    uint32_t c;
+    while ((c = plasma_atomic_load_explicit(count, memory_order_acquire))) {
+        if (plasma_spin_wait_pause(&spins))
+            continue;
+        /* register as waiter prior to re-checking count (seq_cst; pairs
+         * with seq_cst in plasma_latch_count_down(), plasma_latch_wake()) */
+        plasma_atomic_store_explicit(&latch->waiters, 1, memory_order_seq_cst);
+        c = plasma_atomic_load_explicit(count, memory_order_seq_cst);
+        if (c == 0)
+            break;
+        plasma_futex_wait(count, c, PLASMA_FUTEX_INFINITE);
+    }
+}
+
+void
+plasma_latch_wake (plasma_latch_t * const restrict latch)
+{
+    if (plasma_atomic_load_explicit(&latch->waiters, memory_order_seq_cst))
+        plasma_futex_wake_all(&latch->count);
+}
+
+
+/* inlined functions defined in header
+ * (generate external linkage definition in C99-compliant compilers)
+ * (need to -duplicate- definition from header for non-C99-compliant compilers)
+ */
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__)
+extern inline
+void
+plasma_sem_wait (plasma_sem_t * const restrict sem);
+void
+plasma_sem_wait (plasma_sem_t * const restrict sem);
+
+extern inline
+bool
+plasma_sem_trywait (plasma_sem_t * const restrict sem);
+bool
+plasma_sem_trywait (plasma_sem_t * const restrict sem);
+
+extern inline
+void
+plasma_sem_post (plasma_sem_t * const restrict sem, const uint32_t n);
+void
+plasma_sem_post (plasma_sem_t * const restrict sem, const uint32_t n);
+
+extern inline
+void
+plasma_latch_count_down (plasma_latch_t * const restrict latch,
+                         const uint32_t n);
+void
+plasma_latch_count_down (plasma_latch_t * const restrict latch,
+                         const uint32_t n);
+
+extern inline
+bool
+plasma_latch_try_wait (const plasma_latch_t * const restrict latch);
+bool
+plasma_latch_try_wait (const plasma_latch_t * const restrict latch);
+
+extern inline
+void
+plasma_latch_wait (plasma_latch_t * const restrict latch);
+void
+plasma_latch_wait (plasma_latch_t * const restrict latch);
+#endif
@@ -0,0 +1,249 @@
+/*
+ * plasma_sem - counting semaphore and countdown latch
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_PLASMA_SEM_H
+#define INCLUDED_PLASMA_SEM_H
+
+#include "plasma_feature.h"
+#include "plasma_attr.h"
+#include "plasma_membar.h"
+#include "plasma_atomic.h"
+PLASMA_ATTR_Pragma_once
+
+#ifndef PLASMA_SEM_C99INLINE
+#define PLASMA_SEM_C99INLINE C99INLINE
+#endif
+#ifndef NO_C99INLINE
+#ifndef PLASMA_SEM_C99INLINE_FUNCS
+#define PLASMA_SEM_C99INLINE_FUNCS
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* plasma_sem_init()
+ * plasma_sem_wait()
+ * plasma_sem_trywait()
+ * plasma_sem_post()
+ *
+ * Counting semaphore (process-private).  count is signed: count > 0 is the
+ * number of available units, and count < 0 is (negated) number of waiters.
+ * Uncontended wait is a single plasma_atomic_fetch_sub_u32(), and uncontended
+ * post is a single plasma_atomic_fetch_add_u32().  Waiter which decrements
+ * count below zero spins briefly (PLASMA_SEM_SPIN_NS) and then parks
+ * (plasma_futex_wait()) until post hands it a wakeup token.
+ * plasma_sem_post(sem, n) releases n units and hands tokens to (and wakes)
+ * exactly min(n, waiters) waiters with a single plasma_futex_wake_n().
+ * Semaphore is not fair.
+ *
+ * (count must not exceed INT32_MAX; count of waiters must not exceed INT32_MAX)
+ */
+
+#ifndef PLASMA_SEM_SPIN_NS
+#define PLASMA_SEM_SPIN_NS 2000
+#endif
+
+typedef __attribute_aligned__(16)
+struct plasma_sem_t {
+    uint32_t count;   /* (int32_t) */
+    uint32_t tokens;  /* wakeup tokens for waiters (futex word) */
+    uint64_t udata64; /* user data 8-bytes */
+} plasma_sem_t;
+
+#if (defined(__STDC_VERSION__) && __STDC_VERSION__-0 >= 199901L) /* C99 */
+#define PLASMA_SEM_INITIALIZER(n) \
+        { .count = (uint32_t)(n), .tokens = 0, .udata64 = 0 }
+#else
+#define PLASMA_SEM_INITIALIZER(n) { (uint32_t)(n), 0, 0 }
+#endif
+#define plasma_sem_init(sem, n) \
+        ((sem)->count = (uint32_t)(n), (sem)->tokens = 0, (sem)->udata64 = 0)
+
+__attribute_nonnull__()
+void
+plasma_sem_wait_park (plasma_sem_t * const restrict sem);
+
+__attribute_nonnull__()
+void
+plasma_sem_post_wake (plasma_sem_t * const restrict sem, const uint32_t n);
+
+__attribute_nonnull__()
+PLASMA_SEM_C99INLINE
+void
+plasma_sem_wait (plasma_sem_t * const restrict sem);
+#ifdef PLASMA_SEM_C99INLINE_FUNCS
+PLASMA_SEM_C99INLINE
+void
+plasma_sem_wait (plasma_sem_t * const restrict sem)
+{
+    if (__builtin_expect(
+          ((int32_t)plasma_atomic_fetch_sub_u32(&sem->count, 1,
+                                                memory_order_acq_rel) <= 0), 0))
+        plasma_sem_wait_park(sem);
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_SEM_C99INLINE
+bool
+plasma_sem_trywait (plasma_sem_t * const restrict sem);
+#ifdef PLASMA_SEM_C99INLINE_FUNCS
+PLASMA_SEM_C99INLINE
+bool
+plasma_sem_trywait (plasma_sem_t * const restrict sem)
+{
+    uint32_t c;
+    do {
+        c = plasma_atomic_load_explicit(&sem->count, memory_order_relaxed);
+        if ((int32_t)c <= 0)
+            return false;
+    } while (!plasma_atomic_CAS_32(&sem->count, c, c-1));
+    plasma_membar_atomic_thread_fence_acq_rel();
+    return true;
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_SEM_C99INLINE
+void
+plasma_sem_post (plasma_sem_t * const restrict sem, const uint32_t n);
+#ifdef PLASMA_SEM_C99INLINE_FUNCS
+PLASMA_SEM_C99INLINE
+void
+plasma_sem_post (plasma_sem_t * const restrict sem, const uint32_t n)
+{
+    const int32_t c =
+      (int32_t)plasma_atomic_fetch_add_u32(&sem->count, n,
+                                           memory_order_acq_rel);
+    if (__builtin_expect( (c < 0), 0))  /* wake min(n, waiters) */
+        plasma_sem_post_wake(sem, (uint32_t)-c < n ? (uint32_t)-c : n);
+}
+#endif
+
+
+/* plasma_latch_init()
+ * plasma_latch_count_down()
+ * plasma_latch_try_wait()
+ * plasma_latch_wait()
+ * plasma_latch_arrive_and_wait()
+ *
+ * One-shot countdown latch (process-private), similar to C++20 std::latch.
+ * count_down(n) is a single plasma_atomic_fetch_sub_u32(); the count_down
+ * which reaches zero wakes all waiters (plasma_futex_wake_all()), but only if
+ * any thread has parked.  wait() spins briefly (PLASMA_SEM_SPIN_NS) and then
+ * parks until count reaches zero.  Latch can not be reset (except by
+ * plasma_latch_init() when no threads are using it).
+ *
+ * (count_down by more than remaining count is undefined behavior)
+ */
+
+typedef __attribute_aligned__(16)
+struct plasma_latch_t {
+    uint32_t count;   /* (futex word) */
+    uint32_t waiters; /* (non-zero if thread might be parked) */
+    uint64_t udata64; /* user data 8-bytes */
+} plasma_latch_t;
+
+#if (defined(__STDC_VERSION__) && __STDC_VERSION__-0 >= 199901L) /* C99 */
+#define PLASMA_LATCH_INITIALIZER(n) \
+        { .count = (uint32_t)(n), .waiters = 0, .udata64 = 0 }
+#else
+#define PLASMA_LATCH_INITIALIZER(n) { (uint32_t)(n), 0, 0 }
+#endif
+#define plasma_latch_init(latch, n) \
+        ((latch)->count = (uint32_t)(n), (latch)->waiters = 0, \
+         (latch)->udata64 = 0)
+
+__attribute_nonnull__()
+void
+plasma_latch_wait_park (plasma_latch_t * const restrict latch);
+
+__attribute_nonnull__()
+void
+plasma_latch_wake (plasma_latch_t * const restrict latch);
+
+__attribute_nonnull__()
+PLASMA_SEM_C99INLINE
+void
+plasma_latch_count_down (plasma_latch_t * const restrict latch,
+                         const uint32_t n);
+#ifdef PLASMA_SEM_C99INLINE_FUNCS
+PLASMA_SEM_C99INLINE
+void
+plasma_latch_count_down (plasma_latch_t * const restrict latch,
+                         const uint32_t n)
+{
+    if (plasma_atomic_fetch_sub_u32(&latch->count, n, memory_order_seq_cst)
+        == n)
+        plasma_latch_wake(latch);
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_SEM_C99INLINE
+bool
+plasma_latch_try_wait (const plasma_latch_t * const restrict latch);
+#ifdef PLASMA_SEM_C99INLINE_FUNCS
+PLASMA_SEM_C99INLINE
+bool
+plasma_latch_try_wait (const plasma_latch_t * const restrict latch)
+{
+    return (0 == plasma_atomic_load_explicit(&latch->count,
+                                             memory_order_acquire));
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_SEM_C99INLINE
+void
+plasma_latch_wait (plasma_latch_t * const restrict latch);
+#ifdef PLASMA_SEM_C99INLINE_FUNCS
+PLASMA_SEM_C99INLINE
+void
+plasma_latch_wait (plasma_latch_t * const restrict latch)
+{
+    if (!plasma_latch_try_wait(latch))
+        plasma_latch_wait_park(latch);
+}
+#endif
+
+#define plasma_latch_arrive_and_wait(latch, n) \
+        (plasma_latch_count_down((latch),(n)), plasma_latch_wait(latch))
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+
+/* NOTES and REFERENCES
+ *
+ * Jeff Preshing, "Semaphores are Surprisingly Versatile", 2015
+ *   (lightweight semaphore: signed count on top of a blocking semaphore)
+ * http://preshing.com/20150316/semaphores-are-surprisingly-versatile/
+ * C++20 std::latch
+ * http://en.cppreference.com/w/cpp/thread/latch
+ */
@@ -0,0 +1,64 @@
+/*
+ * plasma_seqlock - sequence lock for read-mostly snapshots
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define PLASMA_FEATURE_DISABLE_WIN32_FULLHDRS
+#define PLASMA_SEQLOCK_C99INLINE_FUNCS
+
+/* inlined functions defined in header
+ * (generate external linkage definition in GCC versions earlier than GCC 4.3)*/
+#if defined(NO_C99INLINE) \
+ || defined(__clang__) || (defined(__GNUC__) && !defined(__GNUC_STDC_INLINE__))
+#define PLASMA_SEQLOCK_C99INLINE
+#endif
+
+#include "plasma_seqlock.h"
+
+/* inlined functions defined in header
+ * (generate external linkage definition in C99-compliant compilers)
+ * (need to -duplicate- definition from header for non-C99-compliant compilers)
+ */
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__)
+extern inline
+uint32_t
+plasma_seqlock_read_begin (const plasma_seqlock_t * const restrict sl);
+uint32_t
+plasma_seqlock_read_begin (const plasma_seqlock_t * const restrict sl);
+
+extern inline
+bool
+plasma_seqlock_read_retry (const plasma_seqlock_t * const restrict sl,
+                           const uint32_t seq);
+bool
+plasma_seqlock_read_retry (const plasma_seqlock_t * const restrict sl,
+                           const uint32_t seq);
+
+extern inline
+void
+plasma_seqlock_write_begin (plasma_seqlock_t * const restrict sl);
+void
+plasma_seqlock_write_begin (plasma_seqlock_t * const restrict sl);
+
+extern inline
+void
+plasma_seqlock_write_end (plasma_seqlock_t * const restrict sl);
+void
+plasma_seqlock_write_end (plasma_seqlock_t * const restrict sl);
+#endif
@@ -0,0 +1,181 @@
+/*
+ * plasma_seqlock - sequence lock for read-mostly snapshots
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_PLASMA_SEQLOCK_H
+#define INCLUDED_PLASMA_SEQLOCK_H
+
+#include "plasma_feature.h"
+#include "plasma_attr.h"
+#include "plasma_membar.h"
+#include "plasma_atomic.h"
+#include "plasma_spin.h"
+PLASMA_ATTR_Pragma_once
+
+#ifndef PLASMA_SEQLOCK_C99INLINE
+#define PLASMA_SEQLOCK_C99INLINE C99INLINE
+#endif
+#ifndef NO_C99INLINE
+#ifndef PLASMA_SEQLOCK_C99INLINE_FUNCS
+#define PLASMA_SEQLOCK_C99INLINE_FUNCS
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* plasma_seqlock_init()
+ * plasma_seqlock_read_begin()
+ * plasma_seqlock_read_retry()
+ * plasma_seqlock_write_begin()
+ * plasma_seqlock_write_end()
+ *
+ * Sequence lock for small, frequently-updated, read-mostly data, e.g.
+ * timestamps, counters, or configuration snapshots.  Readers perform zero
+ * stores to shared memory: reader loads sequence number, reads the data, and
+ * then retries if sequence number changed or was odd (write in progress).
+ * Writer increments sequence number (to odd) before modifying data, and
+ * increments it again (to even) after modifying data.  Writers are serialized
+ * by an embedded plasma_spin_lock_t.
+ *
+ * Typical usage:
+ *   uint32_t seq;
+ *   do {
+ *       seq = plasma_seqlock_read_begin(&sl);
+ *       ... copy data ...
+ *   } while (plasma_seqlock_read_retry(&sl, seq));
+ *
+ *   plasma_seqlock_write_begin(&sl);
+ *   ... modify data ...
+ *   plasma_seqlock_write_end(&sl);
+ *
+ * NB: readers might observe torn or inconsistent data before retry, so reader
+ * must only copy the data (or otherwise be prepared for inconsistent values),
+ * must not dereference pointers read from protected data, and must not use
+ * the data until plasma_seqlock_read_retry() returns false.  Reads and writes
+ * of protected data should be plasma_atomic_load_explicit() and
+ * plasma_atomic_store_explicit() with memory_order_relaxed (or volatile)
+ * so that compiler does not elide or tear accesses.
+ *
+ * NB: writers spin (do not block) while readers retry; keep write sections
+ * short, and avoid use when writes are frequent relative to reads
+ */
+
+typedef __attribute_aligned__(16)
+struct plasma_seqlock_t {
+    uint32_t seq;
+    uint32_t udata32; /* user data 4-bytes */
+    uint64_t udata64; /* user data 8-bytes */
+    plasma_spin_lock_t wrlock; /* serialize writers */
+} plasma_seqlock_t;
+
+#if (defined(__STDC_VERSION__) && __STDC_VERSION__-0 >= 199901L) /* C99 */
+#define PLASMA_SEQLOCK_INITIALIZER \
+        { .seq = 0, .udata32 = 0, .udata64 = 0, \
+          .wrlock = PLASMA_SPIN_LOCK_INITIALIZER }
+#else
+#define PLASMA_SEQLOCK_INITIALIZER { 0, 0, 0, PLASMA_SPIN_LOCK_INITIALIZER }
+#endif
+#define plasma_seqlock_init(sl) \
+        ((sl)->seq = 0, (sl)->udata32 = 0, (sl)->udata64 = 0, \
+         plasma_spin_lock_init(&(sl)->wrlock))
+
+__attribute_nonnull__()
+PLASMA_SEQLOCK_C99INLINE
+uint32_t
+plasma_seqlock_read_begin (const plasma_seqlock_t * const restrict sl);
+#ifdef PLASMA_SEQLOCK_C99INLINE_FUNCS
+PLASMA_SEQLOCK_C99INLINE
+uint32_t
+plasma_seqlock_read_begin (const plasma_seqlock_t * const restrict sl)
+{
+    uint32_t seq;
+    while ((seq = plasma_atomic_load_explicit(&sl->seq, memory_order_relaxed))
+           & 1u)
+        plasma_spin_pause();  /* write in progress */
+    plasma_membar_ld_acq();   /* order seq load before data loads */
+    return seq;
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_SEQLOCK_C99INLINE
+bool
+plasma_seqlock_read_retry (const plasma_seqlock_t * const restrict sl,
+                           const uint32_t seq);
+#ifdef PLASMA_SEQLOCK_C99INLINE_FUNCS
+PLASMA_SEQLOCK_C99INLINE
+bool
+plasma_seqlock_read_retry (const plasma_seqlock_t * const restrict sl,
+                           const uint32_t seq)
+{
+    plasma_membar_LoadLoad(); /* order data loads before seq load */
+    return (plasma_atomic_load_explicit(&sl->seq, memory_order_relaxed) != seq);
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_SEQLOCK_C99INLINE
+void
+plasma_seqlock_write_begin (plasma_seqlock_t * const restrict sl);
+#ifdef PLASMA_SEQLOCK_C99INLINE_FUNCS
+PLASMA_SEQLOCK_C99INLINE
+void
+plasma_seqlock_write_begin (plasma_seqlock_t * const restrict sl)
+{
+    (void)plasma_spin_lock_acquire(&sl->wrlock);
+    plasma_atomic_store_explicit(&sl->seq, sl->seq + 1u, memory_order_relaxed);
+    plasma_membar_StoreStore(); /* order (odd) seq store before data stores */
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_SEQLOCK_C99INLINE
+void
+plasma_seqlock_write_end (plasma_seqlock_t * const restrict sl);
+#ifdef PLASMA_SEQLOCK_C99INLINE_FUNCS
+PLASMA_SEQLOCK_C99INLINE
+void
+plasma_seqlock_write_end (plasma_seqlock_t * const restrict sl)
+{
+    plasma_membar_st_rel();     /* order data stores before (even) seq store */
+    plasma_atomic_store_explicit(&sl->seq, sl->seq + 1u, memory_order_relaxed);
+    plasma_spin_lock_release(&sl->wrlock);
+}
+#endif
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+
+/* NOTES and REFERENCES
+ *
+ * http://en.wikipedia.org/wiki/Seqlock
+ * http://lwn.net/Articles/22818/
+ * Hans-J. Boehm, "Can Seqlocks Get Along With Programming Language Memory
+ *   Models?", MSPC 2012
+ * http://www.hpl.hp.com/techreports/2012/HPL-2012-68.pdf
+ */
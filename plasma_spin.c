@@ -30,6 +30,11 @@
 #endif
 #endif
 
+/* _GNU_SOURCE for sched_getcpu() (cohort lock) */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #define PLASMA_FEATURE_DISABLE_WIN32_FULLHDRS
 #define PLASMA_SPIN_C99INLINE_FUNCS
 
@@ -41,9 +46,268 @@
 #endif
 
 #include "plasma_spin.h"
+#include "plasma_futex.h"
 #include "plasma_membar.h"
+#include "plasma_once.h"
 #include "plasma_sysconf.h"
 
+#include <stdlib.h>  /* posix_memalign() malloc() free() */
+
+
+/*
+ * monotonic clock
+ */
+
+#if defined(_WIN32)
+#include <windows.h> /* QueryPerformanceCounter() QueryPerformanceFrequency() */
+#else
+#include <time.h>    /* clock_gettime() */
+#endif
+
+uint64_t
+plasma_spin_clock_ns (void)
+{
+  #if defined(_WIN32)
+    /* (GetTickCount64() ticks only every 10-16ms; too coarse for timeouts)
+     * (QueryPerformanceFrequency() is fixed at boot; cache it
+     *  (concurrent first callers store same value)) */
+    static uint64_t qpc_freq;
+    uint64_t freq =
+      plasma_atomic_load_explicit(&qpc_freq, memory_order_relaxed);
+    uint64_t c;
+    LARGE_INTEGER li;
+    if (__builtin_expect( (freq == 0), 0)) {
+        QueryPerformanceFrequency(&li);
+        freq = (uint64_t)li.QuadPart;
+        plasma_atomic_store_explicit(&qpc_freq, freq, memory_order_relaxed);
+    }
+    QueryPerformanceCounter(&li);
+    c = (uint64_t)li.QuadPart;
+    return (c / freq) * 1000000000u + (c % freq) * 1000000000u / freq;
+  #else
+    struct timespec ts;
+    if (0 != clock_gettime(CLOCK_MONOTONIC, &ts))
+        return 0;
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+  #endif
+}
+
+
+/*
+ * calibrated plasma_spin_pause() cost
+ */
+
+#ifdef PLASMA_SPIN_PAUSE_PS
+static uint32_t pause_ps = PLASMA_SPIN_PAUSE_PS;
+#else
+static uint32_t pause_ps; /* (picoseconds per plasma_spin_pause()) */
+static plasma_once_t pause_once = PLASMA_ONCE_INITIALIZER;
+
+__attribute_cold__
+__attribute_noinline__
+static void
+plasma_spin_pause_calibrate (void)
+{
+    /* time bursts of 1024 pauses and keep fastest burst (min elapsed)
+     * (calibration costs a few hundred microseconds on first use) */
+    uint64_t t0, t, min = UINT64_MAX;
+    uint32_t ps;
+    int trial, i;
+    for (trial = 0; trial < 8; ++trial) {
+        t0 = plasma_spin_clock_ns();
+        for (i = 0; i < 1024; i += 8) {
+            plasma_spin_pause();
+            plasma_spin_pause();
+            plasma_spin_pause();
+            plasma_spin_pause();
+            plasma_spin_pause();
+            plasma_spin_pause();
+            plasma_spin_pause();
+            plasma_spin_pause();
+        }
+        t = plasma_spin_clock_ns() - t0;
+        if (min > t)
+            min = t;
+    }
+    /* (coarse clock resolution (or clock failure) results in elapsed 0) */
+    ps = (min != 0 && min < UINT32_MAX / 1000u * 1024u)
+      ? (uint32_t)(min * 1000u / 1024u)
+      : PLASMA_SPIN_PAUSE_PS_DFLT;
+    pause_ps = (ps != 0) ? ps : 1;
+}
+#endif
+
+uint32_t
+plasma_spin_pause_cost_ps (void)
+{
+  #ifndef PLASMA_SPIN_PAUSE_PS
+    plasma_call_once(&pause_once, plasma_spin_pause_calibrate);
+  #endif
+    return pause_ps;
+}
+
+uint32_t
+plasma_spin_budget_ns (const uint64_t ns)
+{
+    const uint64_t n = (ns < UINT64_MAX / 1000u)
+      ? ns * 1000u / plasma_spin_pause_cost_ps()
+      : UINT32_MAX;
+    return (n == 0) ? 1 : (n < UINT32_MAX) ? (uint32_t)n : UINT32_MAX;
+}
+
+void
+plasma_spin_pause_ns (const uint64_t ns)
+{
+    uint32_t n = plasma_spin_budget_ns(ns);
+    do {
+        plasma_spin_pause();
+    } while (--n);
+}
+
+
+/*
+ * lock contention statistics (PLASMA_SPIN_STATS)
+ */
+
+#ifdef PLASMA_SPIN_STATS
+
+#include <string.h>  /* memset() */
+
+/* (spin loops declare PLASMA_SPIN_STATS_DECL and count spins and yields) */
+#define PLASMA_SPIN_STATS_DECL \
+        const uint64_t stats_t0 = plasma_spin_clock_ns(); \
+        uint32_t stats_spins = 0, stats_yields = 0
+#define PLASMA_SPIN_STATS_SPIN()   (++stats_spins)
+#define PLASMA_SPIN_STATS_YIELD()  (++stats_yields)
+#define PLASMA_SPIN_STATS_WAITED(lock) \
+        plasma_spin_stats_acquired((lock),stats_t0,stats_spins,stats_yields)
+
+struct plasma_spin_stats_entry {
+    plasma_spin_stats_t st;
+    uint64_t acquired_ns;  /* time of acquisition by current lock holder */
+};
+
+static struct plasma_spin_stats_entry
+  plasma_spin_stats_table[PLASMA_SPIN_STATS_MAX];
+
+static struct plasma_spin_stats_entry *
+plasma_spin_stats_find (const void * const restrict lock, const bool insert)
+{
+    /* open addressing with linear probing; entries are never removed
+     * (slot claimed with CAS on lock address) */
+    uint32_t i = (uint32_t)(((uintptr_t)lock >> 4) * 2654435761u);
+    uint32_t n;
+    for (n = 0; n < PLASMA_SPIN_STATS_MAX; ++n, ++i) {
+        struct plasma_spin_stats_entry * const e =
+          plasma_spin_stats_table + (i & (PLASMA_SPIN_STATS_MAX-1));
+        const void * const k =
+          plasma_atomic_load_explicit(&e->st.lock, memory_order_acquire);
+        if (k == lock)
+            return e;
+        if (k == NULL) {
+            if (!insert)
+                return NULL;
+            if (plasma_atomic_CAS_ptr((void **)&e->st.lock, NULL,(void *)lock)
+                || plasma_atomic_load_explicit(&e->st.lock,
+                                               memory_order_acquire) == lock)
+                return e;
+        }
+    }
+    return NULL;  /* (table full) */
+}
+
+void
+plasma_spin_stats_acquired (const void * const restrict lock,
+                            const uint64_t t0,
+                            const uint32_t spins, const uint32_t yields)
+{
+    /* (called by lock holder; updates serialized by lock) */
+    struct plasma_spin_stats_entry * const restrict e =
+      plasma_spin_stats_find(lock, true);
+    const uint64_t now = plasma_spin_clock_ns();
+    if (e == NULL)
+        return;
+    ++e->st.acquisitions;
+    if (spins | yields) {
+        const uint64_t wait = now - t0;
+        ++e->st.contended;
+        e->st.spins  += spins;
+        e->st.yields += yields;
+        e->st.wait_ns_total += wait;
+        if (e->st.wait_ns_max < wait)
+            e->st.wait_ns_max = wait;
+    }
+    e->acquired_ns = now;
+}
+
+void
+plasma_spin_stats_released (const void * const restrict lock)
+{
+    /* (called by lock holder; updates serialized by lock) */
+    struct plasma_spin_stats_entry * const restrict e =
+      plasma_spin_stats_find(lock, false);
+    if (e != NULL && e->acquired_ns != 0) {
+        const uint64_t hold = plasma_spin_clock_ns() - e->acquired_ns;
+        e->st.hold_ns_total += hold;
+        if (e->st.hold_ns_max < hold)
+            e->st.hold_ns_max = hold;
+        e->acquired_ns = 0;
+    }
+}
+
+bool
+plasma_spin_stats_get (const void * const restrict lock,
+                       plasma_spin_stats_t * const restrict st)
+{
+    const struct plasma_spin_stats_entry * const restrict e =
+      plasma_spin_stats_find(lock, false);
+    if (e == NULL)
+        return false;
+    *st = e->st;
+    return true;
+}
+
+size_t
+plasma_spin_stats_snapshot (plasma_spin_stats_t * const restrict st,
+                            const size_t n)
+{
+    size_t i, c = 0;
+    for (i = 0; i < PLASMA_SPIN_STATS_MAX && c < n; ++i) {
+        const struct plasma_spin_stats_entry * const restrict e =
+          plasma_spin_stats_table + i;
+        if (NULL != plasma_atomic_load_explicit(&e->st.lock,
+                                                memory_order_acquire))
+            st[c++] = e->st;
+    }
+    return c;
+}
+
+void
+plasma_spin_stats_reset (const void * const restrict lock)
+{
+    size_t i;
+    for (i = 0; i < PLASMA_SPIN_STATS_MAX; ++i) {
+        struct plasma_spin_stats_entry * const restrict e =
+          plasma_spin_stats_table + i;
+        const void * const k =
+          plasma_atomic_load_explicit(&e->st.lock, memory_order_acquire);
+        if (k != NULL && (lock == NULL || lock == k)) {
+            memset(&e->st.acquisitions, 0,
+                   sizeof(e->st) - offsetof(plasma_spin_stats_t,acquisitions));
+            e->acquired_ns = 0;
+        }
+    }
+}
+
+#else
+
+#define PLASMA_SPIN_STATS_DECL          do { } while (0)
+#define PLASMA_SPIN_STATS_SPIN()        do { } while (0)
+#define PLASMA_SPIN_STATS_YIELD()       do { } while (0)
+#define PLASMA_SPIN_STATS_WAITED(lock)  do { } while (0)
+
+#endif
+
 
 /*
  * simple spin lock
@@ -58,16 +322,47 @@
  * performant depending on the platform architecture */
 
 
+/* pause burst is PLASMA_SPIN_BURST_NS, not a fixed count of pauses,
+ * since cost of plasma_spin_pause() varies widely by CPU */
+static uint32_t burst; /* (num pauses in PLASMA_SPIN_BURST_NS) */
+static plasma_once_t burst_once = PLASMA_ONCE_INITIALIZER;
+
+__attribute_cold__
+__attribute_noinline__
+static void
+plasma_spin_pause_burst_init (void)
+{
+    burst = plasma_spin_budget_ns(PLASMA_SPIN_BURST_NS);
+}
+
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__) || defined(__clang__)
+C99INLINE
+#endif
+static void
+plasma_spin_pause_burst (void)
+{
+    uint32_t n;
+    plasma_call_once(&burst_once, plasma_spin_pause_burst_init);
+    n = burst;
+    do {
+        plasma_spin_pause();
+    } while (--n);
+}
+
+
 #ifndef plasma_spin_lock_acquire_spinloop
 bool
 plasma_spin_lock_acquire_spinloop (plasma_spin_lock_t * const spin)
 {
     uint32_t * const lck = &spin->lck;
+    PLASMA_SPIN_STATS_DECL;
     do {
         while (plasma_atomic_load_explicit(lck, memory_order_relaxed)) {
             plasma_spin_pause();
+            PLASMA_SPIN_STATS_SPIN();
         }
     } while (!plasma_atomic_lock_acquire(lck)); /*(includes barrier)*/
+    PLASMA_SPIN_STATS_WAITED(spin);
     return true;
 }
 #endif
@@ -78,44 +373,144 @@ plasma_spin_lock_acquire_spindecay (plasma_spin_lock_t * const spin,
 {
     /* ((uint32_t *) cast also works for Apple OSSpinLock, which is int32_t) */
     uint32_t * const lck = (uint32_t *)&spin->lck;
+    PLASMA_SPIN_STATS_DECL;
     do {
         while (plasma_atomic_load_explicit(lck, memory_order_relaxed)) {
             if (pause1) {
                 --pause1;
                 plasma_spin_pause();
+                PLASMA_SPIN_STATS_SPIN();
             }
             else if (pause32) {
-                int i = 4;
                 --pause32;
-                do {
-                    plasma_spin_pause();
-                    plasma_spin_pause();
-                    plasma_spin_pause();
-                    plasma_spin_pause();
-                    plasma_spin_pause();
-                    plasma_spin_pause();
-                    plasma_spin_pause();
-                    plasma_spin_pause();
-                } while (--i);
+                plasma_spin_pause_burst();
+                PLASMA_SPIN_STATS_SPIN();
             }
             else if (yield) {
                 --yield;
                 plasma_spin_yield();
+                PLASMA_SPIN_STATS_YIELD();
             }
             else
                 return false;
         }
     } while (!plasma_atomic_lock_acquire(lck)); /*(includes barrier)*/
+    PLASMA_SPIN_STATS_WAITED(spin);
+    return true;
+}
+
+
+/*
+ * self-tuning adaptive spin
+ *
+ * Spin budget (max pauses before giving up on spinning) is tracked per lock
+ * in a 32-bit word (udata32) as an exponentially weighted moving average
+ * (1/8 weight for new sample), similar to glibc PTHREAD_MUTEX_ADAPTIVE_NP.
+ * Sample is twice the pauses spun if lock was obtained while spinning, so
+ * budget rises while spins succeed near the end of the budget (short critical
+ * sections) and falls towards what is needed when spins succeed quickly.
+ * Sample is half the budget if spinning failed (lock holder preempted or
+ * critical section long), so budget decays while spinning is fruitless.
+ */
+
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__) || defined(__clang__)
+C99INLINE
+#endif
+static uint32_t
+plasma_spin_adaptive_budget (const uint32_t * const restrict est)
+{
+    const uint32_t budget =
+      plasma_atomic_load_explicit(est, memory_order_relaxed);
+    return budget == 0
+      ? PLASMA_SPIN_ADAPTIVE_INIT
+      : budget < PLASMA_SPIN_ADAPTIVE_MIN
+        ? PLASMA_SPIN_ADAPTIVE_MIN
+        : budget > PLASMA_SPIN_ADAPTIVE_MAX
+          ? PLASMA_SPIN_ADAPTIVE_MAX
+          : budget;
+}
+
+static void
+plasma_spin_adaptive_update (uint32_t * const restrict est,
+                             const uint32_t budget, const uint32_t spins)
+{
+    /* (spins == budget indicates spinning failed to obtain lock) */
+    int32_t sample = (int32_t)(spins < budget ? spins << 1 : budget >> 1);
+    if (sample < PLASMA_SPIN_ADAPTIVE_MIN)
+        sample = PLASMA_SPIN_ADAPTIVE_MIN;
+    else if (sample > PLASMA_SPIN_ADAPTIVE_MAX)
+        sample = PLASMA_SPIN_ADAPTIVE_MAX;
+    /* (racy update by lock holder is benign; estimate is only a hint) */
+    plasma_atomic_store_explicit(est,
+                                 (uint32_t)((int32_t)budget
+                                            + (sample-(int32_t)budget) / 8),
+                                 memory_order_relaxed);
+}
+
+bool
+plasma_spin_lock_acquire_adaptive_spinloop (plasma_spin_lock_t * const spin)
+{
+    /* ((uint32_t *) cast also works for Apple OSSpinLock, which is int32_t) */
+    uint32_t * const lck = (uint32_t *)&spin->lck;
+    const uint32_t budget = plasma_spin_adaptive_budget(&spin->udata32);
+    uint32_t spins = 0;
+    PLASMA_SPIN_STATS_DECL;
+    do {
+        while (plasma_atomic_load_explicit(lck, memory_order_relaxed)) {
+            if (spins < budget) {
+                ++spins;
+                plasma_spin_pause();
+                PLASMA_SPIN_STATS_SPIN();
+            }
+            else {
+                plasma_spin_yield();
+                PLASMA_SPIN_STATS_YIELD();
+            }
+        }
+    } while (!plasma_atomic_lock_acquire(lck)); /*(includes barrier)*/
+    plasma_spin_adaptive_update(&spin->udata32, budget, spins);
+    PLASMA_SPIN_STATS_WAITED(spin);
+    return true;
+}
+
+bool
+plasma_spin_lock_acquire_until (plasma_spin_lock_t * const spin,
+                                const uint64_t deadline)
+{
+    /* ((uint32_t *) cast also works for Apple OSSpinLock, which is int32_t) */
+    uint32_t * const lck = (uint32_t *)&spin->lck;
+    uint32_t n = 0;
+    PLASMA_SPIN_STATS_DECL;
+    if (plasma_spin_lock_acquire_try(spin))
+        return true;
+    do {
+        while (plasma_atomic_load_explicit(lck, memory_order_relaxed)) {
+            if (++n < PLASMA_SPIN_DEADLINE_CHECK) {
+                plasma_spin_pause();
+                PLASMA_SPIN_STATS_SPIN();
+            }
+            else { /* check clock and yield once per
+                    * PLASMA_SPIN_DEADLINE_CHECK pauses */
+                if (plasma_spin_clock_ns() >= deadline)
+                    return false;
+                n = 0;
+                plasma_spin_yield();
+                PLASMA_SPIN_STATS_YIELD();
+            }
+        }
+    } while (!plasma_atomic_lock_acquire(lck)); /*(includes barrier)*/
+    PLASMA_SPIN_STATS_WAITED(spin);
     return true;
 }
 
 
 static uint32_t nshift; /* num bits rotate (shift) for taglock tag batch */
 static uint32_t nprocs; /* num procs */
+static plasma_once_t nprocs_once = PLASMA_ONCE_INITIALIZER;
 
 __attribute_cold__
 __attribute_noinline__
-static int
+static void
 plasma_spin_nprocs_init (void)
 {
     long nprocs_onln = plasma_sysconf_nprocessors_onln();
@@ -129,23 +524,43 @@ plasma_spin_nprocs_init (void)
     while ((nshift_onln >>= 1))
         ++nshift_accum;
     nshift = nshift_accum;  /* power of 2 of available CPUs (0 if only 1 CPU) */
-    plasma_membar_StoreStore();
-    return (nprocs = (uint32_t)nprocs_onln);
+    nprocs = (uint32_t)nprocs_onln;
+    /* (plasma_call_once() publishes nshift and nprocs to all callers) */
+}
 
-    /* store ordering above is not critical; so our readers below do not acquire
-     * If there is a race between threads before nprocs is set, then if a thread
-     * reads nshift = 0, but nprocs != 0, then thread might be slightly slower
-     * acquiring the spin lock the first time.  Not a big deal.  Likewise, it
-     * is not problem if multiple threads run this routine since this routine
-     * stores results atomically (via int-sized natural alignment) to the
-     * static variables and the results of initialization are the same. */
+#define plasma_spin_nprocs_once() \
+        plasma_call_once(&nprocs_once, plasma_spin_nprocs_init)
+
+uint32_t
+plasma_spin_wait_budget_ns (const uint64_t ns)
+{
+    plasma_spin_nprocs_once();
+    return nprocs > 1 ? plasma_spin_budget_ns(ns) : 0;
 }
 
+/* inlined functions defined in header
+ * (generate external linkage definition in C99-compliant compilers)
+ * (need to -duplicate- definition from header for non-C99-compliant compilers)
+ */
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__)
+extern inline
+bool
+plasma_spin_wait_pause (uint32_t * const restrict spins);
+bool
+plasma_spin_wait_pause (uint32_t * const restrict spins);
+
+extern inline
+void
+plasma_spin_wait_yield (uint32_t * const restrict spins);
+void
+plasma_spin_wait_yield (uint32_t * const restrict spins);
+#endif
+
 
 #if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__) || defined(__clang__)
 C99INLINE
 #endif
-static void
+static bool
 plasma_spin_pause_yield_adaptive (const uint32_t distance, const int callcount)
 {
     /* simplistic backoff employing call count and distance to acquire fair lock
@@ -155,18 +570,18 @@ plasma_spin_pause_yield_adaptive (const uint32_t distance, const int callcount)
      *
      * callers must initialize nshift and nprocs prior to calling this routine
      * (initialization avoided here since code might be inlined in tight loop)
-     * (ok if a few threads run the initialization; results will be same)
-     *    if (__builtin_expect( (!nprocs), 0))
-     *        plasma_spin_nprocs_init();
+     *    plasma_spin_nprocs_once();
      *
      * (nshift == 0 for one core; always yield CPU
      *  nshift == 1 for two cores; test distance <= nshift)
      */
     if (callcount < 128 && distance <= nshift) {
         plasma_spin_pause();  /* brief pause if almost our turn */
+        return false;
     }
     else {
         plasma_spin_yield();  /* yield CPU if highly contended */
+        return true;
     }
 }
 
@@ -189,13 +604,111 @@ plasma_spin_tktlock_acquire_spinloop (plasma_spin_tktlock_t *
     uint32_t cmp = PLASMA_SPIN_TKTLOCK_MASK(tkt);
     const uint32_t tktnum = PLASMA_SPIN_TKTLOCK_SHIFT(tkt);
     int callcount = 0;
-    if (__builtin_expect( (!nprocs), 0))
-        plasma_spin_nprocs_init(); /*init plasma_spin_pause_yield_adaptive()*/
+    PLASMA_SPIN_STATS_DECL;
+    plasma_spin_nprocs_once(); /*init plasma_spin_pause_yield_adaptive()*/
     do {
         cmp = tktnum > cmp  /*(reuse cmp to store distance)*/
           ? tktnum - cmp
           : (PLASMA_SPIN_TKTLOCK_TKTMAX + 1 - cmp) + tktnum;
-        plasma_spin_pause_yield_adaptive(cmp, ++callcount);
+        if (plasma_spin_pause_yield_adaptive(cmp, ++callcount))
+            PLASMA_SPIN_STATS_YIELD();
+        else
+            PLASMA_SPIN_STATS_SPIN();
+      #ifndef __ia64__
+        cmp = PLASMA_SPIN_TKTLOCK_MASK(
+                plasma_atomic_load_explicit(&spin->lck.u,memory_order_relaxed));
+      #else  /*(Itanium should emit ld4.acq in atomic load below)*/
+        cmp = PLASMA_SPIN_TKTLOCK_MASK(
+                plasma_atomic_load_explicit(&spin->lck.u,memory_order_acquire));
+      #endif
+    } while (tktnum != cmp);
+  #ifndef __ia64__  /*(Itanium should emit ld4.acq in atomic load above)*/
+    atomic_thread_fence(memory_order_acquire);
+  #endif
+    PLASMA_SPIN_STATS_WAITED(spin);
+    return true;
+}
+
+
+/*
+ * proportional backoff
+ *
+ * Waiter for a fair lock knows its distance from the head of the queue, so it
+ * can estimate how long until its turn: (distance - 1) critical sections.
+ * Waiter pauses for approximately that long before re-reading the lock word,
+ * instead of polling the lock word after each pause, which otherwise pulls the
+ * cache line away from the lock holder for each waiter on each release.
+ * Critical section estimate (in pauses, fixed point PLASMA_SPIN_BACKOFF_SHIFT)
+ * is calibrated by each waiter which did not yield, as total pauses waited
+ * divided by initial distance, and is maintained as exponentially weighted
+ * moving average (1/8 weight for new sample) in a 32-bit word in the lock.
+ * (see bottom of plasma_spin.h for proportional backoff references)
+ */
+
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__) || defined(__clang__)
+C99INLINE
+#endif
+static uint32_t
+plasma_spin_backoff_pause (const uint32_t distance, const uint32_t est)
+{
+    /* (distance > 0 and distance < nprocs; caller yields otherwise)
+     * (64-bit product; est can approach UINT32_MAX after long waits) */
+    const uint64_t p = (uint64_t)(distance - 1)
+                     * (uint64_t)(est >> PLASMA_SPIN_BACKOFF_SHIFT);
+    uint32_t n, i;
+    if (p == 0)
+        n = 1;
+    else if (p > PLASMA_SPIN_BACKOFF_MAX)
+        n = PLASMA_SPIN_BACKOFF_MAX;
+    else
+        n = (uint32_t)p;
+    for (i = 0; i < n; ++i)
+        plasma_spin_pause();
+    return n;
+}
+
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__) || defined(__clang__)
+C99INLINE
+#endif
+static uint32_t
+plasma_spin_backoff_estimate (const uint32_t est, const uint32_t pauses,
+                              const uint32_t distance)
+{
+    /* (guard overflow of fixed point sample from long waits) */
+    const uint32_t sample = pauses < (UINT32_MAX >> PLASMA_SPIN_BACKOFF_SHIFT)
+      ? (pauses << PLASMA_SPIN_BACKOFF_SHIFT) / distance
+      : UINT32_MAX / distance;
+    return est - (est >> 3) + (sample >> 3);
+}
+
+bool
+plasma_spin_tktlock_acquire_spinloop_backoff (plasma_spin_tktlock_t *
+                                                const restrict spin,
+                                                uint32_t tkt)
+{
+    uint32_t cmp = PLASMA_SPIN_TKTLOCK_MASK(tkt);
+    const uint32_t tktnum = PLASMA_SPIN_TKTLOCK_SHIFT(tkt);
+    const uint32_t est =
+      plasma_atomic_load_explicit(&spin->udata32, memory_order_relaxed);
+    uint32_t distance = 0, pauses = 0;
+    bool yielded = false;
+    PLASMA_SPIN_STATS_DECL;
+    plasma_spin_nprocs_once();
+    do {
+        cmp = tktnum > cmp  /*(reuse cmp to store distance)*/
+          ? tktnum - cmp
+          : (PLASMA_SPIN_TKTLOCK_TKTMAX + 1 - cmp) + tktnum;
+        if (distance == 0)
+            distance = cmp;
+        if (cmp < nprocs) {
+            pauses += plasma_spin_backoff_pause(cmp, est);
+            PLASMA_SPIN_STATS_SPIN();
+        }
+        else {
+            plasma_spin_yield();  /*(more waiters than CPUs)*/
+            yielded = true;
+            PLASMA_SPIN_STATS_YIELD();
+        }
       #ifndef __ia64__
         cmp = PLASMA_SPIN_TKTLOCK_MASK(
                 plasma_atomic_load_explicit(&spin->lck.u,memory_order_relaxed));
@@ -207,9 +720,106 @@ plasma_spin_tktlock_acquire_spinloop (plasma_spin_tktlock_t *
   #ifndef __ia64__  /*(Itanium should emit ld4.acq in atomic load above)*/
     atomic_thread_fence(memory_order_acquire);
   #endif
+    /* (lock holder updates estimate; races with other lock holders only in
+     *  that waiters read estimate without lock, so use atomic load/store) */
+    if (!yielded)
+        plasma_atomic_store_explicit(&spin->udata32,
+                                     plasma_spin_backoff_estimate(est, pauses,
+                                                                  distance),
+                                     memory_order_relaxed);
+    PLASMA_SPIN_STATS_WAITED(spin);
+    return true;
+}
+
+__attribute_noinline__
+static bool
+plasma_spin_tktlock_abandon (plasma_spin_tktlock_t * const restrict spin,
+                             const uint32_t tktnum)
+{
+    /* mark ticket abandoned (see plasma_spin_tktlock_release_timed())
+     * (caller must be within 64 tickets of head of queue)
+     * If lock has not (yet) been handed to ticket, then releaser will skip it.
+     * Else waiter and releaser race to clear bit; waiter which clears the bit
+     * owns the lock (and returns true), else releaser has skipped ticket.
+     * (seq_cst to order store to udata64 with load of lck, and vice versa in
+     *  plasma_spin_tktlock_release_timed()) */
+    const uint64_t bit = UINT64_C(1) << (tktnum & 63);
+    plasma_atomic_fetch_or_u64(&spin->udata64, bit, memory_order_seq_cst);
+    if (PLASMA_SPIN_TKTLOCK_MASK(
+          plasma_atomic_load_explicit(&spin->lck.u, memory_order_seq_cst))
+        != tktnum)
+        return false;
+    return (plasma_atomic_fetch_and_u64(&spin->udata64, ~bit,
+                                        memory_order_seq_cst) & bit) != 0;
+}
+
+bool
+plasma_spin_tktlock_acquire_until (plasma_spin_tktlock_t * const restrict spin,
+                                   const uint64_t deadline)
+{
+    const uint32_t tkt =
+      plasma_atomic_fetch_add_u32(&spin->lck.u, PLASMA_SPIN_TKTLOCK_TKTINC,
+                                  memory_order_relaxed);
+    uint32_t cmp = PLASMA_SPIN_TKTLOCK_MASK(tkt);
+    const uint32_t tktnum = PLASMA_SPIN_TKTLOCK_SHIFT(tkt);
+    int callcount = 0, n = 0;
+    bool expired = false;
+    PLASMA_SPIN_STATS_DECL;
+    if (tktnum == cmp) {
+        plasma_membar_atomic_thread_fence_acq_rel();
+        PLASMA_SPIN_STATS_ACQUIRED(spin);
+        return true;
+    }
+    plasma_spin_nprocs_once(); /*init plasma_spin_pause_yield_adaptive()*/
+    do {
+        cmp = tktnum > cmp  /*(reuse cmp to store distance)*/
+          ? tktnum - cmp
+          : (PLASMA_SPIN_TKTLOCK_TKTMAX + 1 - cmp) + tktnum;
+        if (!expired && (++n == PLASMA_SPIN_DEADLINE_CHECK || cmp > nshift)) {
+            n = 0;
+            expired = (plasma_spin_clock_ns() >= deadline);
+        }
+        if (expired && cmp < 64) { /*(distance < 64; see abandon())*/
+            if (!plasma_spin_tktlock_abandon(spin, tktnum))
+                return false;
+            break; /* lock handed to ticket as it was abandoned; lock owned */
+        }
+        if (plasma_spin_pause_yield_adaptive(cmp, ++callcount))
+            PLASMA_SPIN_STATS_YIELD();
+        else
+            PLASMA_SPIN_STATS_SPIN();
+        cmp = PLASMA_SPIN_TKTLOCK_MASK(
+                plasma_atomic_load_explicit(&spin->lck.u,memory_order_relaxed));
+    } while (tktnum != cmp);
+    atomic_thread_fence(memory_order_acquire);
+    PLASMA_SPIN_STATS_WAITED(spin);
     return true;
 }
 
+void
+plasma_spin_tktlock_release_timed (plasma_spin_tktlock_t * const restrict spin)
+{
+    /* increment ticket num ready to be served (see plasma_spin_tktlock_release)
+     * and skip abandoned tickets (see plasma_spin_tktlock_abandon()) */
+    __attribute_may_alias__
+  #if defined(__LITTLE_ENDIAN__)
+    uint16_t * const ptr = &spin->lck.t.le;
+  #elif defined(__BIG_ENDIAN__)
+    uint16_t * const ptr = &spin->lck.t.be;
+  #endif
+    uint16_t n = *ptr;
+    uint64_t bit;
+    PLASMA_SPIN_STATS_RELEASED(spin);
+    do {
+        plasma_atomic_store_explicit(ptr, ++n, memory_order_release);
+        atomic_thread_fence(memory_order_seq_cst);
+        bit = UINT64_C(1) << (n & 63);
+    } while ((plasma_atomic_load_explicit(&spin->udata64, memory_order_relaxed)
+              & bit)
+             && (plasma_atomic_fetch_and_u64(&spin->udata64, ~bit,
+                                             memory_order_seq_cst) & bit));
+}
+
 
 /* inlined functions defined in header
  * (generate external linkage definition in C99-compliant compilers)
@@ -228,6 +838,14 @@ plasma_spin_tktlock_acquire (plasma_spin_tktlock_t * const restrict spin);
 bool
 plasma_spin_tktlock_acquire (plasma_spin_tktlock_t * const restrict spin);
 
+extern inline
+bool
+plasma_spin_tktlock_acquire_backoff (plasma_spin_tktlock_t *
+                                       const restrict spin);
+bool
+plasma_spin_tktlock_acquire_backoff (plasma_spin_tktlock_t *
+                                       const restrict spin);
+
 extern inline
 void
 plasma_spin_tktlock_release (plasma_spin_tktlock_t * const restrict spin);
@@ -237,28 +855,91 @@ plasma_spin_tktlock_release (plasma_spin_tktlock_t * const restrict spin);
 
 
 /*
- * tag lock
+ * ticket lock with 32-bit ticket halves
  */
 
-/* FUTURE: might experiment with having both tag and lck as 16-bit quantities
- * in a single 32-bit word, and using CAS to modify both in a single atomic op.
- * Using CAS does require a read prior to the atomic write, which has its own
- * costs.  Why bother?  Currently plasma_spin_taglock_acquire() is implemented
- * with two atomics, which in the uncontended case is slower than tktlock, which
- * uses a single atomic operation.  (Might also look into cmpxchg8 for 64-bit
- * CAS of both tag and lck.)  Storing tag and lck in 16-bit would limit number
- * of potential simultaneous lock contenders to 32767 (SHRT_MAX) plus one with
- * the lock.  (Traditional ticket lock has limit of 65535 (USHRT_MAX) plus one
- * with the lock.) */
-
-#define PLASMA_SPIN_TAGLOCK_BATCH(x)  ((x)>>nshift)
-
 bool
-plasma_spin_taglock_acquire (plasma_spin_taglock_t * const restrict taglock)
+plasma_spin_tktlock64_acquire_spinloop (plasma_spin_tktlock64_t *
+                                          const restrict spin, uint64_t tkt)
 {
-    if (__builtin_expect( (!nprocs), 0))/*init for PLASMA_SPIN_TAGLOCK_BATCH()*/
-        plasma_spin_nprocs_init(); /*init plasma_spin_pause_yield_adaptive()*/
-
+    /* spin until ticket num ready to be served matches our position in queue
+     * (see plasma_spin_tktlock_acquire_spinloop())
+     * (unsigned 32-bit subtraction yields distance across wraparound) */
+    uint32_t cmp = PLASMA_SPIN_TKTLOCK64_MASK(tkt);
+    const uint32_t tktnum = PLASMA_SPIN_TKTLOCK64_SHIFT(tkt);
+    int callcount = 0;
+    PLASMA_SPIN_STATS_DECL;
+    plasma_spin_nprocs_once(); /*init plasma_spin_pause_yield_adaptive()*/
+    do {
+        if (plasma_spin_pause_yield_adaptive(tktnum - cmp, ++callcount))
+            PLASMA_SPIN_STATS_YIELD();
+        else
+            PLASMA_SPIN_STATS_SPIN();
+      #ifndef __ia64__
+        cmp = PLASMA_SPIN_TKTLOCK64_MASK(
+                plasma_atomic_load_explicit(&spin->lck.u,memory_order_relaxed));
+      #else  /*(Itanium should emit ld8.acq in atomic load below)*/
+        cmp = PLASMA_SPIN_TKTLOCK64_MASK(
+                plasma_atomic_load_explicit(&spin->lck.u,memory_order_acquire));
+      #endif
+    } while (tktnum != cmp);
+  #ifndef __ia64__  /*(Itanium should emit ld8.acq in atomic load above)*/
+    atomic_thread_fence(memory_order_acquire);
+  #endif
+    PLASMA_SPIN_STATS_WAITED(spin);
+    return true;
+}
+
+
+/* inlined functions defined in header
+ * (generate external linkage definition in C99-compliant compilers)
+ * (need to -duplicate- definition from header for non-C99-compliant compilers)
+ */
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__)
+extern inline
+bool
+plasma_spin_tktlock64_is_free (const plasma_spin_tktlock64_t *
+                                 const restrict spin);
+bool
+plasma_spin_tktlock64_is_free (const plasma_spin_tktlock64_t *
+                                 const restrict spin);
+
+extern inline
+bool
+plasma_spin_tktlock64_acquire (plasma_spin_tktlock64_t * const restrict spin);
+bool
+plasma_spin_tktlock64_acquire (plasma_spin_tktlock64_t * const restrict spin);
+
+extern inline
+void
+plasma_spin_tktlock64_release (plasma_spin_tktlock64_t * const restrict spin);
+void
+plasma_spin_tktlock64_release (plasma_spin_tktlock64_t * const restrict spin);
+#endif
+
+
+/*
+ * tag lock
+ */
+
+/* plasma_spin_taglock_acquire() is implemented with two atomics, which in the
+ * uncontended case is slower than tktlock, which uses a single atomic op.
+ * plasma_spin_taglock32 (below) has both tag and lck as 16-bit quantities in a
+ * single 32-bit word, and uses CAS to modify both in a single atomic op when
+ * uncontended.  Using CAS does require a read prior to the atomic write, which
+ * has its own costs.  Storing tag and lck in 16-bit limits number of potential
+ * simultaneous lock contenders to 32767 (SHRT_MAX) plus one with the lock.
+ * (Traditional ticket lock has limit of 65535 (USHRT_MAX) plus one with the
+ *  lock.)  (Might also look into cmpxchg8 for 64-bit CAS of both tag and lck.)
+ */
+
+#define PLASMA_SPIN_TAGLOCK_BATCH(x)  ((x)>>nshift)
+
+bool
+plasma_spin_taglock_acquire (plasma_spin_taglock_t * const restrict taglock)
+{
+    plasma_spin_nprocs_once(); /*init TAGLOCK_BATCH(),pause_yield_adaptive()*/
+
     uint32_t * const restrict lck = (uint32_t *)&taglock->lck;
     const uint32_t tag = PLASMA_SPIN_TAGLOCK_MASK(
                            plasma_atomic_fetch_add_u32(&taglock->tag, 1,
@@ -266,13 +947,17 @@ plasma_spin_taglock_acquire (plasma_spin_taglock_t * const restrict taglock)
     uint32_t cmp = PLASMA_SPIN_TAGLOCK_MASK(*lck);
     const uint32_t batch = PLASMA_SPIN_TAGLOCK_BATCH(tag);
     int callcount = 0;
+    PLASMA_SPIN_STATS_DECL;
 
     /* pause/yield until tag is part of the current batch */
     while (PLASMA_SPIN_TAGLOCK_BATCH(cmp) != batch) {
         cmp = tag > cmp  /*(reuse cmp to store distance)*/
           ? tag - cmp
           : (PLASMA_SPIN_TAGLOCK_TAGMAX + 1 - cmp) + tag;
-        plasma_spin_pause_yield_adaptive(cmp, ++callcount);
+        if (plasma_spin_pause_yield_adaptive(cmp, ++callcount))
+            PLASMA_SPIN_STATS_YIELD();
+        else
+            PLASMA_SPIN_STATS_SPIN();
         cmp = PLASMA_SPIN_TAGLOCK_MASK(
                 plasma_atomic_load_explicit(lck, memory_order_relaxed));
     }
@@ -283,7 +968,7 @@ plasma_spin_taglock_acquire (plasma_spin_taglock_t * const restrict taglock)
     while (PLASMA_SPIN_TAGLOCK_IS_LOCKED(
              plasma_atomic_fetch_or_u32(lck, PLASMA_SPIN_TAGLOCK_ORVAL,
                                         memory_order_relaxed))) {
-        do { plasma_spin_pause();
+        do { plasma_spin_pause(); PLASMA_SPIN_STATS_SPIN();
         } while (PLASMA_SPIN_TAGLOCK_IS_LOCKED(
                    plasma_atomic_load_explicit(lck, memory_order_relaxed)));
     }
@@ -291,11 +976,156 @@ plasma_spin_taglock_acquire (plasma_spin_taglock_t * const restrict taglock)
     while (!plasma_atomic_CAS_32(lck,cmp,PLASMA_SPIN_TAGLOCK_LOCKVAL(cmp))) {
         do {
             plasma_spin_pause();
+            PLASMA_SPIN_STATS_SPIN();
+            cmp = plasma_atomic_load_explicit(lck, memory_order_relaxed);
+        } while (PLASMA_SPIN_TAGLOCK_IS_LOCKED(cmp));
+    }
+  #endif
+    plasma_membar_atomic_thread_fence_acq_rel();
+    PLASMA_SPIN_STATS_WAITED(taglock);
+    return true;
+}
+
+bool
+plasma_spin_taglock_acquire_backoff (plasma_spin_taglock_t *
+                                       const restrict taglock)
+{
+    plasma_spin_nprocs_once(); /*init for PLASMA_SPIN_TAGLOCK_BATCH()*/
+
+    uint32_t * const restrict lck = (uint32_t *)&taglock->lck;
+    const uint32_t tag = PLASMA_SPIN_TAGLOCK_MASK(
+                           plasma_atomic_fetch_add_u32(&taglock->tag, 1,
+                                                       memory_order_relaxed));
+    uint32_t cmp = PLASMA_SPIN_TAGLOCK_MASK(*lck);
+    const uint32_t batch = PLASMA_SPIN_TAGLOCK_BATCH(tag);
+    /* (taglock has no udata32; critical section estimate kept in udata64) */
+    const uint32_t est = (uint32_t)
+      plasma_atomic_load_explicit(&taglock->udata64, memory_order_relaxed);
+    uint32_t distance = 0, pauses = 0;
+    bool yielded = false;
+    PLASMA_SPIN_STATS_DECL;
+
+    /* backoff proportional to distance until tag is part of current batch */
+    while (PLASMA_SPIN_TAGLOCK_BATCH(cmp) != batch) {
+        cmp = tag > cmp  /*(reuse cmp to store distance)*/
+          ? tag - cmp
+          : (PLASMA_SPIN_TAGLOCK_TAGMAX + 1 - cmp) + tag;
+        if (distance == 0)
+            distance = cmp;
+        if (cmp < nprocs) {
+            pauses += plasma_spin_backoff_pause(cmp, est);
+            PLASMA_SPIN_STATS_SPIN();
+        }
+        else {
+            plasma_spin_yield();  /*(more waiters than CPUs)*/
+            yielded = true;
+            PLASMA_SPIN_STATS_YIELD();
+        }
+        cmp = PLASMA_SPIN_TAGLOCK_MASK(
+                plasma_atomic_load_explicit(lck, memory_order_relaxed));
+    }
+
+    /* attempt to obtain lock, or else spin and retry
+     * (see plasma_spin_taglock_acquire()) */
+  #ifdef PLASMA_SPIN_TAGLOCK_VIA_FETCH_OR
+    while (PLASMA_SPIN_TAGLOCK_IS_LOCKED(
+             plasma_atomic_fetch_or_u32(lck, PLASMA_SPIN_TAGLOCK_ORVAL,
+                                        memory_order_relaxed))) {
+        do { plasma_spin_pause(); ++pauses; PLASMA_SPIN_STATS_SPIN();
+        } while (PLASMA_SPIN_TAGLOCK_IS_LOCKED(
+                   plasma_atomic_load_explicit(lck, memory_order_relaxed)));
+    }
+  #else  /* (needs the cmp assignment below for reuse in the CAS) */
+    while (!plasma_atomic_CAS_32(lck,cmp,PLASMA_SPIN_TAGLOCK_LOCKVAL(cmp))) {
+        do {
+            plasma_spin_pause(); ++pauses;
+            PLASMA_SPIN_STATS_SPIN();
             cmp = plasma_atomic_load_explicit(lck, memory_order_relaxed);
         } while (PLASMA_SPIN_TAGLOCK_IS_LOCKED(cmp));
     }
   #endif
     plasma_membar_atomic_thread_fence_acq_rel();
+    if (distance != 0 && !yielded)
+        plasma_atomic_store_explicit(&taglock->udata64, (uint64_t)
+                                     plasma_spin_backoff_estimate(est, pauses,
+                                                                  distance),
+                                     memory_order_relaxed);
+    PLASMA_SPIN_STATS_WAITED(taglock);
+    return true;
+}
+
+bool
+plasma_spin_taglock_acquire_until (plasma_spin_taglock_t *
+                                     const restrict taglock,
+                                   const uint64_t deadline)
+{
+    plasma_spin_nprocs_once(); /*init TAGLOCK_BATCH(),pause_yield_adaptive()*/
+
+    uint32_t * const restrict lck = (uint32_t *)&taglock->lck;
+    const uint32_t rawtag =
+      plasma_atomic_fetch_add_u32(&taglock->tag, 1, memory_order_relaxed);
+    const uint32_t tag = PLASMA_SPIN_TAGLOCK_MASK(rawtag);
+    uint32_t cmp = PLASMA_SPIN_TAGLOCK_MASK(*lck);
+    const uint32_t batch = PLASMA_SPIN_TAGLOCK_BATCH(tag);
+    int callcount = 0, n = 0;
+    bool expired = false;
+    PLASMA_SPIN_STATS_DECL;
+
+    /* pause/yield until tag is part of the current batch
+     * (on expiry, return tag if it is last tag issued, else keep waiting) */
+    while (PLASMA_SPIN_TAGLOCK_BATCH(cmp) != batch) {
+        cmp = tag > cmp  /*(reuse cmp to store distance)*/
+          ? tag - cmp
+          : (PLASMA_SPIN_TAGLOCK_TAGMAX + 1 - cmp) + tag;
+        if (plasma_spin_pause_yield_adaptive(cmp, ++callcount)) {
+            PLASMA_SPIN_STATS_YIELD();
+            n = PLASMA_SPIN_DEADLINE_CHECK - 1; /*(check clock after yield)*/
+        }
+        else
+            PLASMA_SPIN_STATS_SPIN();
+        if (!expired && ++n == PLASMA_SPIN_DEADLINE_CHECK) {
+            n = 0;
+            if ((expired = (plasma_spin_clock_ns() >= deadline))
+                && plasma_atomic_CAS_32(&taglock->tag, rawtag+1, rawtag))
+                return false;
+        }
+        cmp = PLASMA_SPIN_TAGLOCK_MASK(
+                plasma_atomic_load_explicit(lck, memory_order_relaxed));
+    }
+
+    /* attempt to obtain lock, or else spin and retry
+     * (on expiry, count abandoned tag by incrementing lck while lock is free;
+     *  plasma_spin_taglock_release() also increments lck while lock is held) */
+    for (;;) {
+        cmp = plasma_atomic_load_explicit(lck, memory_order_relaxed);
+        if (!PLASMA_SPIN_TAGLOCK_IS_LOCKED(cmp)) {
+            if (expired) {
+                if (plasma_atomic_CAS_32(lck, cmp,
+                                         PLASMA_SPIN_TAGLOCK_MASK(cmp+1)))
+                    return false;
+            }
+          #ifdef PLASMA_SPIN_TAGLOCK_VIA_FETCH_OR
+            else if (!PLASMA_SPIN_TAGLOCK_IS_LOCKED(
+                       plasma_atomic_fetch_or_u32(lck,
+                                                  PLASMA_SPIN_TAGLOCK_ORVAL,
+                                                  memory_order_relaxed)))
+                break;
+          #else
+            else if (plasma_atomic_CAS_32(lck, cmp,
+                                          PLASMA_SPIN_TAGLOCK_LOCKVAL(cmp)))
+                break;
+          #endif
+            continue;
+        }
+        plasma_spin_pause();
+        PLASMA_SPIN_STATS_SPIN();
+        if (!expired && ++n == PLASMA_SPIN_DEADLINE_CHECK) {
+            n = 0;
+            expired = (plasma_spin_clock_ns() >= deadline);
+        }
+    }
+    plasma_membar_atomic_thread_fence_acq_rel();
+    PLASMA_SPIN_STATS_WAITED(taglock);
     return true;
 }
 
@@ -306,10 +1136,11 @@ plasma_spin_taglock_acquire_urgent (plasma_spin_taglock_t *
   #ifdef PLASMA_SPIN_TAGLOCK_VIA_FETCH_OR
     uint32_t * const restrict lck = (uint32_t *)&taglock->lck;
     uint32_t cmp;
+    PLASMA_SPIN_STATS_DECL;
     while (PLASMA_SPIN_TAGLOCK_IS_LOCKED(
              (cmp = plasma_atomic_fetch_or_u32(lck, PLASMA_SPIN_TAGLOCK_ORVAL,
                                                memory_order_relaxed)))) {
-        do { plasma_spin_pause();
+        do { plasma_spin_pause(); PLASMA_SPIN_STATS_SPIN();
         } while (PLASMA_SPIN_TAGLOCK_IS_LOCKED(
                    plasma_atomic_load_explicit(lck, memory_order_relaxed)));
     }
@@ -317,17 +1148,21 @@ plasma_spin_taglock_acquire_urgent (plasma_spin_taglock_t *
      * (therefore decrement lck since taglock_release will increment lck) */
     *lck = PLASMA_SPIN_TAGLOCK_LOCKVAL(cmp-1);
     plasma_membar_atomic_thread_fence_acq_rel();
+    PLASMA_SPIN_STATS_WAITED(taglock);
     return true;
   #else
     uint32_t * const restrict lck = (uint32_t *)&taglock->lck;
     uint32_t cmp = *lck;
+    PLASMA_SPIN_STATS_DECL;
     do {
         while (PLASMA_SPIN_TAGLOCK_IS_LOCKED(cmp)) {
             plasma_spin_pause();
+            PLASMA_SPIN_STATS_SPIN();
             cmp = plasma_atomic_load_explicit(lck, memory_order_relaxed);
         }                                               /*(jump queue:(cmp-1))*/
     } while (!plasma_atomic_CAS_32(lck,cmp,PLASMA_SPIN_TAGLOCK_LOCKVAL(cmp-1)));
     plasma_membar_atomic_thread_fence_acq_rel();
+    PLASMA_SPIN_STATS_WAITED(taglock);
     return true;
   #endif
 }
@@ -352,3 +1187,1285 @@ plasma_spin_taglock_release (plasma_spin_taglock_t * const restrict taglock);
 void
 plasma_spin_taglock_release (plasma_spin_taglock_t * const restrict taglock);
 #endif
+
+
+/*
+ * tag lock in single 32-bit word
+ */
+
+bool
+plasma_spin_taglock32_acquire_spinloop (plasma_spin_taglock32_t *
+                                          const restrict taglock)
+{
+    plasma_spin_nprocs_once(); /*init TAGLOCK_BATCH(),pause_yield_adaptive()*/
+
+    uint32_t * const restrict lck = &taglock->lck.u;
+    uint32_t cmp = plasma_atomic_fetch_add_u32(lck,PLASMA_SPIN_TAGLOCK32_TAGINC,
+                                               memory_order_relaxed);
+    const uint32_t tag = PLASMA_SPIN_TAGLOCK32_TAG(cmp);
+    const uint32_t batch = PLASMA_SPIN_TAGLOCK_BATCH(tag);
+    int callcount = 0;
+    PLASMA_SPIN_STATS_DECL;
+
+    /* pause/yield until tag is part of the current batch
+     * (see plasma_spin_taglock_acquire()) */
+    cmp = PLASMA_SPIN_TAGLOCK32_LCK(cmp);
+    while (PLASMA_SPIN_TAGLOCK_BATCH(cmp) != batch) {
+        if (plasma_spin_pause_yield_adaptive(
+              PLASMA_SPIN_TAGLOCK32_LCK(tag - cmp), ++callcount))
+            PLASMA_SPIN_STATS_YIELD();
+        else
+            PLASMA_SPIN_STATS_SPIN();
+        cmp = PLASMA_SPIN_TAGLOCK32_LCK(
+                plasma_atomic_load_explicit(lck, memory_order_relaxed));
+    }
+
+    /* attempt to obtain lock, or else spin and retry
+     * (CAS might also fail due to tag increment by arriving contenders) */
+  #ifdef PLASMA_SPIN_TAGLOCK_VIA_FETCH_OR
+    while (PLASMA_SPIN_TAGLOCK32_IS_LOCKED(
+             plasma_atomic_fetch_or_u32(lck, PLASMA_SPIN_TAGLOCK32_ORVAL,
+                                        memory_order_relaxed))) {
+        do { plasma_spin_pause(); PLASMA_SPIN_STATS_SPIN();
+        } while (PLASMA_SPIN_TAGLOCK32_IS_LOCKED(
+                   plasma_atomic_load_explicit(lck, memory_order_relaxed)));
+    }
+  #else
+    do {
+        cmp = plasma_atomic_load_explicit(lck, memory_order_relaxed);
+        while (PLASMA_SPIN_TAGLOCK32_IS_LOCKED(cmp)) {
+            plasma_spin_pause();
+            PLASMA_SPIN_STATS_SPIN();
+            cmp = plasma_atomic_load_explicit(lck, memory_order_relaxed);
+        }
+    } while (!plasma_atomic_CAS_32(lck, cmp, cmp|PLASMA_SPIN_TAGLOCK32_ORVAL));
+  #endif
+    plasma_membar_atomic_thread_fence_acq_rel();
+    PLASMA_SPIN_STATS_WAITED(taglock);
+    return true;
+}
+
+bool
+plasma_spin_taglock32_acquire_urgent (plasma_spin_taglock32_t *
+                                        const restrict taglock)
+{
+    /* jump queue by locking without incrementing tag
+     * (therefore decrement lck since taglock32_release will increment lck) */
+    uint32_t * const restrict lck = &taglock->lck.u;
+    uint32_t cmp;
+    PLASMA_SPIN_STATS_DECL;
+    do {
+        cmp = plasma_atomic_load_explicit(lck, memory_order_relaxed);
+        while (PLASMA_SPIN_TAGLOCK32_IS_LOCKED(cmp)) {
+            plasma_spin_pause();
+            PLASMA_SPIN_STATS_SPIN();
+            cmp = plasma_atomic_load_explicit(lck, memory_order_relaxed);
+        }
+    } while (!plasma_atomic_CAS_32(lck, cmp,
+                                   (cmp & ~0xFFFFu)
+                                   | PLASMA_SPIN_TAGLOCK32_ORVAL
+                                   | PLASMA_SPIN_TAGLOCK32_LCK(cmp-1)));
+    plasma_membar_atomic_thread_fence_acq_rel();
+    PLASMA_SPIN_STATS_WAITED(taglock);
+    return true;
+}
+
+
+/* inlined functions defined in header
+ * (generate external linkage definition in C99-compliant compilers)
+ * (need to -duplicate- definition from header for non-C99-compliant compilers)
+ */
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__)
+extern inline
+bool
+plasma_spin_taglock32_acquire_try (plasma_spin_taglock32_t *
+                                     const restrict taglock);
+bool
+plasma_spin_taglock32_acquire_try (plasma_spin_taglock32_t *
+                                     const restrict taglock);
+
+extern inline
+bool
+plasma_spin_taglock32_acquire (plasma_spin_taglock32_t *
+                                 const restrict taglock);
+bool
+plasma_spin_taglock32_acquire (plasma_spin_taglock32_t *
+                                 const restrict taglock);
+
+extern inline
+void
+plasma_spin_taglock32_release (plasma_spin_taglock32_t *
+                                 const restrict taglock);
+void
+plasma_spin_taglock32_release (plasma_spin_taglock32_t *
+                                 const restrict taglock);
+#endif
+
+
+/* park thread while *addr == val (see plasma_futex.h)
+ * (spurious wakeups permitted; callers re-check lock word after waking) */
+#define plasma_spin_futex_wait(addr, val) \
+        (void)plasma_futex_wait((addr), (val), PLASMA_FUTEX_INFINITE)
+
+
+/*
+ * MCS queue lock
+ */
+
+bool
+plasma_spin_mcslock_acquire_spinloop (plasma_spin_mcslock_node_t *
+                                        const restrict node,
+                                      plasma_spin_mcslock_node_t *
+                                        const restrict prev)
+{
+    /* link into queue behind predecessor, then spin on lck in our own node
+     * for up to PLASMA_SPIN_MCSLOCK_SPIN_NS, and then mark node parked and
+     * park until predecessor hands off lock (no spin if single CPU) */
+    uint32_t * const lck = &node->lck;
+    uint32_t spins = plasma_spin_wait_budget_ns(PLASMA_SPIN_MCSLOCK_SPIN_NS);
+    uint32_t v;
+    plasma_atomic_store_explicit(&prev->next, node, memory_order_release);
+    while ((v = plasma_atomic_load_explicit(lck, memory_order_relaxed))) {
+        if (!plasma_spin_wait_pause(&spins)
+            && (v == PLASMA_SPIN_MCSLOCK_PARKED
+                || plasma_atomic_CAS_32(lck, PLASMA_SPIN_MCSLOCK_WAITING,
+                                             PLASMA_SPIN_MCSLOCK_PARKED)))
+            plasma_spin_futex_wait(lck, PLASMA_SPIN_MCSLOCK_PARKED);
+    }
+    atomic_thread_fence(memory_order_acquire);
+    return true;
+}
+
+void
+plasma_spin_mcslock_wake (plasma_spin_mcslock_node_t * const restrict node)
+{
+    /* (successor might already have returned after observing handoff, so
+     *  node memory might be reused; futex wake does not dereference addr,
+     *  and other waiters on a reused addr tolerate a spurious wakeup) */
+    plasma_futex_wake_one(&node->lck);
+}
+
+plasma_spin_mcslock_node_t *
+plasma_spin_mcslock_release_spinloop (plasma_spin_mcslock_node_t *
+                                        const restrict node)
+{
+    /* successor has swapped lock tail and is about to link into node->next
+     * (brief window; successor is running, so pause instead of yield) */
+    plasma_spin_mcslock_node_t *next;
+    while ((next = plasma_atomic_load_explicit(&node->next,
+                                               memory_order_acquire)) == NULL)
+        plasma_spin_pause();
+    return next;
+}
+
+
+/* inlined functions defined in header
+ * (generate external linkage definition in C99-compliant compilers)
+ * (need to -duplicate- definition from header for non-C99-compliant compilers)
+ */
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__)
+extern inline
+bool
+plasma_spin_mcslock_acquire (plasma_spin_mcslock_t * const restrict mcs,
+                             plasma_spin_mcslock_node_t * const restrict node);
+bool
+plasma_spin_mcslock_acquire (plasma_spin_mcslock_t * const restrict mcs,
+                             plasma_spin_mcslock_node_t * const restrict node);
+
+extern inline
+bool
+plasma_spin_mcslock_acquire_try (plasma_spin_mcslock_t * const restrict mcs,
+                                 plasma_spin_mcslock_node_t *
+                                   const restrict node);
+bool
+plasma_spin_mcslock_acquire_try (plasma_spin_mcslock_t * const restrict mcs,
+                                 plasma_spin_mcslock_node_t *
+                                   const restrict node);
+
+extern inline
+void
+plasma_spin_mcslock_release (plasma_spin_mcslock_t * const restrict mcs,
+                             plasma_spin_mcslock_node_t * const restrict node);
+void
+plasma_spin_mcslock_release (plasma_spin_mcslock_t * const restrict mcs,
+                             plasma_spin_mcslock_node_t * const restrict node);
+#endif
+
+
+/*
+ * CLH queue lock
+ */
+
+/* thread-local storage for free list of CLH lock nodes */
+#if defined(_MSC_VER)
+#define PLASMA_SPIN_THREAD_LOCAL __declspec(thread)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__-0 >= 201112L /* C11 */
+#define PLASMA_SPIN_THREAD_LOCAL _Thread_local
+#else
+#define PLASMA_SPIN_THREAD_LOCAL __thread
+#endif
+
+/* (node padded to separate cache line so that spinning on predecessor node
+ *  does not share cache line with other nodes) */
+#define PLASMA_SPIN_CLHLOCK_NODE_ALIGN 64
+
+/* node->lck: 0 released, 1 locked, 2 locked and successor (possibly) parked
+ * (plasma_spin_clhlock; plasma_spin_clhtolock uses node->pred instead) */
+#define PLASMA_SPIN_CLHLOCK_LOCKED  1u
+#define PLASMA_SPIN_CLHLOCK_PARKED  2u
+
+struct plasma_spin_clhlock_node_t {
+    uint32_t lck;
+    struct plasma_spin_clhlock_node_t *next;   /* free list link */
+    struct plasma_spin_clhlock_node_t *pred;   /* (plasma_spin_clhtolock) */
+    char pad[PLASMA_SPIN_CLHLOCK_NODE_ALIGN
+             - sizeof(uint32_t) - 2*sizeof(void*)];
+};
+
+static PLASMA_SPIN_THREAD_LOCAL
+struct plasma_spin_clhlock_node_t *plasma_spin_clhlock_freelist;
+
+#ifdef PLASMA_FEATURE_POSIX
+
+#include <pthread.h>
+
+static pthread_key_t  plasma_spin_clhlock_key;
+static plasma_once_t  plasma_spin_clhlock_once = PLASMA_ONCE_INITIALIZER;
+
+static void
+plasma_spin_clhlock_thread_exit (void *arg __attribute_unused__)
+{
+    /* free nodes owned by exiting thread (nodes on free list are referenced
+     * only by this thread; nodes in lock queues are owned by other threads) */
+    struct plasma_spin_clhlock_node_t *node;
+    while ((node = plasma_spin_clhlock_freelist) != NULL) {
+        plasma_spin_clhlock_freelist = node->next;
+        free(node);
+    }
+}
+
+static void
+plasma_spin_clhlock_key_init (void)
+{
+    (void)pthread_key_create(&plasma_spin_clhlock_key,
+                             plasma_spin_clhlock_thread_exit);
+}
+
+#endif
+
+__attribute_cold__
+__attribute_noinline__
+static struct plasma_spin_clhlock_node_t *
+plasma_spin_clhlock_node_alloc (void)
+{
+    void *node;
+  #ifdef PLASMA_FEATURE_POSIX
+    /*(cold path; call slow path directly instead of inline plasma_call_once)*/
+    if (!plasma_once_is_done(&plasma_spin_clhlock_once))
+        plasma_call_once_slow(&plasma_spin_clhlock_once,
+                              plasma_spin_clhlock_key_init);
+    (void)pthread_setspecific(plasma_spin_clhlock_key, (void *)1);
+    if (0 != posix_memalign(&node, PLASMA_SPIN_CLHLOCK_NODE_ALIGN,
+                            sizeof(struct plasma_spin_clhlock_node_t)))
+        node = NULL;
+  #else
+    node = malloc(sizeof(struct plasma_spin_clhlock_node_t));
+  #endif
+    return (struct plasma_spin_clhlock_node_t *)node;
+}
+
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__) || defined(__clang__)
+C99INLINE
+#endif
+static struct plasma_spin_clhlock_node_t *
+plasma_spin_clhlock_node_get (void)
+{
+    struct plasma_spin_clhlock_node_t * const node =
+      plasma_spin_clhlock_freelist;
+    if (__builtin_expect( (node != NULL), 1)) {
+        plasma_spin_clhlock_freelist = node->next;
+        return node;
+    }
+    return plasma_spin_clhlock_node_alloc();
+}
+
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__) || defined(__clang__)
+C99INLINE
+#endif
+static void
+plasma_spin_clhlock_node_put (struct plasma_spin_clhlock_node_t * const node)
+{
+    node->next = plasma_spin_clhlock_freelist;
+    plasma_spin_clhlock_freelist = node;
+}
+
+bool
+plasma_spin_clhlock_acquire (plasma_spin_clhlock_t * const restrict clh)
+{
+    struct plasma_spin_clhlock_node_t * const node =
+      plasma_spin_clhlock_node_get();
+    struct plasma_spin_clhlock_node_t *prev;
+    if (__builtin_expect( (node == NULL), 0))
+        return false;
+    node->lck = PLASMA_SPIN_CLHLOCK_LOCKED;
+    /*(atomic exchange publishes node initialization above)*/
+    prev = (struct plasma_spin_clhlock_node_t *)
+      plasma_atomic_exchange_n_ptr((void **)&clh->tail, (void *)node,
+                                   memory_order_acq_rel);
+    if (prev != NULL) {
+        /* spin on predecessor node for up to PLASMA_SPIN_CLHLOCK_SPIN_NS, and
+         * then mark predecessor node parked and park until predecessor
+         * releases lock (no spin if single CPU); then take ownership of
+         * predecessor node (this thread is only waiter on predecessor node) */
+        uint32_t * const lck = &prev->lck;
+        uint32_t spins =
+          plasma_spin_wait_budget_ns(PLASMA_SPIN_CLHLOCK_SPIN_NS);
+        uint32_t v;
+        while ((v = plasma_atomic_load_explicit(lck, memory_order_relaxed))) {
+            if (!plasma_spin_wait_pause(&spins)
+                && (v == PLASMA_SPIN_CLHLOCK_PARKED
+                    || plasma_atomic_CAS_32(lck, PLASMA_SPIN_CLHLOCK_LOCKED,
+                                                 PLASMA_SPIN_CLHLOCK_PARKED)))
+                plasma_spin_futex_wait(lck, PLASMA_SPIN_CLHLOCK_PARKED);
+        }
+        atomic_thread_fence(memory_order_acquire);
+        plasma_spin_clhlock_node_put(prev);
+    }
+    clh->node = node;
+    return true;
+}
+
+bool
+plasma_spin_clhlock_acquire_try (plasma_spin_clhlock_t * const restrict clh)
+{
+    struct plasma_spin_clhlock_node_t *node;
+    if (plasma_atomic_load_explicit(&clh->tail, memory_order_relaxed) != NULL)
+        return false;
+    node = plasma_spin_clhlock_node_get();
+    if (__builtin_expect( (node == NULL), 0))
+        return false;
+    node->lck = PLASMA_SPIN_CLHLOCK_LOCKED;
+    if (plasma_atomic_CAS_ptr((void **)&clh->tail, NULL, node)) {
+        plasma_membar_atomic_thread_fence_acq_rel();
+        clh->node = node;
+        return true;
+    }
+    plasma_spin_clhlock_node_put(node);
+    return false;
+}
+
+void
+plasma_spin_clhlock_release (plasma_spin_clhlock_t * const restrict clh)
+{
+    struct plasma_spin_clhlock_node_t * const node = clh->node;
+    /* no successor; swing tail back to empty and reclaim node */
+    atomic_thread_fence(memory_order_release);
+    if (plasma_atomic_CAS_ptr((void **)&clh->tail, node, NULL)) {
+        plasma_spin_clhlock_node_put(node);
+        return;
+    }
+    /* hand off lock (and ownership of node) to successor; system call to
+     * wake successor only if it parked
+     * (successor might already have returned after observing handoff and
+     *  reused node; see plasma_spin_mcslock_wake()) */
+    if (__builtin_expect(
+          (plasma_atomic_exchange_n_32(&node->lck, 0u, memory_order_release)
+           == PLASMA_SPIN_CLHLOCK_PARKED), 0))
+        plasma_futex_wake_one(&node->lck);
+}
+
+
+/*
+ * abortable CLH queue lock (with timeout)
+ */
+
+/* (sentinel: node->pred of released node; address is never a node in queue) */
+static struct plasma_spin_clhlock_node_t plasma_spin_clhtolock_available_node;
+#define PLASMA_SPIN_CLHTOLOCK_AVAILABLE (&plasma_spin_clhtolock_available_node)
+
+bool
+plasma_spin_clhtolock_acquire_until (plasma_spin_clhtolock_t *
+                                       const restrict clh,
+                                     const uint64_t deadline)
+{
+    struct plasma_spin_clhlock_node_t * const node =
+      plasma_spin_clhlock_node_get();
+    struct plasma_spin_clhlock_node_t *pred, *p;
+    int callcount = 0, n = 0;
+    if (__builtin_expect( (node == NULL), 0))
+        return false;
+    node->pred = NULL;
+    /*(atomic exchange publishes node initialization above)*/
+    pred = (struct plasma_spin_clhlock_node_t *)
+      plasma_atomic_exchange_n_ptr((void **)&clh->tail, (void *)node,
+                                   memory_order_acq_rel);
+    if (pred != NULL) {
+        plasma_spin_nprocs_once(); /*init plasma_spin_pause_yield_adaptive*/
+        for (;;) {
+            p = plasma_atomic_load_explicit(&pred->pred, memory_order_relaxed);
+            if (p == PLASMA_SPIN_CLHTOLOCK_AVAILABLE)
+                break;
+            if (p != NULL) {
+                /* predecessor aborted; reclaim its node (this thread is only
+                 * thread referencing it) and spin on node to which it points */
+                atomic_thread_fence(memory_order_acquire);
+                plasma_spin_clhlock_node_put(pred);
+                pred = p;
+                continue;
+            }
+            if (deadline != 0) {  /*(deadline 0: acquire_try; do not wait)*/
+                if (plasma_spin_pause_yield_adaptive(1u, ++callcount))
+                    /*(check clock after yield)*/
+                    n = PLASMA_SPIN_DEADLINE_CHECK - 1;
+                if (++n != PLASMA_SPIN_DEADLINE_CHECK)
+                    continue;
+                n = 0;
+                if (plasma_spin_clock_ns() < deadline)
+                    continue;
+            }
+            /* abort: if last in queue, swing tail back to predecessor and
+             * reclaim node; else point node to predecessor and successor
+             * will skip node and reclaim it
+             * (must not access pred after swinging tail; predecessor
+             *  reclaims its node upon release if still at tail, else next
+             *  contender reclaims it) */
+            if (plasma_atomic_CAS_ptr((void **)&clh->tail, node, pred))
+                plasma_spin_clhlock_node_put(node);
+            else
+                plasma_atomic_store_explicit(&node->pred, pred,
+                                             memory_order_release);
+            return false;
+        }
+        /* take ownership of predecessor node (released by lock holder) */
+        atomic_thread_fence(memory_order_acquire);
+        plasma_spin_clhlock_node_put(pred);
+    }
+    clh->node = node;
+    return true;
+}
+
+void
+plasma_spin_clhtolock_release (plasma_spin_clhtolock_t * const restrict clh)
+{
+    struct plasma_spin_clhlock_node_t * const node = clh->node;
+    /* no successor; swing tail back to empty and reclaim node */
+    atomic_thread_fence(memory_order_release);
+    if (plasma_atomic_CAS_ptr((void **)&clh->tail, node, NULL)) {
+        plasma_spin_clhlock_node_put(node);
+        return;
+    }
+    /* hand off lock (and ownership of node) to successor
+     * (or to successor of successor, if successor aborts) */
+    plasma_atomic_store_explicit(&node->pred, PLASMA_SPIN_CLHTOLOCK_AVAILABLE,
+                                 memory_order_release);
+}
+
+
+/*
+ * spin-then-park hybrid lock
+ */
+
+bool
+plasma_spin_futexlock_acquire_spinloop (plasma_spin_futexlock_t *
+                                          const restrict spin)
+{
+    uint32_t * const lck = &spin->lck;
+    int pause1  = PLASMA_SPIN_FUTEXLOCK_PAUSE1;
+    int pause32 = PLASMA_SPIN_FUTEXLOCK_PAUSE32;
+
+    /* spin briefly; lock holder is likely running and might release soon */
+    do {
+        if (pause1) {
+            --pause1;
+            plasma_spin_pause();
+        }
+        else {
+            --pause32;
+            plasma_spin_pause_burst();
+        }
+        if (plasma_atomic_load_explicit(lck, memory_order_relaxed)
+              == PLASMA_SPIN_FUTEXLOCK_UNLOCKED
+            && plasma_atomic_CAS_32(lck, PLASMA_SPIN_FUTEXLOCK_UNLOCKED,
+                                         PLASMA_SPIN_FUTEXLOCK_LOCKED)) {
+            plasma_membar_atomic_thread_fence_acq_rel();
+            return true;
+        }
+    } while (pause1 || pause32);
+
+    /* mark lock contended and park until woken
+     * (lock obtained if exchange returns unlocked; lock word is then left
+     *  marked contended, which might result in one unnecessary wake, but
+     *  which preserves the wakeup for any other parked waiters) */
+    while (plasma_atomic_exchange_n_32(lck, PLASMA_SPIN_FUTEXLOCK_WAITERS,
+                                       memory_order_acquire)
+           != PLASMA_SPIN_FUTEXLOCK_UNLOCKED)
+        plasma_spin_futex_wait(lck, PLASMA_SPIN_FUTEXLOCK_WAITERS);
+    return true;
+}
+
+bool
+plasma_spin_futexlock_acquire_adaptive (plasma_spin_futexlock_t *
+                                          const restrict spin)
+{
+    uint32_t * const lck = &spin->lck;
+    uint32_t budget, spins;
+
+    if (plasma_spin_futexlock_acquire_try(spin))
+        return true;
+
+    /* spin for self-tuned budget (see plasma_spin_lock_acquire_adaptive()) */
+    budget = plasma_spin_adaptive_budget(&spin->udata32);
+    for (spins = 0; spins < budget; ++spins) {
+        plasma_spin_pause();
+        if (plasma_atomic_load_explicit(lck, memory_order_relaxed)
+              == PLASMA_SPIN_FUTEXLOCK_UNLOCKED
+            && plasma_atomic_CAS_32(lck, PLASMA_SPIN_FUTEXLOCK_UNLOCKED,
+                                         PLASMA_SPIN_FUTEXLOCK_LOCKED)) {
+            plasma_membar_atomic_thread_fence_acq_rel();
+            plasma_spin_adaptive_update(&spin->udata32, budget, spins);
+            return true;
+        }
+    }
+
+    /* park until woken (see plasma_spin_futexlock_acquire_spinloop()) */
+    while (plasma_atomic_exchange_n_32(lck, PLASMA_SPIN_FUTEXLOCK_WAITERS,
+                                       memory_order_acquire)
+           != PLASMA_SPIN_FUTEXLOCK_UNLOCKED)
+        plasma_spin_futex_wait(lck, PLASMA_SPIN_FUTEXLOCK_WAITERS);
+    plasma_spin_adaptive_update(&spin->udata32, budget, spins);
+    return true;
+}
+
+void
+plasma_spin_futexlock_wake (plasma_spin_futexlock_t * const restrict spin)
+{
+    plasma_futex_wake_one(&spin->lck);
+}
+
+
+/* inlined functions defined in header
+ * (generate external linkage definition in C99-compliant compilers)
+ * (need to -duplicate- definition from header for non-C99-compliant compilers)
+ */
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__)
+extern inline
+bool
+plasma_spin_futexlock_acquire_try (plasma_spin_futexlock_t *
+                                     const restrict spin);
+bool
+plasma_spin_futexlock_acquire_try (plasma_spin_futexlock_t *
+                                     const restrict spin);
+
+extern inline
+bool
+plasma_spin_futexlock_acquire (plasma_spin_futexlock_t * const restrict spin);
+bool
+plasma_spin_futexlock_acquire (plasma_spin_futexlock_t * const restrict spin);
+
+extern inline
+void
+plasma_spin_futexlock_release (plasma_spin_futexlock_t * const restrict spin);
+void
+plasma_spin_futexlock_release (plasma_spin_futexlock_t * const restrict spin);
+#endif
+
+
+/*
+ * reader-writer lock
+ */
+
+#define plasma_spin_rwlock_wtkt_is_free(tkt) \
+        (PLASMA_SPIN_TKTLOCK_SHIFT(tkt) == PLASMA_SPIN_TKTLOCK_MASK(tkt))
+
+static void
+plasma_spin_rwlock_wtkt_spinloop (plasma_spin_rwlock_t * const restrict rw,
+                                  uint32_t tkt)
+{
+    /* spin until writer ticket num ready to be served matches our ticket
+     * (see plasma_spin_tktlock_acquire_spinloop()) */
+    uint32_t cmp = PLASMA_SPIN_TKTLOCK_MASK(tkt);
+    const uint32_t tktnum = PLASMA_SPIN_TKTLOCK_SHIFT(tkt);
+    int callcount = 0;
+    do {
+        cmp = tktnum > cmp  /*(reuse cmp to store distance)*/
+          ? tktnum - cmp
+          : (PLASMA_SPIN_TKTLOCK_TKTMAX + 1 - cmp) + tktnum;
+        plasma_spin_pause_yield_adaptive(cmp, ++callcount);
+        cmp = PLASMA_SPIN_TKTLOCK_MASK(
+                plasma_atomic_load_explicit(&rw->wtkt.u,memory_order_relaxed));
+    } while (tktnum != cmp);
+}
+
+bool
+plasma_spin_rwlock_rdlock (plasma_spin_rwlock_t * const restrict rw)
+{
+    int callcount = 0;
+    if (rw->mode == PLASMA_SPIN_RWLOCK_PHASEFAIR) {
+        /* announce reader; if writer present, wait for writer phase to end
+         * (writer present bit cleared, or phase id toggled by next writer) */
+        const uint32_t w = PLASMA_SPIN_RWLOCK_WBITS
+                         & plasma_atomic_fetch_add_u32(&rw->rin,
+                                                       PLASMA_SPIN_RWLOCK_RINC,
+                                                       memory_order_relaxed);
+        if (w & PLASMA_SPIN_RWLOCK_PRES) {
+            plasma_spin_nprocs_once();
+            while (w == (PLASMA_SPIN_RWLOCK_WBITS
+                         & plasma_atomic_load_explicit(&rw->rin,
+                                                       memory_order_relaxed)))
+                plasma_spin_pause_yield_adaptive(1u, ++callcount);
+        }
+    }
+    else {
+        /* announce reader, then check for writers holding or waiting;
+         * (seq_cst pairs with writer ticket fetch_add and loads in wrlock)
+         * back off (depart) and wait while writers are pending */
+        for (;;) {
+            plasma_atomic_fetch_add_u32(&rw->rin, PLASMA_SPIN_RWLOCK_RINC,
+                                        memory_order_seq_cst);
+            if (plasma_spin_rwlock_wtkt_is_free(
+                  plasma_atomic_load_explicit(&rw->wtkt.u,
+                                              memory_order_seq_cst)))
+                break;
+            plasma_atomic_fetch_add_u32(&rw->rout, PLASMA_SPIN_RWLOCK_RINC,
+                                        memory_order_relaxed);
+            plasma_spin_nprocs_once();
+            do {
+                plasma_spin_pause_yield_adaptive(1u, ++callcount);
+            } while (!plasma_spin_rwlock_wtkt_is_free(
+                        plasma_atomic_load_explicit(&rw->wtkt.u,
+                                                    memory_order_relaxed)));
+        }
+    }
+    atomic_thread_fence(memory_order_acquire);
+    return true;
+}
+
+bool
+plasma_spin_rwlock_tryrdlock (plasma_spin_rwlock_t * const restrict rw)
+{
+    if (rw->mode == PLASMA_SPIN_RWLOCK_PHASEFAIR) {
+        /* (CAS instead of fetch_add; arrival must not be undone in PF mode) */
+        const uint32_t cmp =
+          plasma_atomic_load_explicit(&rw->rin, memory_order_relaxed);
+        if ((cmp & PLASMA_SPIN_RWLOCK_PRES)
+            || !plasma_atomic_CAS_32(&rw->rin, cmp,
+                                     cmp + PLASMA_SPIN_RWLOCK_RINC))
+            return false;
+        plasma_membar_atomic_thread_fence_acq_rel();
+        return true;
+    }
+    else {
+        if (!plasma_spin_rwlock_wtkt_is_free(
+              plasma_atomic_load_explicit(&rw->wtkt.u, memory_order_relaxed)))
+            return false;
+        plasma_atomic_fetch_add_u32(&rw->rin, PLASMA_SPIN_RWLOCK_RINC,
+                                    memory_order_seq_cst);
+        if (plasma_spin_rwlock_wtkt_is_free(
+              plasma_atomic_load_explicit(&rw->wtkt.u, memory_order_seq_cst))) {
+            atomic_thread_fence(memory_order_acquire);
+            return true;
+        }
+        plasma_atomic_fetch_add_u32(&rw->rout, PLASMA_SPIN_RWLOCK_RINC,
+                                    memory_order_relaxed);
+        return false;
+    }
+}
+
+bool
+plasma_spin_rwlock_wrlock (plasma_spin_rwlock_t * const restrict rw)
+{
+    const uint32_t tkt =
+      plasma_atomic_fetch_add_u32(&rw->wtkt.u, PLASMA_SPIN_TKTLOCK_TKTINC,
+                                  memory_order_seq_cst);
+    uint32_t rin, rout;
+    int callcount = 0;
+    plasma_spin_nprocs_once(); /*init plasma_spin_pause_yield_adaptive()*/
+    if (!plasma_spin_rwlock_wtkt_is_free(tkt))
+        plasma_spin_rwlock_wtkt_spinloop(rw, tkt);
+
+    if (rw->mode == PLASMA_SPIN_RWLOCK_PHASEFAIR) {
+        /* block arriving readers; wait for departure of readers which
+         * arrived prior to writer.  Set writer present bit and toggle phase
+         * id so that consecutive writer phases differ.  (Phase id must not be
+         * derived from writer ticket, since plasma_spin_rwlock_trywrlock()
+         * may take and release a ticket without a writer phase; a reader
+         * waiting on a phase with same bits as the next phase would then
+         * wait forever on writer which waits for reader to depart.) */
+        rin = PLASMA_SPIN_RWLOCK_RIN(
+                plasma_atomic_fetch_xor_u32(&rw->rin, PLASMA_SPIN_RWLOCK_PRES
+                                                    | PLASMA_SPIN_RWLOCK_PHID,
+                                            memory_order_relaxed));
+        while (rin != plasma_atomic_load_explicit(&rw->rout,
+                                                  memory_order_relaxed))
+            plasma_spin_pause_yield_adaptive(1u, ++callcount);
+    }
+    else {
+        /* wait for readers to drain (arriving readers see writer pending and
+         * back off).  Load rout prior to rin; each reader increments rout
+         * only after incrementing rin, so rin == rout only if no readers */
+        for (;;) {
+            rout = plasma_atomic_load_explicit(&rw->rout, memory_order_seq_cst);
+            rin  = plasma_atomic_load_explicit(&rw->rin,  memory_order_seq_cst);
+            if (rin == rout)
+                break;
+            plasma_spin_pause_yield_adaptive(1u, ++callcount);
+        }
+    }
+    atomic_thread_fence(memory_order_acquire);
+    rw->wlocked = 1;
+    return true;
+}
+
+bool
+plasma_spin_rwlock_trywrlock (plasma_spin_rwlock_t * const restrict rw)
+{
+    const uint32_t tkt =
+      plasma_atomic_load_explicit(&rw->wtkt.u, memory_order_relaxed);
+    uint32_t rin, rout;
+    if (!plasma_spin_rwlock_wtkt_is_free(tkt)
+        || !plasma_atomic_CAS_32(&rw->wtkt.u, tkt,
+                                 tkt + PLASMA_SPIN_TKTLOCK_TKTINC))
+        return false;
+    /* obtained writer ticket; succeed only if no readers are present */
+    rout = plasma_atomic_load_explicit(&rw->rout, memory_order_seq_cst);
+    rin  = plasma_atomic_load_explicit(&rw->rin,  memory_order_seq_cst);
+    if (PLASMA_SPIN_RWLOCK_RIN(rin) == rout
+        && (rw->mode != PLASMA_SPIN_RWLOCK_PHASEFAIR
+            || plasma_atomic_CAS_32(&rw->rin, rin, rin
+                                    ^ (PLASMA_SPIN_RWLOCK_PRES
+                                       | PLASMA_SPIN_RWLOCK_PHID)))) {
+        plasma_membar_atomic_thread_fence_acq_rel();
+        rw->wlocked = 1;
+        return true;
+    }
+    plasma_spin_rwlock_wrunlock(rw); /* release writer ticket */
+    return false;
+}
+
+
+/* inlined functions defined in header
+ * (generate external linkage definition in C99-compliant compilers)
+ * (need to -duplicate- definition from header for non-C99-compliant compilers)
+ */
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__)
+extern inline
+void
+plasma_spin_rwlock_rdunlock (plasma_spin_rwlock_t * const restrict rw);
+void
+plasma_spin_rwlock_rdunlock (plasma_spin_rwlock_t * const restrict rw);
+
+extern inline
+void
+plasma_spin_rwlock_wrunlock (plasma_spin_rwlock_t * const restrict rw);
+void
+plasma_spin_rwlock_wrunlock (plasma_spin_rwlock_t * const restrict rw);
+
+extern inline
+void
+plasma_spin_rwlock_unlock (plasma_spin_rwlock_t * const restrict rw);
+void
+plasma_spin_rwlock_unlock (plasma_spin_rwlock_t * const restrict rw);
+#endif
+
+
+/*
+ * NUMA-aware cohort lock
+ */
+
+#ifdef __linux__
+
+#include <dirent.h>  /* opendir() readdir() closedir() */
+#include <sched.h>   /* sched_getcpu() */
+#include <stdio.h>   /* fopen() fscanf() fgetc() fclose() snprintf() */
+#include <string.h>  /* strncmp() */
+
+/* map of CPU number to NUMA node, read from /sys/devices/system/node/
+ * (map is populated once and is not modified thereafter) */
+static uint16_t *plasma_spin_numa_cpumap;
+static uint32_t  plasma_spin_numa_ncpus;
+static plasma_once_t plasma_spin_numa_once = PLASMA_ONCE_INITIALIZER;
+
+__attribute_cold__
+static bool
+plasma_spin_numa_cpumap_set (uint16_t ** const restrict map,
+                             uint32_t * const restrict ncpus,
+                             const uint32_t lo, const uint32_t hi,
+                             const uint16_t node)
+{
+    uint32_t n;
+    if (hi >= *ncpus) {
+        uint16_t * const m = realloc(*map, (hi + 1) * sizeof(uint16_t));
+        if (m == NULL)
+            return false;
+        for (n = *ncpus; n <= hi; ++n)
+            m[n] = 0;
+        *map = m;
+        *ncpus = hi + 1;
+    }
+    for (n = lo; n <= hi; ++n)
+        (*map)[n] = node;
+    return true;
+}
+
+__attribute_cold__
+static void
+plasma_spin_numa_init (void)
+{
+    /* parse nodeN/cpulist (e.g. "0-7,16-23") for each NUMA node N */
+    uint16_t *map = NULL;
+    uint32_t ncpus = 0;
+    struct dirent *dent;
+    DIR * const dir = opendir("/sys/devices/system/node");
+    if (dir == NULL)
+        return;  /* (not NUMA or sysfs not mounted; all CPUs on node 0) */
+    while ((dent = readdir(dir)) != NULL) {
+        char path[64];
+        char *end;
+        FILE *fp;
+        unsigned int lo, hi;
+        unsigned long node;
+        if (0 != strncmp(dent->d_name, "node", 4)
+            || dent->d_name[4] < '0' || dent->d_name[4] > '9')
+            continue;
+        node = strtoul(dent->d_name+4, &end, 10);
+        if (*end != '\0' || node > UINT16_MAX)
+            continue;
+        snprintf(path, sizeof(path),
+                 "/sys/devices/system/node/node%lu/cpulist", node);
+        if ((fp = fopen(path, "r")) == NULL)
+            continue;
+        while (1 == fscanf(fp, "%u", &lo)) {
+            int c = fgetc(fp);
+            hi = lo;
+            if (c == '-') {
+                if (1 != fscanf(fp, "%u", &hi) || hi < lo)
+                    break;
+                c = fgetc(fp);
+            }
+            if (!plasma_spin_numa_cpumap_set(&map, &ncpus, lo, hi,
+                                             (uint16_t)node))
+                break;
+            if (c != ',')
+                break;
+        }
+        fclose(fp);
+    }
+    closedir(dir);
+    plasma_spin_numa_cpumap = map;
+    plasma_atomic_store_explicit(&plasma_spin_numa_ncpus, ncpus,
+                                 memory_order_release);
+}
+
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__) || defined(__clang__)
+C99INLINE
+#endif
+static uint32_t
+plasma_spin_numa_node (void)
+{
+    /* sched_getcpu() is fast (vDSO); CPU might change after call returns,
+     * but result is only a hint used to group threads into cohorts */
+    const int cpu = sched_getcpu();
+    uint32_t ncpus;
+    /* (plasma_call_once() publishes cpumap and ncpus to all callers) */
+    plasma_call_once(&plasma_spin_numa_once, plasma_spin_numa_init);
+    ncpus = plasma_atomic_load_explicit(&plasma_spin_numa_ncpus,
+                                        memory_order_relaxed);
+    return ((uint32_t)cpu < ncpus) /*(cpu == -1 on error)*/
+      ? (uint32_t)plasma_spin_numa_cpumap[cpu]
+      : 0;
+}
+
+#else
+
+#define plasma_spin_numa_node() 0u
+
+#endif
+
+void
+plasma_spin_cohortlock_init (plasma_spin_cohortlock_t * const restrict cohort,
+                             const uint32_t batch)
+{
+    int i;
+    plasma_spin_tktlock_init(&cohort->global);
+    cohort->batch = batch;
+    cohort->node  = 0;
+    for (i = 0; i < PLASMA_SPIN_COHORTLOCK_NODES; ++i) {
+        plasma_spin_tktlock_init(&cohort->nodes[i].lck);
+        cohort->nodes[i].global = 0;
+        cohort->nodes[i].count  = 0;
+    }
+}
+
+bool
+plasma_spin_cohortlock_acquire (plasma_spin_cohortlock_t *
+                                  const restrict cohort)
+{
+    const uint32_t node =
+      plasma_spin_numa_node() % PLASMA_SPIN_COHORTLOCK_NODES;
+    plasma_spin_cohortlock_node_t * const restrict local = cohort->nodes+node;
+    plasma_spin_tktlock_acquire(&local->lck);
+    /* (local->global and local->count protected by local->lck) */
+    if (!local->global) {
+        plasma_spin_tktlock_acquire(&cohort->global);
+        local->global = 1;
+        local->count  = 0;
+    }
+    cohort->node = node;
+    return true;
+}
+
+void
+plasma_spin_cohortlock_release (plasma_spin_cohortlock_t *
+                                  const restrict cohort)
+{
+    plasma_spin_cohortlock_node_t * const restrict local =
+      cohort->nodes+cohort->node;
+    const uint32_t tkt =
+      plasma_atomic_load_explicit(&local->lck.lck.u, memory_order_relaxed);
+    uint32_t batch = cohort->batch;
+    if (0 == batch) {
+        plasma_spin_nprocs_once();
+        batch = 1u << nshift;  /*(see PLASMA_SPIN_TAGLOCK_BATCH())*/
+    }
+    /* pass global lock within node if other threads waiting on local lock
+     * (waiting thread has taken ticket beyond the ticket of current holder)
+     * unless batch of consecutive handoffs within node has been exhausted */
+    if (((PLASMA_SPIN_TKTLOCK_SHIFT(tkt) - PLASMA_SPIN_TKTLOCK_MASK(tkt))
+         & PLASMA_SPIN_TKTLOCK_TKTMAX) > 1
+        && ++local->count < batch) {
+        plasma_spin_tktlock_release(&local->lck);
+    }
+    else {
+        local->global = 0;
+        plasma_spin_tktlock_release(&cohort->global);
+        plasma_spin_tktlock_release(&local->lck);
+    }
+}
+
+
+/*
+ * big-reader lock
+ */
+
+#ifndef __linux__
+/* slot assigned per thread (round-robin) (0 if not yet assigned, else slot+1)*/
+static PLASMA_SPIN_THREAD_LOCAL uint32_t plasma_spin_brlock_thrslot;
+static uint32_t plasma_spin_brlock_thrnext;
+#endif
+
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__) || defined(__clang__)
+C99INLINE
+#endif
+static uint32_t
+plasma_spin_brlock_slot (const plasma_spin_brlock_t * const restrict br)
+{
+  #ifdef __linux__
+    const int cpu = sched_getcpu();  /*(fast (vDSO); -1 on error)*/
+    return (cpu > 0 ? (uint32_t)cpu : 0u) % br->nslots;
+  #else
+    uint32_t n = plasma_spin_brlock_thrslot;
+    if (__builtin_expect( (n == 0), 0))
+        plasma_spin_brlock_thrslot = n = 1u +
+          plasma_atomic_fetch_add_u32(&plasma_spin_brlock_thrnext, 1,
+                                      memory_order_relaxed);
+    return (n - 1) % br->nslots;
+  #endif
+}
+
+bool
+plasma_spin_brlock_init (plasma_spin_brlock_t * const restrict br)
+{
+    long nprocs_onln = plasma_sysconf_nprocessors_onln();
+    plasma_spin_brlock_slot_t *slots;
+    uint32_t i;
+    if (nprocs_onln < 1)
+        nprocs_onln = 1;
+  #ifdef PLASMA_FEATURE_POSIX
+    if (0 != posix_memalign((void **)&slots, sizeof(plasma_spin_brlock_slot_t),
+                            (size_t)nprocs_onln
+                              * sizeof(plasma_spin_brlock_slot_t)))
+        return false;
+  #else
+    slots = malloc((size_t)nprocs_onln * sizeof(plasma_spin_brlock_slot_t));
+    if (slots == NULL)
+        return false;
+  #endif
+    for (i = 0; i < (uint32_t)nprocs_onln; ++i)
+        slots[i].readers = 0;
+    br->wlocked = 0;
+    br->nslots  = (uint32_t)nprocs_onln;
+    br->slots   = slots;
+    plasma_spin_lock_init(&br->wlock);
+    br->udata32 = 0;
+    br->udata64 = 0;
+    return true;
+}
+
+void
+plasma_spin_brlock_destroy (plasma_spin_brlock_t * const restrict br)
+{
+    free(br->slots);
+    br->slots  = NULL;
+    br->nslots = 0;
+}
+
+uint32_t
+plasma_spin_brlock_rdlock (plasma_spin_brlock_t * const restrict br)
+{
+    const uint32_t slot = plasma_spin_brlock_slot(br);
+    uint32_t * const restrict readers = &br->slots[slot].readers;
+    int callcount = 0;
+    for (;;) {
+        /* announce reader in slot, then check for writer (seq_cst, paired
+         * with writer setting flag and then checking reader slots) */
+        plasma_atomic_fetch_add_u32(readers, 1, memory_order_seq_cst);
+        if (!plasma_atomic_load_explicit(&br->wlocked, memory_order_seq_cst))
+            return slot;
+        /* writer present; back off and wait for writer to release lock */
+        plasma_atomic_fetch_sub_u32(readers, 1, memory_order_release);
+        plasma_spin_nprocs_once(); /*init plasma_spin_pause_yield_adaptive*/
+        while (plasma_atomic_load_explicit(&br->wlocked, memory_order_relaxed))
+            plasma_spin_pause_yield_adaptive(1u, ++callcount);
+    }
+}
+
+bool
+plasma_spin_brlock_tryrdlock (plasma_spin_brlock_t * const restrict br,
+                              uint32_t * const restrict slot)
+{
+    const uint32_t n = plasma_spin_brlock_slot(br);
+    uint32_t * const restrict readers = &br->slots[n].readers;
+    if (plasma_atomic_load_explicit(&br->wlocked, memory_order_relaxed))
+        return false;
+    plasma_atomic_fetch_add_u32(readers, 1, memory_order_seq_cst);
+    if (!plasma_atomic_load_explicit(&br->wlocked, memory_order_seq_cst)) {
+        *slot = n;
+        return true;
+    }
+    plasma_atomic_fetch_sub_u32(readers, 1, memory_order_release);
+    return false;
+}
+
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__) || defined(__clang__)
+C99INLINE
+#endif
+static void
+plasma_spin_brlock_drain (plasma_spin_brlock_t * const restrict br)
+{
+    /* wait for readers in each slot to depart (sweep all slots) */
+    plasma_spin_brlock_slot_t * const restrict slots = br->slots;
+    const uint32_t nslots = br->nslots;
+    uint32_t i;
+    int callcount = 0;
+    plasma_spin_nprocs_once(); /*init plasma_spin_pause_yield_adaptive()*/
+    for (i = 0; i < nslots; ++i) {
+        while (plasma_atomic_load_explicit(&slots[i].readers,
+                                           memory_order_seq_cst))
+            plasma_spin_pause_yield_adaptive(1u, ++callcount);
+    }
+    atomic_thread_fence(memory_order_acquire);
+}
+
+bool
+plasma_spin_brlock_wrlock (plasma_spin_brlock_t * const restrict br)
+{
+    (void)plasma_spin_lock_acquire(&br->wlock);
+    plasma_atomic_exchange_n_32(&br->wlocked, 1, memory_order_seq_cst);
+    plasma_spin_brlock_drain(br);
+    return true;
+}
+
+bool
+plasma_spin_brlock_trywrlock (plasma_spin_brlock_t * const restrict br)
+{
+    plasma_spin_brlock_slot_t * const restrict slots = br->slots;
+    const uint32_t nslots = br->nslots;
+    uint32_t i;
+    if (!plasma_spin_lock_acquire_try(&br->wlock))
+        return false;
+    plasma_atomic_exchange_n_32(&br->wlocked, 1, memory_order_seq_cst);
+    for (i = 0; i < nslots; ++i) {
+        if (plasma_atomic_load_explicit(&slots[i].readers,
+                                        memory_order_seq_cst)) {
+            plasma_spin_brlock_wrunlock(br);  /*(readers present)*/
+            return false;
+        }
+    }
+    atomic_thread_fence(memory_order_acquire);
+    return true;
+}
+
+
+/* inlined functions defined in header
+ * (generate external linkage definition in C99-compliant compilers)
+ * (need to -duplicate- definition from header for non-C99-compliant compilers)
+ */
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__)
+extern inline
+void
+plasma_spin_brlock_rdunlock (plasma_spin_brlock_t * const restrict br,
+                             const uint32_t slot);
+void
+plasma_spin_brlock_rdunlock (plasma_spin_brlock_t * const restrict br,
+                             const uint32_t slot);
+
+extern inline
+void
+plasma_spin_brlock_wrunlock (plasma_spin_brlock_t * const restrict br);
+void
+plasma_spin_brlock_wrunlock (plasma_spin_brlock_t * const restrict br);
+#endif
+
+
+/*
+ * spin barrier
+ */
+
+/* (per-thread node padded to separate cache line(s); each thread spins only
+ *  on flags in its own node, and flags are written by at most a few threads)
+ * (flags store barrier episode number instead of sense and parity; thread
+ *  waits until flag reaches its current episode, using serial number
+ *  arithmetic so that wrap of 32-bit episode count is harmless) */
+struct plasma_spin_barrier_node_t {
+    uint32_t episode;   /* barrier episodes passed by thread (thread-owned) */
+    uint32_t release;   /* TREE: wakeup signal from parent */
+    uint32_t child[4];  /* TREE: arrival signals from children */
+    uint32_t flags[32]; /* DISSEMINATION: signal from partner in each round */
+} __attribute_aligned__(64);
+
+#define plasma_spin_barrier_reached(flag, episode) \
+        ((int32_t)(plasma_atomic_load_explicit((flag), memory_order_relaxed) \
+                   - (episode)) >= 0)
+
+#if !defined(__GNUC__) || defined(__GNUC_STDC_INLINE__) || defined(__clang__)
+C99INLINE
+#endif
+static void
+plasma_spin_barrier_spinwait (const uint32_t * const flag,
+                              const uint32_t episode)
+{
+    /* spin (pause only) for up to PLASMA_SPIN_BARRIER_SPIN_NS, then yield
+     * (yield immediately if single CPU; other threads can not otherwise run)*/
+    uint32_t spins;
+    if (!plasma_spin_barrier_reached(flag, episode)) {
+        spins = plasma_spin_wait_budget_ns(PLASMA_SPIN_BARRIER_SPIN_NS);
+        while (!plasma_spin_barrier_reached(flag, episode))
+            plasma_spin_wait_yield(&spins);
+    }
+    atomic_thread_fence(memory_order_acquire);
+}
+
+bool
+plasma_spin_barrier_init (plasma_spin_barrier_t * const restrict barrier,
+                          const uint32_t nthreads, const uint32_t type)
+{
+    struct plasma_spin_barrier_node_t *nodes = NULL;
+    uint32_t rounds = 0;
+    if (nthreads == 0 || type > PLASMA_SPIN_BARRIER_TREE)
+        return false;
+    while ((1u << rounds) < nthreads && rounds < 31)
+        ++rounds;
+    if (type != PLASMA_SPIN_BARRIER_CENTRAL) {
+        size_t i;
+        void *p;
+      #ifdef PLASMA_FEATURE_POSIX
+        if (0 != posix_memalign(&p, 64, (size_t)nthreads
+                                  * sizeof(struct plasma_spin_barrier_node_t)))
+            p = NULL;
+      #else
+        p = malloc((size_t)nthreads*sizeof(struct plasma_spin_barrier_node_t));
+      #endif
+        if (p == NULL)
+            return false;
+        nodes = (struct plasma_spin_barrier_node_t *)p;
+        for (i = 0; i < nthreads; ++i) {
+            uint32_t r;
+            nodes[i].episode = 0;
+            nodes[i].release = 0;
+            for (r = 0; r < 4; ++r)
+                nodes[i].child[r] = 0;
+            for (r = 0; r < 32; ++r)
+                nodes[i].flags[r] = 0;
+        }
+    }
+    plasma_spin_nprocs_once(); /*init plasma_spin_pause_yield_adaptive()*/
+    barrier->count    = nthreads;
+    barrier->sense    = 0;
+    barrier->nthreads = nthreads;
+    barrier->type     = type;
+    barrier->rounds   = rounds;
+    barrier->udata32  = 0;
+    barrier->nodes    = nodes;
+    barrier->udata64  = 0;
+    return true;
+}
+
+void
+plasma_spin_barrier_destroy (plasma_spin_barrier_t * const restrict barrier)
+{
+    free(barrier->nodes);
+    barrier->nodes = NULL;
+}
+
+bool
+plasma_spin_barrier_wait (plasma_spin_barrier_t * const restrict barrier,
+                          const uint32_t id)
+{
+    const uint32_t nthreads = barrier->nthreads;
+    struct plasma_spin_barrier_node_t * const restrict nodes = barrier->nodes;
+    uint32_t episode, r, c;
+
+    switch (barrier->type) {
+
+      case PLASMA_SPIN_BARRIER_CENTRAL:
+      default:
+        /* (sense read prior to arrival cannot flip until this thread arrives)*/
+        episode = plasma_atomic_load_explicit(&barrier->sense,
+                                              memory_order_relaxed);
+        if (plasma_atomic_fetch_sub_u32(&barrier->count, 1,
+                                        memory_order_acq_rel) == 1) {
+            /* last arrival: reset count and then flip sense to release */
+            plasma_atomic_store_explicit(&barrier->count, nthreads,
+                                         memory_order_relaxed);
+            plasma_atomic_store_explicit(&barrier->sense, episode + 1,
+                                         memory_order_release);
+            return true;
+        }
+        plasma_spin_barrier_spinwait(&barrier->sense, episode + 1);
+        return false;
+
+      case PLASMA_SPIN_BARRIER_DISSEMINATION:
+        episode = ++nodes[id].episode;
+        for (r = 0; r < barrier->rounds; ++r) {
+            c = (uint32_t)(((uint64_t)id + (1u << r)) % nthreads);
+            plasma_atomic_store_explicit(&nodes[c].flags[r], episode,
+                                         memory_order_release);
+            plasma_spin_barrier_spinwait(&nodes[id].flags[r], episode);
+        }
+        return (id == 0);
+
+      case PLASMA_SPIN_BARRIER_TREE:
+        episode = ++nodes[id].episode;
+        /* wait for children in 4-ary arrival tree; then signal parent */
+        for (r = 0; r < 4; ++r) {
+            c = 4 * id + r + 1;
+            if (c >= nthreads)
+                break;
+            plasma_spin_barrier_spinwait(&nodes[id].child[r], episode);
+        }
+        if (id != 0) {
+            plasma_atomic_store_explicit(&nodes[(id-1)/4].child[(id-1)%4],
+                                         episode, memory_order_release);
+            plasma_spin_barrier_spinwait(&nodes[id].release, episode);
+        }
+        /* wake children in binary wakeup tree */
+        for (r = 1; r <= 2; ++r) {
+            c = 2 * id + r;
+            if (c >= nthreads)
+                break;
+            plasma_atomic_store_explicit(&nodes[c].release, episode,
+                                         memory_order_release);
+        }
+        return (id == 0);
+    }
+}
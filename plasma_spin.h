@@ -259,6 +259,189 @@ extern "C" {
 #endif
 
 
+/* PLASMA_SPIN_STATS  lock contention statistics (compile-time option)
+ *
+ * plasma_spin_stats_get()
+ * plasma_spin_stats_snapshot()
+ * plasma_spin_stats_reset()
+ *
+ * Compile plasma_spin.c and code using plasma_spin locks with
+ * -DPLASMA_SPIN_STATS to record per-lock statistics for plasma_spin_lock,
+ * plasma_spin_tktlock, plasma_spin_tktlock64, plasma_spin_taglock and
+ * plasma_spin_taglock32: acquisitions, contended acquisitions (acquisitions
+ * which had to wait), spin iterations, yields, and total and max wait time
+ * and hold time (nanoseconds).  Statistics are kept in a side table keyed by
+ * lock address (PLASMA_SPIN_STATS_MAX entries; locks beyond that are not
+ * recorded), so lock structures and udata fields are not modified.  Stats for
+ * a lock are updated by the lock holder, so updates are serialized by the
+ * lock itself; snapshot and reset race with lock holders and are approximate
+ * while lock is in use.  Locks should be reset (or not yet used) when memory
+ * for a lock is freed and reused for another lock at the same address.
+ *
+ * When PLASMA_SPIN_STATS is not defined, hooks compile to nothing and this
+ * API is not defined.  (Not available with Apple OSSpinLock plasma_spin_lock)
+ */
+
+#ifdef PLASMA_SPIN_STATS
+
+#include <stddef.h>  /* size_t */
+
+#ifndef PLASMA_SPIN_STATS_MAX
+#define PLASMA_SPIN_STATS_MAX 4096  /* (must be power of 2) */
+#endif
+
+typedef struct plasma_spin_stats_t {
+    const void *lock;
+    uint64_t acquisitions;
+    uint64_t contended;
+    uint64_t spins;
+    uint64_t yields;
+    uint64_t wait_ns_total;
+    uint64_t wait_ns_max;
+    uint64_t hold_ns_total;
+    uint64_t hold_ns_max;
+} plasma_spin_stats_t;
+
+/* copy stats for lock into st; returns false if no stats recorded for lock */
+__attribute_nonnull__()
+bool
+plasma_spin_stats_get (const void * const restrict lock,
+                       plasma_spin_stats_t * const restrict st);
+
+/* copy stats for up to n locks into st; returns number of locks copied */
+size_t
+plasma_spin_stats_snapshot (plasma_spin_stats_t * const restrict st,
+                            const size_t n);
+
+/* reset stats for lock (or for all locks if lock is NULL) */
+void
+plasma_spin_stats_reset (const void * const restrict lock);
+
+/*(internal hooks called by lock implementations)*/
+__attribute_nonnull__()
+void
+plasma_spin_stats_acquired (const void * const restrict lock,
+                            const uint64_t t0,
+                            const uint32_t spins, const uint32_t yields);
+__attribute_nonnull__()
+void
+plasma_spin_stats_released (const void * const restrict lock);
+
+#define PLASMA_SPIN_STATS_ACQUIRED(lock) \
+        plasma_spin_stats_acquired((lock), 0, 0, 0)
+#define PLASMA_SPIN_STATS_RELEASED(lock) \
+        plasma_spin_stats_released(lock)
+
+#else
+
+#define PLASMA_SPIN_STATS_ACQUIRED(lock) do { } while (0)
+#define PLASMA_SPIN_STATS_RELEASED(lock) do { } while (0)
+
+#endif
+
+
+/* plasma_spin_clock_ns()
+ *   monotonic clock (nanoseconds) for deadlines of timed acquire
+ *   (e.g. plasma_spin_lock_acquire_until())
+ *   (clock_gettime(CLOCK_MONOTONIC); QueryPerformanceCounter() on _WIN32)
+ * PLASMA_SPIN_DEADLINE_CHECK
+ *   number of pauses between clock reads while waiting for timed acquire
+ */
+#ifndef PLASMA_SPIN_DEADLINE_CHECK
+#define PLASMA_SPIN_DEADLINE_CHECK 64
+#endif
+
+uint64_t
+plasma_spin_clock_ns (void);
+
+
+/* plasma_spin_pause_cost_ps()
+ *   cost of plasma_spin_pause() (picoseconds), calibrated on first use
+ * plasma_spin_budget_ns()
+ *   number of plasma_spin_pause() approximating ns nanoseconds (at least 1)
+ * plasma_spin_pause_ns()
+ *   pause (spin) for approximately ns nanoseconds
+ *
+ * Cost of plasma_spin_pause() varies by more than 10x across CPU generations
+ * (e.g. x86 pause is ~10 cycles prior to Skylake and ~140 cycles on Skylake
+ * and later), so fixed pause counts result in very different wall time spent
+ * spinning on different hosts.  Spin policies can instead be expressed in
+ * nanoseconds and converted to pause counts with plasma_spin_budget_ns().
+ * Calibration times bursts of plasma_spin_pause() with plasma_spin_clock_ns()
+ * and keeps the fastest burst (least disturbed by preemption or interrupts).
+ * Define PLASMA_SPIN_PAUSE_PS when compiling plasma_spin.c to skip calibration
+ * and use a fixed cost.  (calibration falls back to PLASMA_SPIN_PAUSE_PS_DFLT
+ * if clock resolution is too coarse)
+ */
+#ifndef PLASMA_SPIN_PAUSE_PS_DFLT
+#define PLASMA_SPIN_PAUSE_PS_DFLT 10000
+#endif
+
+uint32_t
+plasma_spin_pause_cost_ps (void);
+
+uint32_t
+plasma_spin_budget_ns (uint64_t ns);
+
+void
+plasma_spin_pause_ns (uint64_t ns);
+
+
+/* plasma_spin_wait_budget_ns()
+ * plasma_spin_wait_pause()
+ * plasma_spin_wait_yield()
+ *
+ * Bounded spin-wait for slow paths which spin briefly and then yield or park:
+ *   uint32_t spins = plasma_spin_wait_budget_ns(PLASMA_..._SPIN_NS);
+ *   while (!condition)
+ *       plasma_spin_wait_yield(&spins);       (spin, then yield)
+ * or
+ *   while (!condition)
+ *       if (!plasma_spin_wait_pause(&spins))  (spin, then park)
+ *           ... park ...
+ * plasma_spin_wait_budget_ns() returns plasma_spin_budget_ns(ns), or 0 (do not
+ * spin) if there is a single CPU, since the thread being waited upon can not
+ * then make progress while the waiter spins.  plasma_spin_wait_pause() pauses
+ * and returns true while budget remains, and otherwise returns false.
+ * plasma_spin_wait_yield() pauses while budget remains, and then yields.
+ */
+
+uint32_t
+plasma_spin_wait_budget_ns (uint64_t ns);
+
+__attribute_nonnull__()
+PLASMA_SPIN_C99INLINE
+bool
+plasma_spin_wait_pause (uint32_t * const restrict spins);
+#ifdef PLASMA_SPIN_C99INLINE_FUNCS
+PLASMA_SPIN_C99INLINE
+bool
+plasma_spin_wait_pause (uint32_t * const restrict spins)
+{
+    if (*spins) {
+        --*spins;
+        plasma_spin_pause();
+        return true;
+    }
+    return false;
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_SPIN_C99INLINE
+void
+plasma_spin_wait_yield (uint32_t * const restrict spins);
+#ifdef PLASMA_SPIN_C99INLINE_FUNCS
+PLASMA_SPIN_C99INLINE
+void
+plasma_spin_wait_yield (uint32_t * const restrict spins)
+{
+    if (!plasma_spin_wait_pause(spins))
+        plasma_spin_yield();
+}
+#endif
+
+
 /* plasma_spin_lock_init()
  * plasma_spin_lock_acquire()
  * plasma_spin_lock_acquire_try()
@@ -274,8 +457,10 @@ extern "C" {
  *
  * plasma_spin_lock_acquire_spindecay() 
  *   spin loop hybrid with adjustable spin counts for levels of backoff/decay
- *     (pause count, (pause x 32) count, yield count)
+ *     (pause count, pause burst count, yield count)
  *     e.g. plasma_spin_lock_acquire_spindecay(spin, 32, 64, 8)
+ *   (pause burst is PLASMA_SPIN_BURST_NS nanoseconds of pauses;
+ *    see plasma_spin_budget_ns())
  *   returns true if lock obtained, false if backoff counts exhausted (decayed)
  * - again, caller should avoid blocking operations inside critical section
  * - for potential use with moderately contended locks (YMMV)
@@ -310,6 +495,10 @@ extern "C" {
  *   (A sizable number of mobile devices are uniprocessor and single core.)
  */
 
+#ifndef PLASMA_SPIN_BURST_NS     /* plasma_spin_lock_acquire_spindecay() */
+#define PLASMA_SPIN_BURST_NS      512
+#endif
+
 
 #if (defined(__APPLE__) && defined(__MACH__)) \
  && defined(MAC_OS_X_VERSION_MIN_REQUIRED) \
@@ -351,12 +540,26 @@ struct plasma_spin_lock_t {
          (spin)->udata32 = 0, \
          (spin)->udata64 = 0)
 
+#ifndef PLASMA_SPIN_STATS
+
 #define plasma_spin_lock_release(spin) \
         plasma_atomic_lock_release(&(spin)->lck)
 
 #define plasma_spin_lock_acquire_try(spin) \
         plasma_atomic_lock_acquire(&(spin)->lck)
 
+#else
+
+#define plasma_spin_lock_release(spin) \
+        (plasma_spin_stats_released(spin), \
+         plasma_atomic_lock_release(&(spin)->lck))
+
+#define plasma_spin_lock_acquire_try(spin) \
+        (plasma_atomic_lock_acquire(&(spin)->lck) \
+         && (plasma_spin_stats_acquired((spin), 0, 0, 0), 1))
+
+#endif
+
 #define plasma_spin_lock_acquire(spin) \
        (plasma_spin_lock_acquire_try(spin) \
         || plasma_spin_lock_acquire_spinloop(spin))
@@ -377,6 +580,60 @@ plasma_spin_lock_acquire_spindecay (plasma_spin_lock_t * const spin,
                                     int pause1, int pause32, int yield);
 
 
+/* plasma_spin_lock_acquire_adaptive()
+ *   self-tuning alternative to plasma_spin_lock_acquire_spindecay()
+ *   spin for budget of pauses tuned from recent outcomes on this lock, and
+ *   then yield until lock obtained (see plasma_spin.c for details)
+ *   (similar to glibc PTHREAD_MUTEX_ADAPTIVE_NP)
+ * Spin budget is stored in spin->udata32, so udata32 is not available for
+ * user data if lock is acquired with plasma_spin_lock_acquire_adaptive()
+ *
+ * PLASMA_SPIN_ADAPTIVE_INIT: initial spin budget (in pauses)
+ * PLASMA_SPIN_ADAPTIVE_MIN:  min spin budget (in pauses)
+ * PLASMA_SPIN_ADAPTIVE_MAX:  max spin budget (in pauses)
+ */
+#ifndef PLASMA_SPIN_ADAPTIVE_INIT
+#define PLASMA_SPIN_ADAPTIVE_INIT 256
+#endif
+#ifndef PLASMA_SPIN_ADAPTIVE_MIN
+#define PLASMA_SPIN_ADAPTIVE_MIN  16
+#endif
+#ifndef PLASMA_SPIN_ADAPTIVE_MAX
+#define PLASMA_SPIN_ADAPTIVE_MAX  8192
+#endif
+
+#define plasma_spin_lock_acquire_adaptive(spin) \
+       (plasma_spin_lock_acquire_try(spin) \
+        || plasma_spin_lock_acquire_adaptive_spinloop(spin))
+
+/*(plasma_spin_lock_acquire_adaptive_spinloop() always returns true)*/
+__attribute_nonnull__()
+bool
+plasma_spin_lock_acquire_adaptive_spinloop (plasma_spin_lock_t * const spin);
+
+/* plasma_spin_lock_acquire_until()
+ * plasma_spin_lock_acquire_for()
+ *   timed acquire; returns false if lock not obtained by deadline
+ *   (deadline is plasma_spin_clock_ns() time; for() takes relative timeout)
+ */
+__attribute_nonnull__()
+bool
+plasma_spin_lock_acquire_until (plasma_spin_lock_t * const spin,
+                                const uint64_t deadline);
+
+#define plasma_spin_lock_acquire_for(spin, ns) \
+        plasma_spin_lock_acquire_until((spin), plasma_spin_clock_ns() + (ns))
+
+
+/* proportional backoff (see plasma_spin_tktlock_acquire_backoff())
+ * PLASMA_SPIN_BACKOFF_SHIFT: fixed point shift of critical section estimate
+ * PLASMA_SPIN_BACKOFF_MAX:   max pauses between reads of lock word */
+#define PLASMA_SPIN_BACKOFF_SHIFT 4
+#ifndef PLASMA_SPIN_BACKOFF_MAX
+#define PLASMA_SPIN_BACKOFF_MAX   1024
+#endif
+
+
 /* plasma_spin_tktlock_*()  ticket lock
  * (see bottom of file for ticket lock references)
  *
@@ -451,12 +708,87 @@ plasma_spin_tktlock_acquire (plasma_spin_tktlock_t * const restrict spin)
          *  emit barrier only if platform requires barrier after rmw atomic)
          * (not sure if atomic_thread_fence(memory_order_acq_rel) does same)*/
         plasma_membar_atomic_thread_fence_acq_rel();
+        PLASMA_SPIN_STATS_ACQUIRED(spin);
         return true;
     }
     return plasma_spin_tktlock_acquire_spinloop(spin, tkt);
 }
 #endif
 
+/* plasma_spin_tktlock_acquire_backoff()
+ *
+ * Proportional backoff: waiters pause proportional to distance from head of
+ * queue times a calibrated estimate of critical section duration, rather than
+ * polling the lock word after each pause (plasma_spin_tktlock_acquire()).
+ * Estimate is self-calibrated by waiters and stored in spin->udata32, so
+ * udata32 is not available for user data if plasma_spin_tktlock is acquired
+ * with plasma_spin_tktlock_acquire_backoff().  (ok to mix with calls to
+ * plasma_spin_tktlock_acquire())  (see plasma_spin.c for details) */
+
+/*(plasma_spin_tktlock_acquire_spinloop_backoff() always returns true)*/
+__attribute_noinline__
+__attribute_nonnull__()
+bool
+plasma_spin_tktlock_acquire_spinloop_backoff (plasma_spin_tktlock_t *
+                                                const restrict spin,
+                                                uint32_t tkt);
+
+/*(plasma_spin_tktlock_acquire_backoff() always returns true)*/
+__attribute_nonnull__()
+PLASMA_SPIN_C99INLINE
+bool
+plasma_spin_tktlock_acquire_backoff (plasma_spin_tktlock_t *
+                                       const restrict spin);
+#ifdef PLASMA_SPIN_C99INLINE_FUNCS
+PLASMA_SPIN_C99INLINE
+bool
+plasma_spin_tktlock_acquire_backoff (plasma_spin_tktlock_t *
+                                       const restrict spin)
+{
+    const uint32_t tkt = /* increment ticket count (high 16-bits of lck) */
+      plasma_atomic_fetch_add_u32(&spin->lck.u, PLASMA_SPIN_TKTLOCK_TKTINC,
+                                  memory_order_relaxed);
+    if (__builtin_expect(
+          (PLASMA_SPIN_TKTLOCK_SHIFT(tkt)==PLASMA_SPIN_TKTLOCK_MASK(tkt)), 1)) {
+        plasma_membar_atomic_thread_fence_acq_rel();
+        PLASMA_SPIN_STATS_ACQUIRED(spin);
+        return true;
+    }
+    return plasma_spin_tktlock_acquire_spinloop_backoff(spin, tkt);
+}
+#endif
+
+/* plasma_spin_tktlock_acquire_until()
+ * plasma_spin_tktlock_acquire_for()
+ * plasma_spin_tktlock_release_timed()
+ *
+ * Timed acquire; returns false if lock not obtained by deadline.
+ * Waiter which times out abandons its ticket: it sets the bit for its ticket
+ * (ticket mod 64) in spin->udata64, and plasma_spin_tktlock_release_timed()
+ * skips abandoned tickets when handing off the lock.  Waiter and releaser
+ * race to clear the bit if releaser hands off to ticket as it is abandoned;
+ * waiter obtains lock (returns true) if waiter clears bit, else releaser
+ * skips ticket.  Since bits are shared by tickets 64 apart, a waiter may
+ * abandon only if within 64 tickets of head of queue; a waiter further back
+ * when deadline expires continues waiting until that is so.
+ *
+ * Lock acquired with plasma_spin_tktlock_acquire_until() (by any thread) must
+ * be released with plasma_spin_tktlock_release_timed() (by all threads), and
+ * udata64 is not available for user data.  (ok to mix with other acquire)
+ */
+
+__attribute_nonnull__()
+bool
+plasma_spin_tktlock_acquire_until (plasma_spin_tktlock_t * const restrict spin,
+                                   const uint64_t deadline);
+
+#define plasma_spin_tktlock_acquire_for(spin, ns) \
+        plasma_spin_tktlock_acquire_until((spin), plasma_spin_clock_ns()+(ns))
+
+__attribute_nonnull__()
+void
+plasma_spin_tktlock_release_timed (plasma_spin_tktlock_t * const restrict spin);
+
 __attribute_nonnull__()
 PLASMA_SPIN_C99INLINE
 void
@@ -489,6 +821,113 @@ plasma_spin_tktlock_release (plasma_spin_tktlock_t * const restrict spin)
     uint16_t * const ptr = &spin->lck.t.be;
   #endif
     const uint16_t n = *ptr + (uint16_t)1u;
+    PLASMA_SPIN_STATS_RELEASED(spin);
+    plasma_atomic_store_explicit(ptr, n, memory_order_release);
+}
+#endif
+
+
+/* plasma_spin_tktlock64_*()  ticket lock with 32-bit ticket halves
+ *
+ * plasma_spin_tktlock64_init()
+ * plasma_spin_tktlock64_is_free()
+ * plasma_spin_tktlock64_acquire()
+ * plasma_spin_tktlock64_acquire_spinloop()
+ * plasma_spin_tktlock64_release()
+ *
+ * Same as plasma_spin_tktlock, but with 32-bit ticket num ready to be served
+ * (low 32-bits of lck) and 32-bit next ticket (high 32-bits of lck), lifting
+ * limit of 65535 simultaneous waiters to 4294967295.  Acquire is a 64-bit
+ * atomic add and release is a native 32-bit atomic store.  Distance to head
+ * of queue is unsigned 32-bit difference, correct across wraparound.
+ * (64-bit atomic add might be more expensive on 32-bit platforms)
+ * Note: no udata32; lck occupies first 8 bytes
+ */
+
+typedef __attribute_aligned__(16)
+struct plasma_spin_tktlock64_t {
+    union { uint64_t u; struct { uint32_t le; uint32_t be; } t; } lck;
+    uint64_t udata64; /* user data 8-bytes */
+} plasma_spin_tktlock64_t;
+
+#define PLASMA_SPIN_TKTLOCK64_TKTINC     UINT64_C(0x100000000)
+#define PLASMA_SPIN_TKTLOCK64_MASK(x)    ((uint32_t)(x))
+#define PLASMA_SPIN_TKTLOCK64_SHIFT(x)   ((uint32_t)((x) >> 32))
+
+#if (defined(__STDC_VERSION__) && __STDC_VERSION__-0 >= 199901L) /* C99 */
+#define PLASMA_SPIN_TKTLOCK64_INITIALIZER {.lck.u = 0, .udata64 = 0}
+#else
+#define PLASMA_SPIN_TKTLOCK64_INITIALIZER { { 0 }, 0 }
+#endif
+#define plasma_spin_tktlock64_init(t) ((t)->lck.u = 0, (t)->udata64 = 0)
+
+__attribute_nonnull__()
+PLASMA_SPIN_C99INLINE
+bool
+plasma_spin_tktlock64_is_free (const plasma_spin_tktlock64_t *
+                                 const restrict spin);
+#ifdef PLASMA_SPIN_C99INLINE_FUNCS
+PLASMA_SPIN_C99INLINE
+bool
+plasma_spin_tktlock64_is_free (const plasma_spin_tktlock64_t *
+                                 const restrict spin)
+{
+    const uint64_t tkt = spin->lck.u;
+    return (PLASMA_SPIN_TKTLOCK64_SHIFT(tkt)
+            == PLASMA_SPIN_TKTLOCK64_MASK(tkt));
+}
+#endif
+
+/*(plasma_spin_tktlock64_acquire_spinloop() always returns true)*/
+__attribute_noinline__
+__attribute_nonnull__()
+bool
+plasma_spin_tktlock64_acquire_spinloop (plasma_spin_tktlock64_t *
+                                          const restrict spin, uint64_t tkt);
+
+/*(plasma_spin_tktlock64_acquire() always returns true)*/
+__attribute_nonnull__()
+PLASMA_SPIN_C99INLINE
+bool
+plasma_spin_tktlock64_acquire (plasma_spin_tktlock64_t * const restrict spin);
+#ifdef PLASMA_SPIN_C99INLINE_FUNCS
+PLASMA_SPIN_C99INLINE
+bool
+plasma_spin_tktlock64_acquire (plasma_spin_tktlock64_t * const restrict spin)
+{
+    const uint64_t tkt = /* increment ticket count (high 32-bits of lck) */
+      plasma_atomic_fetch_add_u64(&spin->lck.u, PLASMA_SPIN_TKTLOCK64_TKTINC,
+                                  memory_order_relaxed);
+    if (__builtin_expect(
+          (PLASMA_SPIN_TKTLOCK64_SHIFT(tkt)
+           == PLASMA_SPIN_TKTLOCK64_MASK(tkt)), 1)) {
+        plasma_membar_atomic_thread_fence_acq_rel();
+        PLASMA_SPIN_STATS_ACQUIRED(spin);
+        return true;
+    }
+    return plasma_spin_tktlock64_acquire_spinloop(spin, tkt);
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_SPIN_C99INLINE
+void
+plasma_spin_tktlock64_release (plasma_spin_tktlock64_t * const restrict spin);
+#ifdef PLASMA_SPIN_C99INLINE_FUNCS
+PLASMA_SPIN_C99INLINE
+void
+plasma_spin_tktlock64_release (plasma_spin_tktlock64_t * const restrict spin)
+{
+    /* increment ticket num ready to be served (low 32-bits of lck)
+     * (see plasma_spin_tktlock_release() for notes on union store) */
+    __attribute_may_alias__
+  #if defined(__LITTLE_ENDIAN__)
+    uint32_t * const ptr = &spin->lck.t.le;
+  #elif defined(__BIG_ENDIAN__)
+    uint32_t * const ptr = &spin->lck.t.be;
+  #endif
+    const uint32_t n = *ptr + 1u;
+    PLASMA_SPIN_STATS_RELEASED(spin);
     plasma_atomic_store_explicit(ptr, n, memory_order_release);
 }
 #endif
@@ -570,6 +1009,7 @@ plasma_spin_taglock_acquire_try (plasma_spin_taglock_t * const restrict taglock)
          * (so decrement lck since taglock_release will increment lck) */
         *lck = PLASMA_SPIN_TAGLOCK_LOCKVAL(cmp-1);
         plasma_membar_atomic_thread_fence_acq_rel();
+        PLASMA_SPIN_STATS_ACQUIRED(taglock);
         return true;
     }
     return false;
@@ -579,6 +1019,7 @@ plasma_spin_taglock_acquire_try (plasma_spin_taglock_t * const restrict taglock)
     if (cmp == PLASMA_SPIN_TAGLOCK_MASK(taglock->tag)/*(jump queue:(cmp - 1))*/
         && plasma_atomic_CAS_32(lck,cmp,PLASMA_SPIN_TAGLOCK_LOCKVAL(cmp - 1))) {
         plasma_membar_atomic_thread_fence_acq_rel();
+        PLASMA_SPIN_STATS_ACQUIRED(taglock);
         return true;
     }
     return false;
@@ -598,6 +1039,36 @@ bool
 plasma_spin_taglock_acquire_urgent (plasma_spin_taglock_t *
                                       const restrict taglock);
 
+/* NOTE: plasma_spin_taglock_acquire_backoff() stores critical section estimate
+ * in taglock->udata64 (taglock has no udata32), so udata64 is not available
+ * for user data if used  (see plasma_spin_tktlock_acquire_backoff()) */
+__attribute_nonnull__()
+bool
+plasma_spin_taglock_acquire_backoff (plasma_spin_taglock_t *
+                                       const restrict taglock);
+
+/* plasma_spin_taglock_acquire_until()
+ * plasma_spin_taglock_acquire_for()
+ *
+ * Timed acquire; returns false if lock not obtained by deadline.
+ * Waiter which times out abandons its tag.  lck counts tags served, so an
+ * abandoned tag must still be counted once, and only while the batch of the
+ * tag is current (else lck might pass the batch of waiters still waiting).
+ * If tag is last tag issued, waiter returns tag (CAS tag back), else waiter
+ * waits until batch of tag is current and then counts tag by incrementing lck
+ * (CAS) while lock is free.  Waiter further back than current batch when
+ * deadline expires therefore continues waiting (yielding) until its batch is
+ * current.  Lock is released with plasma_spin_taglock_release().
+ */
+__attribute_nonnull__()
+bool
+plasma_spin_taglock_acquire_until (plasma_spin_taglock_t *
+                                     const restrict taglock,
+                                   const uint64_t deadline);
+
+#define plasma_spin_taglock_acquire_for(taglock, ns) \
+        plasma_spin_taglock_acquire_until((taglock),plasma_spin_clock_ns()+(ns))
+
 
 __attribute_nonnull__()
 PLASMA_SPIN_C99INLINE
@@ -609,60 +1080,1025 @@ void
 plasma_spin_taglock_release (plasma_spin_taglock_t * const restrict taglock)
 {
     uint32_t * const restrict lck = &taglock->lck;
+    PLASMA_SPIN_STATS_RELEASED(taglock);
     plasma_atomic_store_explicit(lck, PLASMA_SPIN_TAGLOCK_UNLOCKVAL(1u+*lck),
                                  memory_order_release);
 }
 #endif
 
 
-#ifdef __cplusplus
-}
-#endif
+/* plasma_spin_taglock32_*()  tag lock in single 32-bit word
+ *
+ * plasma_spin_taglock32_init()
+ * plasma_spin_taglock32_is_free()
+ * plasma_spin_taglock32_is_contended()
+ * plasma_spin_taglock32_acquire()
+ * plasma_spin_taglock32_acquire_try()
+ * plasma_spin_taglock32_acquire_urgent()
+ * plasma_spin_taglock32_release()
+ *
+ * Same batch semantics as plasma_spin_taglock, but with tag (high 16-bits) and
+ * lck (low 16-bits: 15-bit count of tags served, and lock bit) in one 32-bit
+ * word.  Uncontended acquire is a single CAS which both takes tag and sets
+ * lock bit (plasma_spin_taglock_acquire() takes two atomic ops); contended
+ * acquire takes tag with fetch_add and proceeds as plasma_spin_taglock.
+ * Release is a 16-bit atomic store to lck (see plasma_spin_tktlock_release()).
+ * plasma_spin_taglock32_acquire_try() succeeds only if lock is free and not
+ * contended (does not jump queue), while plasma_spin_taglock32_acquire_urgent()
+ * jumps queue as does plasma_spin_taglock_acquire_urgent().
+ *
+ * Note: limit of 32767 simultaneous waiters (plus one holding lock)
+ */
+
+typedef __attribute_aligned__(16)
+struct plasma_spin_taglock32_t {
+    union { uint32_t u; struct { uint16_t le; uint16_t be; } t; } lck;
+    uint32_t udata32; /* user data 4-bytes */
+    uint64_t udata64; /* user data 8-bytes */
+} plasma_spin_taglock32_t;
+
+#define PLASMA_SPIN_TAGLOCK32_TAGMAX       0x7FFFu
+#define PLASMA_SPIN_TAGLOCK32_TAGINC       0x10000u
+#define PLASMA_SPIN_TAGLOCK32_ORVAL        0x8000u
+#define PLASMA_SPIN_TAGLOCK32_LCK(x)       ((x) & PLASMA_SPIN_TAGLOCK32_TAGMAX)
+#define PLASMA_SPIN_TAGLOCK32_TAG(x)       \
+        (((x) >> 16) & PLASMA_SPIN_TAGLOCK32_TAGMAX)
+#define PLASMA_SPIN_TAGLOCK32_IS_LOCKED(x) ((x) & PLASMA_SPIN_TAGLOCK32_ORVAL)
+#define PLASMA_SPIN_TAGLOCK32_IS_CONTENDED(x) \
+        (PLASMA_SPIN_TAGLOCK32_TAG(x) != PLASMA_SPIN_TAGLOCK32_LCK(x))
 
+#if (defined(__STDC_VERSION__) && __STDC_VERSION__-0 >= 199901L) /* C99 */
+#define PLASMA_SPIN_TAGLOCK32_INITIALIZER \
+        {.lck.u = 0, .udata32 = 0, .udata64 = 0}
+#else
+#define PLASMA_SPIN_TAGLOCK32_INITIALIZER { { 0 }, 0, 0 }
 #endif
+#define plasma_spin_taglock32_init(t) \
+        ((t)->lck.u = 0, (t)->udata32 = 0, (t)->udata64 = 0)
 
+#define plasma_spin_taglock32_is_free(taglock) \
+        (!PLASMA_SPIN_TAGLOCK32_IS_LOCKED((taglock)->lck.u))
 
+#define plasma_spin_taglock32_is_contended(taglock) \
+        PLASMA_SPIN_TAGLOCK32_IS_CONTENDED((taglock)->lck.u)
 
+/*(plasma_spin_taglock32_acquire_spinloop() always returns true)*/
+__attribute_noinline__
+__attribute_nonnull__()
+bool
+plasma_spin_taglock32_acquire_spinloop (plasma_spin_taglock32_t *
+                                          const restrict taglock);
 
-/* NOTES and REFERENCES
- *
- * Discussions about spinning and performance:
- *
- * http://www.1024cores.net/home/lock-free-algorithms/tricks/spinning
- * http://software.intel.com/en-us/articles/implementing-scalable-atomic-locks-for-multi-core-intel-em64t-and-ia32-architectures/
- * http://stackoverflow.com/questions/11923151/is-there-any-simple-way-to-improve-performance-of-this-spinlock-function
- * http://stackoverflow.com/questions/11959374/fastest-inline-assembly-spinlock
- * http://locklessinc.com/articles/priority_locks/
- * http://locklessinc.com/articles/locks/
- * http://www.embedded.com/electronics-blogs/beginner-s-corner/4023947/Introduction-to-Priority-Inversion
- *
- * http://www.1024cores.net/home/lock-free-algorithms/tricks/spinning
- *   "On Linux passive spinning is implemented with pthread_yield(), or nanosleep() for "deeper" spin."  [Ed: pthread_yield() not portable; sched_yield() is]
- *   "On Windows situation is a bit more involved. There is SwitchToThread() which is limited to the current processor. There is Sleep(0) which is limited to threads of no-less priority (it's unclear as to whether it's intra-processor or inter-processor). Finally, there is Sleep(1) which should cover all cases (all priorities/all processors)."
- *    [See section Hybrid spinning for sample do_backoff() routine]
- *
- * http://cbloomrants.blogspot.com/2011/07/07-29-11-spinning.html
- *   "Obviously a good software engineer doesn't just randomly stick calls to STT or whatever in their spin loops, they make a function like MySpinYield() and call their function so that they can encapsulate the tricky platform-specific knowledge in one place. It just staggers me how rarely I see anyone do things like this.
- *   "But really you shouldn't EVER do a spin-wait on Windows. There's no reason for it. Any place you are tempted to use a spin-wait, use an "eventcount" instead and do a proper wait. (perhaps after a few spins, but only if you have very good reason to believe those spins actually help)
- *   "BTW I've written about the balanced set manager in detail here :
-http://cbloomrants.blogspot.com/2010/09/09-12-10-defficiency-of-windows-multi.html "
- *
- * SwitchToThread()
- * http://msdn.microsoft.com/en-us/library/windows/desktop/ms686352%28v=vs.85%29.aspx
- *
- * Sleep(1)
- * http://msdn.microsoft.com/en-us/library/windows/desktop/ms686298%28v=vs.85%29.aspx
- * http://www.bluebytesoftware.com/blog/2006/08/23/PriorityinducedStarvationWhySleep1IsBetterThanSleep0AndTheWindowsBalanceSetManager.aspx
- *
- * timeBeginPeriod(1)  (set default system quantum to 1ms instead of 10-15ms)
- * (generally not a good idea to do this for extended periods of time)
- * http://msdn.microsoft.com/en-us/library/windows/desktop/dd757624%28v=vs.85%29.aspx
- * http://cbloomrants.blogspot.com/2010/09/09-12-10-defficiency-of-windows-multi.html
- * http://msdn.microsoft.com/en-us/library/ms713413%28v=vs.85%29.aspx
- * http://stackoverflow.com/questions/7590475/why-does-increasing-timer-resolution-via-timebeginperiod-impact-power-consumptio
- * http://stackoverflow.com/questions/7685762/windows-7-timing-functions-how-to-use-getsystemtimeadjustment-correctly/11743614#11743614
- * Timers, Timer Resolution, and Development of Efficient Code
- * http://msdn.microsoft.com/en-us/windows/hardware/gg463266.aspx
+__attribute_nonnull__()
+PLASMA_SPIN_C99INLINE
+bool
+plasma_spin_taglock32_acquire_try (plasma_spin_taglock32_t *
+                                     const restrict taglock);
+#ifdef PLASMA_SPIN_C99INLINE_FUNCS
+PLASMA_SPIN_C99INLINE
+bool
+plasma_spin_taglock32_acquire_try (plasma_spin_taglock32_t *
+                                     const restrict taglock)
+{
+    /* take tag and set lock bit in single CAS if not locked and not contended*/
+    const uint32_t cmp =
+      plasma_atomic_load_explicit(&taglock->lck.u, memory_order_relaxed);
+    if (!PLASMA_SPIN_TAGLOCK32_IS_LOCKED(cmp)
+        && !PLASMA_SPIN_TAGLOCK32_IS_CONTENDED(cmp)
+        && plasma_atomic_CAS_32(&taglock->lck.u, cmp,
+                                cmp + PLASMA_SPIN_TAGLOCK32_TAGINC
+                                    + PLASMA_SPIN_TAGLOCK32_ORVAL)) {
+        plasma_membar_atomic_thread_fence_acq_rel();
+        PLASMA_SPIN_STATS_ACQUIRED(taglock);
+        return true;
+    }
+    return false;
+}
+#endif
+
+/*(plasma_spin_taglock32_acquire() always returns true)*/
+__attribute_nonnull__()
+PLASMA_SPIN_C99INLINE
+bool
+plasma_spin_taglock32_acquire (plasma_spin_taglock32_t *
+                                 const restrict taglock);
+#ifdef PLASMA_SPIN_C99INLINE_FUNCS
+PLASMA_SPIN_C99INLINE
+bool
+plasma_spin_taglock32_acquire (plasma_spin_taglock32_t *
+                                 const restrict taglock)
+{
+    return __builtin_expect(plasma_spin_taglock32_acquire_try(taglock), 1)
+        || plasma_spin_taglock32_acquire_spinloop(taglock);
+}
+#endif
+
+/* NOTE: plasma_spin_taglock32_acquire_urgent() is *unfair*
+ * (but that is the point); avoid many urgent contenders */
+__attribute_nonnull__()
+bool
+plasma_spin_taglock32_acquire_urgent (plasma_spin_taglock32_t *
+                                        const restrict taglock);
+
+__attribute_nonnull__()
+PLASMA_SPIN_C99INLINE
+void
+plasma_spin_taglock32_release (plasma_spin_taglock32_t *
+                                 const restrict taglock);
+#ifdef PLASMA_SPIN_C99INLINE_FUNCS
+PLASMA_SPIN_C99INLINE
+void
+plasma_spin_taglock32_release (plasma_spin_taglock32_t *
+                                 const restrict taglock)
+{
+    /* increment count of tags served and clear lock bit (low 16-bits of lck)
+     * (see plasma_spin_tktlock_release() for notes on 16-bit union store) */
+    __attribute_may_alias__
+  #if defined(__LITTLE_ENDIAN__)
+    uint16_t * const ptr = &taglock->lck.t.le;
+  #elif defined(__BIG_ENDIAN__)
+    uint16_t * const ptr = &taglock->lck.t.be;
+  #endif
+    const uint16_t n = (uint16_t)PLASMA_SPIN_TAGLOCK32_LCK(*ptr + 1u);
+    PLASMA_SPIN_STATS_RELEASED(taglock);
+    plasma_atomic_store_explicit(ptr, n, memory_order_release);
+}
+#endif
+
+
+/* plasma_spin_mcslock_*()  MCS queue lock (Mellor-Crummey and Scott)
+ * (see bottom of file for MCS lock references)
+ *
+ * plasma_spin_mcslock_init()
+ * plasma_spin_mcslock_acquire()
+ * plasma_spin_mcslock_acquire_try()
+ * plasma_spin_mcslock_acquire_spinloop()
+ * plasma_spin_mcslock_release()
+ *
+ * Each contender provides a plasma_spin_mcslock_node_t and is appended to the
+ * queue with a single atomic exchange on the lock tail.  Waiters then spin on
+ * the lck flag in their own node, instead of all waiters spinning on a single
+ * shared lock word (as with plasma_spin_tktlock), and the lock holder hands off
+ * the lock by clearing lck in the node of its successor.  Each release
+ * therefore invalidates the cache line of a single waiter rather than the
+ * cache lines of all waiters, which matters once contenders span sockets.
+ * Waiters spin for up to PLASMA_SPIN_MCSLOCK_SPIN_NS nanoseconds and then
+ * park (plasma_futex_wait() on lck in their own node), marking lck so that
+ * handoff wakes the parked successor (plasma_futex_wake_one()).  Lock is
+ * strictly FIFO, so handoff to a parked successor costs a wakeup even when
+ * other threads are running; prefer plasma_spin_futexlock if that matters.
+ *
+ * Node must remain valid from acquire until release returns, must be passed
+ * to release by the thread that acquired the lock, and must not be enqueued
+ * on more than one lock at a time.  A node on the stack of the thread
+ * acquiring the lock is typical.  For best performance, node should not share
+ * a cache line with other nodes or with the lock.
+ */
+
+typedef __attribute_aligned__(16)
+struct plasma_spin_mcslock_node_t {
+    struct plasma_spin_mcslock_node_t *next;
+    uint32_t lck;
+    uint32_t udata32; /* user data 4-bytes */
+} plasma_spin_mcslock_node_t;
+
+typedef __attribute_aligned__(16)
+struct plasma_spin_mcslock_t {
+    plasma_spin_mcslock_node_t *tail;
+    uint64_t udata64; /* user data 8-bytes */
+} plasma_spin_mcslock_t;
+
+#if (defined(__STDC_VERSION__) && __STDC_VERSION__-0 >= 199901L) /* C99 */
+#define PLASMA_SPIN_MCSLOCK_INITIALIZER { .tail = NULL, .udata64 = 0 }
+#else
+#define PLASMA_SPIN_MCSLOCK_INITIALIZER { NULL, 0 }
+#endif
+#define plasma_spin_mcslock_init(m) ((m)->tail = NULL, (m)->udata64 = 0)
+
+#define plasma_spin_mcslock_is_free(m) \
+        (plasma_atomic_load_explicit(&(m)->tail, memory_order_relaxed) == NULL)
+
+/* node->lck: 0 lock handed off, 1 waiting, 2 waiting and (possibly) parked */
+#define PLASMA_SPIN_MCSLOCK_WAITING  1u
+#define PLASMA_SPIN_MCSLOCK_PARKED   2u
+
+#ifndef PLASMA_SPIN_MCSLOCK_SPIN_NS
+#define PLASMA_SPIN_MCSLOCK_SPIN_NS  4000
+#endif
+
+/*(plasma_spin_mcslock_acquire_spinloop() always returns true)*/
+__attribute_noinline__
+__attribute_nonnull__()
+bool
+plasma_spin_mcslock_acquire_spinloop (plasma_spin_mcslock_node_t *
+                                        const restrict node,
+                                      plasma_spin_mcslock_node_t *
+                                        const restrict prev);
+
+__attribute_noinline__
+__attribute_nonnull__()
+plasma_spin_mcslock_node_t *
+plasma_spin_mcslock_release_spinloop (plasma_spin_mcslock_node_t *
+                                        const restrict node);
+
+__attribute_noinline__
+__attribute_nonnull__()
+void
+plasma_spin_mcslock_wake (plasma_spin_mcslock_node_t * const restrict node);
+
+/*(plasma_spin_mcslock_acquire() always returns true)*/
+__attribute_nonnull__()
+PLASMA_SPIN_C99INLINE
+bool
+plasma_spin_mcslock_acquire (plasma_spin_mcslock_t * const restrict mcs,
+                             plasma_spin_mcslock_node_t * const restrict node);
+#ifdef PLASMA_SPIN_C99INLINE_FUNCS
+PLASMA_SPIN_C99INLINE
+bool
+plasma_spin_mcslock_acquire (plasma_spin_mcslock_t * const restrict mcs,
+                             plasma_spin_mcslock_node_t * const restrict node)
+{
+    plasma_spin_mcslock_node_t *prev;
+    node->next = NULL;
+    node->lck  = PLASMA_SPIN_MCSLOCK_WAITING;
+    /*(atomic exchange publishes node initialization above)*/
+    prev = (plasma_spin_mcslock_node_t *)
+      plasma_atomic_exchange_n_ptr((void **)&mcs->tail, (void *)node,
+                                   memory_order_acq_rel);
+    if (__builtin_expect( (prev == NULL), 1))
+        return true;
+    return plasma_spin_mcslock_acquire_spinloop(node, prev);
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_SPIN_C99INLINE
+bool
+plasma_spin_mcslock_acquire_try (plasma_spin_mcslock_t * const restrict mcs,
+                                 plasma_spin_mcslock_node_t *
+                                   const restrict node);
+#ifdef PLASMA_SPIN_C99INLINE_FUNCS
+PLASMA_SPIN_C99INLINE
+bool
+plasma_spin_mcslock_acquire_try (plasma_spin_mcslock_t * const restrict mcs,
+                                 plasma_spin_mcslock_node_t *
+                                   const restrict node)
+{
+    node->next = NULL;
+    if (plasma_atomic_load_explicit(&mcs->tail, memory_order_relaxed) == NULL
+        && plasma_atomic_CAS_ptr((void **)&mcs->tail, NULL, node)) {
+        plasma_membar_atomic_thread_fence_acq_rel();
+        return true;
+    }
+    return false;
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_SPIN_C99INLINE
+void
+plasma_spin_mcslock_release (plasma_spin_mcslock_t * const restrict mcs,
+                             plasma_spin_mcslock_node_t * const restrict node);
+#ifdef PLASMA_SPIN_C99INLINE_FUNCS
+PLASMA_SPIN_C99INLINE
+void
+plasma_spin_mcslock_release (plasma_spin_mcslock_t * const restrict mcs,
+                             plasma_spin_mcslock_node_t * const restrict node)
+{
+    /* (acquire pairs with successor store-release of node->next, ordering
+     *  successor initialization of its node before handoff store below) */
+    plasma_spin_mcslock_node_t *next =
+      plasma_atomic_load_explicit(&node->next, memory_order_acquire);
+    if (next == NULL) {
+        /* no known successor; attempt to swing tail back to empty */
+        atomic_thread_fence(memory_order_release);
+        if (plasma_atomic_CAS_ptr((void **)&mcs->tail, node, NULL))
+            return;
+        /* successor swapped tail, but has not yet linked into node->next */
+        next = plasma_spin_mcslock_release_spinloop(node);
+    }
+    /* hand off lock; system call to wake successor only if it parked */
+    if (__builtin_expect(
+          (plasma_atomic_exchange_n_32(&next->lck, 0u, memory_order_release)
+           == PLASMA_SPIN_MCSLOCK_PARKED), 0))
+        plasma_spin_mcslock_wake(next);
+}
+#endif
+
+
+/* plasma_spin_clhlock_*()  CLH queue lock (Craig, Landin and Hagersten)
+ * (see bottom of file for CLH lock references)
+ *
+ * plasma_spin_clhlock_init()
+ * plasma_spin_clhlock_acquire()
+ * plasma_spin_clhlock_acquire_try()
+ * plasma_spin_clhlock_release()
+ *
+ * Each contender swaps its node into the lock tail with a single atomic
+ * exchange and spins on the lck flag in the node of its predecessor.  Lock
+ * holder releases the lock by clearing lck in its own node, and successor then
+ * takes ownership of that node for reuse.  Waiters spin for up to
+ * PLASMA_SPIN_CLHLOCK_SPIN_NS nanoseconds and then park (plasma_futex_wait()
+ * on lck in predecessor node), marking lck so that release wakes the parked
+ * successor (plasma_futex_wake_one()).  Nodes are recycled implicitly
+ * through a small thread-local free list, so (unlike plasma_spin_mcslock) the
+ * caller does not provide a node, and plasma_spin_clhlock can be used in place
+ * of plasma_spin_lock where a per-call MCS node is awkward, e.g. where lock
+ * acquire and release are in different functions.  Lock must be released by
+ * the thread which acquired it.
+ *
+ * plasma_spin_clhlock_acquire() returns false only if thread has no free node
+ * and allocation of a new node fails (rare; first acquire by a thread)
+ *
+ * Nodes are allocated on demand (one per thread plus one per lock concurrently
+ * held by thread) and are freed when thread exits (POSIX).  Lock must not be
+ * held or contended when its storage is reused (same as other plasma_spin).
+ */
+
+struct plasma_spin_clhlock_node_t;  /*(opaque; nodes managed internally)*/
+
+typedef __attribute_aligned__(16)
+struct plasma_spin_clhlock_t {
+    struct plasma_spin_clhlock_node_t *tail;
+    struct plasma_spin_clhlock_node_t *node;  /* node of current lock holder */
+} plasma_spin_clhlock_t;
+
+#if (defined(__STDC_VERSION__) && __STDC_VERSION__-0 >= 199901L) /* C99 */
+#define PLASMA_SPIN_CLHLOCK_INITIALIZER { .tail = NULL, .node = NULL }
+#else
+#define PLASMA_SPIN_CLHLOCK_INITIALIZER { NULL, NULL }
+#endif
+#define plasma_spin_clhlock_init(c) ((c)->tail = NULL, (c)->node = NULL)
+
+#define plasma_spin_clhlock_is_free(c) \
+        (plasma_atomic_load_explicit(&(c)->tail, memory_order_relaxed) == NULL)
+
+#ifndef PLASMA_SPIN_CLHLOCK_SPIN_NS
+#define PLASMA_SPIN_CLHLOCK_SPIN_NS  4000
+#endif
+
+__attribute_nonnull__()
+bool
+plasma_spin_clhlock_acquire (plasma_spin_clhlock_t * const restrict clh);
+
+__attribute_nonnull__()
+bool
+plasma_spin_clhlock_acquire_try (plasma_spin_clhlock_t * const restrict clh);
+
+__attribute_nonnull__()
+void
+plasma_spin_clhlock_release (plasma_spin_clhlock_t * const restrict clh);
+
+
+/* plasma_spin_clhtolock_*()  abortable CLH queue lock (with timeout)
+ * (see bottom of file for CLH lock references)
+ *
+ * plasma_spin_clhtolock_init()
+ * plasma_spin_clhtolock_is_free()
+ * plasma_spin_clhtolock_acquire()
+ * plasma_spin_clhtolock_acquire_until()
+ * plasma_spin_clhtolock_acquire_for()
+ * plasma_spin_clhtolock_acquire_try()
+ * plasma_spin_clhtolock_release()
+ *
+ * Queue lock in which a waiter can leave the queue on timeout, so that waiters
+ * are not stalled behind a preempted waiter which gives up.  (Strict FIFO locks
+ * such as plasma_spin_tktlock stall all waiters behind a sleeping waiter;
+ * plasma_spin_taglock mitigates with batches, but does not scale as a queue
+ * lock does.)  Each node holds pointer to predecessor node: NULL while owner
+ * waits or holds lock, a sentinel when owner releases lock, or predecessor
+ * node of owner when owner aborts.  A waiter spins on the node of its
+ * predecessor, and, if predecessor aborted, reclaims predecessor node and
+ * resumes spinning on node to which aborted node points, repairing the chain.
+ * Aborting waiter which is last in queue instead swings tail back to its
+ * predecessor.  Nodes are managed as for plasma_spin_clhlock (shared
+ * thread-local free list).  Lock must be released by thread which acquired it.
+ *
+ * plasma_spin_clhtolock_acquire_until() returns false if lock not obtained by
+ * deadline (plasma_spin_clock_ns() time), or if thread has no free node and
+ * allocation of a new node fails (rare).  plasma_spin_clhtolock_acquire()
+ * waits without deadline.  plasma_spin_clhtolock_acquire_try() enqueues as
+ * plasma_spin_clhtolock_acquire_until() with a deadline which has already
+ * passed, and so obtains lock if predecessor node (if any) has been released,
+ * and otherwise aborts at once without waiting.
+ *
+ * Note: waiter at tail of queue which aborts after predecessor releases lock
+ * swings tail back to released node, and plasma_spin_clhtolock_is_free() then
+ * reports lock held until the next acquire (including acquire_try) passes
+ * through released node.  (plasma_spin_clhtolock_is_free() reads only tail;
+ * released node might be reclaimed and freed concurrently by another thread)
+ */
+
+typedef __attribute_aligned__(16)
+struct plasma_spin_clhtolock_t {
+    struct plasma_spin_clhlock_node_t *tail;
+    struct plasma_spin_clhlock_node_t *node;  /* node of current lock holder */
+} plasma_spin_clhtolock_t;
+
+#if (defined(__STDC_VERSION__) && __STDC_VERSION__-0 >= 199901L) /* C99 */
+#define PLASMA_SPIN_CLHTOLOCK_INITIALIZER { .tail = NULL, .node = NULL }
+#else
+#define PLASMA_SPIN_CLHTOLOCK_INITIALIZER { NULL, NULL }
+#endif
+#define plasma_spin_clhtolock_init(c) ((c)->tail = NULL, (c)->node = NULL)
+
+#define plasma_spin_clhtolock_is_free(c) \
+        (plasma_atomic_load_explicit(&(c)->tail, memory_order_relaxed) == NULL)
+
+__attribute_nonnull__()
+bool
+plasma_spin_clhtolock_acquire_until (plasma_spin_clhtolock_t *
+                                       const restrict clh,
+                                     const uint64_t deadline);
+
+#define plasma_spin_clhtolock_acquire_for(clh, ns) \
+        plasma_spin_clhtolock_acquire_until((clh),plasma_spin_clock_ns()+(ns))
+
+#define plasma_spin_clhtolock_acquire(clh) \
+        plasma_spin_clhtolock_acquire_until((clh), UINT64_MAX)
+
+#define plasma_spin_clhtolock_acquire_try(clh) \
+        plasma_spin_clhtolock_acquire_until((clh), 0)
+
+__attribute_nonnull__()
+void
+plasma_spin_clhtolock_release (plasma_spin_clhtolock_t * const restrict clh);
+
+
+/* plasma_spin_futexlock_*()  spin-then-park hybrid lock
+ * (see bottom of file for futex references)
+ *
+ * plasma_spin_futexlock_init()
+ * plasma_spin_futexlock_acquire()
+ * plasma_spin_futexlock_acquire_try()
+ * plasma_spin_futexlock_acquire_spinloop()
+ * plasma_spin_futexlock_release()
+ *
+ * Contended acquire spins briefly (pause, then bursts of pause), and then
+ * parks the thread (plasma_futex_wait() on the lock word) until woken by
+ * release.  Lock word has three states: 0 unlocked, 1 locked,
+ * 2 locked with (possible) waiters.  Uncontended acquire is a single CAS, and
+ * release is a single atomic exchange, calling plasma_futex_wake_one() only
+ * when the lock word indicates that there might be parked waiters.
+ * Behaves similarly to an adaptive mutex under oversubscription (more runnable
+ * threads than CPUs), where spinning or yielding would otherwise burn CPU and
+ * cause lock convoys, while keeping a faster uncontended path.
+ * (On platforms without wait-on-address, see plasma_futex.h for fallback.)
+ *
+ * Lock is not fair.  Lock must be released by the thread which acquired it.
+ *
+ * PLASMA_SPIN_FUTEXLOCK_PAUSE1 and PLASMA_SPIN_FUTEXLOCK_PAUSE32 are the
+ * default spin counts prior to parking (see plasma_spin_lock_acquire_spindecay)
+ */
+
+typedef __attribute_aligned__(16)
+struct plasma_spin_futexlock_t {
+    uint32_t lck;
+    uint32_t udata32; /* user data 4-bytes */
+    uint64_t udata64; /* user data 8-bytes */
+} plasma_spin_futexlock_t;
+
+#define PLASMA_SPIN_FUTEXLOCK_UNLOCKED   0u
+#define PLASMA_SPIN_FUTEXLOCK_LOCKED     1u
+#define PLASMA_SPIN_FUTEXLOCK_WAITERS    2u
+
+#ifndef PLASMA_SPIN_FUTEXLOCK_PAUSE1
+#define PLASMA_SPIN_FUTEXLOCK_PAUSE1     32
+#endif
+#ifndef PLASMA_SPIN_FUTEXLOCK_PAUSE32
+#define PLASMA_SPIN_FUTEXLOCK_PAUSE32    8
+#endif
+
+#if (defined(__STDC_VERSION__) && __STDC_VERSION__-0 >= 199901L) /* C99 */
+#define PLASMA_SPIN_FUTEXLOCK_INITIALIZER { .lck = 0, .udata32=0, .udata64=0 }
+#else
+#define PLASMA_SPIN_FUTEXLOCK_INITIALIZER { 0, 0, 0 }
+#endif
+#define plasma_spin_futexlock_init(f) \
+        ((f)->lck = 0, (f)->udata32 = 0, (f)->udata64 = 0)
+
+#define plasma_spin_futexlock_is_free(f) \
+        (plasma_atomic_load_explicit(&(f)->lck, memory_order_relaxed) \
+         == PLASMA_SPIN_FUTEXLOCK_UNLOCKED)
+
+/*(plasma_spin_futexlock_acquire_spinloop() always returns true)*/
+__attribute_noinline__
+__attribute_nonnull__()
+bool
+plasma_spin_futexlock_acquire_spinloop (plasma_spin_futexlock_t *
+                                          const restrict spin);
+
+__attribute_noinline__
+__attribute_nonnull__()
+void
+plasma_spin_futexlock_wake (plasma_spin_futexlock_t * const restrict spin);
+
+__attribute_nonnull__()
+PLASMA_SPIN_C99INLINE
+bool
+plasma_spin_futexlock_acquire_try (plasma_spin_futexlock_t *
+                                     const restrict spin);
+#ifdef PLASMA_SPIN_C99INLINE_FUNCS
+PLASMA_SPIN_C99INLINE
+bool
+plasma_spin_futexlock_acquire_try (plasma_spin_futexlock_t *
+                                     const restrict spin)
+{
+    if (plasma_atomic_CAS_32(&spin->lck, PLASMA_SPIN_FUTEXLOCK_UNLOCKED,
+                                         PLASMA_SPIN_FUTEXLOCK_LOCKED)) {
+        plasma_membar_atomic_thread_fence_acq_rel();
+        return true;
+    }
+    return false;
+}
+#endif
+
+/*(plasma_spin_futexlock_acquire() always returns true)*/
+__attribute_nonnull__()
+PLASMA_SPIN_C99INLINE
+bool
+plasma_spin_futexlock_acquire (plasma_spin_futexlock_t * const restrict spin);
+#ifdef PLASMA_SPIN_C99INLINE_FUNCS
+PLASMA_SPIN_C99INLINE
+bool
+plasma_spin_futexlock_acquire (plasma_spin_futexlock_t * const restrict spin)
+{
+    return plasma_spin_futexlock_acquire_try(spin)
+        || plasma_spin_futexlock_acquire_spinloop(spin);
+}
+#endif
+
+/* plasma_spin_futexlock_acquire_adaptive()
+ *   spin for self-tuned budget before parking, in place of fixed
+ *   PLASMA_SPIN_FUTEXLOCK_PAUSE1 and PLASMA_SPIN_FUTEXLOCK_PAUSE32
+ *   (see plasma_spin_lock_acquire_adaptive())
+ * Spin budget is stored in spin->udata32, so udata32 is not available for
+ * user data if lock is acquired with plasma_spin_futexlock_acquire_adaptive()*/
+/*(plasma_spin_futexlock_acquire_adaptive() always returns true)*/
+__attribute_nonnull__()
+bool
+plasma_spin_futexlock_acquire_adaptive (plasma_spin_futexlock_t *
+                                          const restrict spin);
+
+__attribute_nonnull__()
+PLASMA_SPIN_C99INLINE
+void
+plasma_spin_futexlock_release (plasma_spin_futexlock_t * const restrict spin);
+#ifdef PLASMA_SPIN_C99INLINE_FUNCS
+PLASMA_SPIN_C99INLINE
+void
+plasma_spin_futexlock_release (plasma_spin_futexlock_t * const restrict spin)
+{
+    /* system call to wake a waiter only if waiters might be parked */
+    if (__builtin_expect(
+          (plasma_atomic_exchange_n_32(&spin->lck,
+                                       PLASMA_SPIN_FUTEXLOCK_UNLOCKED,
+                                       memory_order_release)
+           == PLASMA_SPIN_FUTEXLOCK_WAITERS), 0))
+        plasma_spin_futexlock_wake(spin);
+}
+#endif
+
+
+/* plasma_spin_rwlock_*()  reader-writer spin lock
+ * (see bottom of file for reader-writer lock references)
+ *
+ * plasma_spin_rwlock_init()
+ * plasma_spin_rwlock_rdlock()
+ * plasma_spin_rwlock_tryrdlock()
+ * plasma_spin_rwlock_wrlock()
+ * plasma_spin_rwlock_trywrlock()
+ * plasma_spin_rwlock_rdunlock()
+ * plasma_spin_rwlock_wrunlock()
+ * plasma_spin_rwlock_unlock()
+ *
+ * Readers share the lock; writers are exclusive.  Writers are served in FIFO
+ * order by a ticket lock (16-bit halves, as in plasma_spin_tktlock).  Readers
+ * announce themselves with atomic fetch_add on rin and depart with fetch_add
+ * on rout, so concurrent readers do not serialize.  Lock mode is chosen at
+ * init:
+ *
+ * PLASMA_SPIN_RWLOCK_WRPREF     writer-preferring
+ *   arriving readers wait while any writer holds or is waiting for the lock
+ *   (readers might starve under continuous writer load)
+ * PLASMA_SPIN_RWLOCK_PHASEFAIR  phase-fair ticket (Brandenburg and Anderson)
+ *   reader and writer phases alternate: readers arriving while a writer holds
+ *   or waits enter together after that writer, and a writer waits only for
+ *   readers which arrived before it; neither readers nor writers starve
+ *
+ * plasma_spin_rwlock_unlock() releases either a read lock or write lock held
+ * by caller (writer records ownership in wlocked, accessed only by holder).
+ * Callers which know which lock is held might call rdunlock() or wrunlock().
+ *
+ * Note: limit of 65535 writers simultaneously waiting (see tktlock)
+ * Note: limit of 16777215 readers simultaneously holding or waiting
+ */
+
+typedef __attribute_aligned__(16)
+struct plasma_spin_rwlock_t {
+    uint32_t rin;     /* reader arrivals (high 24-bits), writer phase bits */
+    uint32_t rout;    /* reader departures (high 24-bits) */
+    union { uint32_t u; struct { uint16_t le; uint16_t be; } t; } wtkt;
+    uint16_t mode;    /* PLASMA_SPIN_RWLOCK_{WRPREF,PHASEFAIR} */
+    uint16_t wlocked; /* write-locked (accessed only by lock holder) */
+    uint32_t udata32; /* user data 4-bytes */
+    uint64_t udata64; /* user data 8-bytes */
+} plasma_spin_rwlock_t;
+
+#define PLASMA_SPIN_RWLOCK_WRPREF        0
+#define PLASMA_SPIN_RWLOCK_PHASEFAIR     1
+
+#define PLASMA_SPIN_RWLOCK_RINC          0x100u /* reader increment */
+#define PLASMA_SPIN_RWLOCK_WBITS         0x3u   /* writer bits in rin */
+#define PLASMA_SPIN_RWLOCK_PRES          0x2u   /* writer present */
+#define PLASMA_SPIN_RWLOCK_PHID          0x1u   /* writer phase id (toggled)*/
+#define PLASMA_SPIN_RWLOCK_RIN(x)        ((x) & ~PLASMA_SPIN_RWLOCK_WBITS)
+
+#if (defined(__STDC_VERSION__) && __STDC_VERSION__-0 >= 199901L) /* C99 */
+#define PLASMA_SPIN_RWLOCK_INITIALIZER_MODE(m) \
+        { .rin = 0, .rout = 0, .wtkt.u = 0, .mode = (m), .wlocked = 0, \
+          .udata32 = 0, .udata64 = 0 }
+#else
+#define PLASMA_SPIN_RWLOCK_INITIALIZER_MODE(m) \
+        { 0, 0, { 0 }, (m), 0, 0, 0 }
+#endif
+#define PLASMA_SPIN_RWLOCK_INITIALIZER \
+        PLASMA_SPIN_RWLOCK_INITIALIZER_MODE(PLASMA_SPIN_RWLOCK_WRPREF)
+#define plasma_spin_rwlock_init(rw, m) \
+        ((rw)->rin = 0, (rw)->rout = 0, (rw)->wtkt.u = 0, \
+         (rw)->mode = (m), (rw)->wlocked = 0, \
+         (rw)->udata32 = 0, (rw)->udata64 = 0)
+
+/*(plasma_spin_rwlock_rdlock() always returns true)*/
+__attribute_nonnull__()
+bool
+plasma_spin_rwlock_rdlock (plasma_spin_rwlock_t * const restrict rw);
+
+__attribute_nonnull__()
+bool
+plasma_spin_rwlock_tryrdlock (plasma_spin_rwlock_t * const restrict rw);
+
+/*(plasma_spin_rwlock_wrlock() always returns true)*/
+__attribute_nonnull__()
+bool
+plasma_spin_rwlock_wrlock (plasma_spin_rwlock_t * const restrict rw);
+
+__attribute_nonnull__()
+bool
+plasma_spin_rwlock_trywrlock (plasma_spin_rwlock_t * const restrict rw);
+
+__attribute_nonnull__()
+PLASMA_SPIN_C99INLINE
+void
+plasma_spin_rwlock_rdunlock (plasma_spin_rwlock_t * const restrict rw);
+#ifdef PLASMA_SPIN_C99INLINE_FUNCS
+PLASMA_SPIN_C99INLINE
+void
+plasma_spin_rwlock_rdunlock (plasma_spin_rwlock_t * const restrict rw)
+{
+    plasma_atomic_fetch_add_u32(&rw->rout, PLASMA_SPIN_RWLOCK_RINC,
+                                memory_order_release);
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_SPIN_C99INLINE
+void
+plasma_spin_rwlock_wrunlock (plasma_spin_rwlock_t * const restrict rw);
+#ifdef PLASMA_SPIN_C99INLINE_FUNCS
+PLASMA_SPIN_C99INLINE
+void
+plasma_spin_rwlock_wrunlock (plasma_spin_rwlock_t * const restrict rw)
+{
+    /* (see plasma_spin_tktlock_release() for notes on 16-bit union store) */
+    __attribute_may_alias__
+  #if defined(__LITTLE_ENDIAN__)
+    uint16_t * const ptr = &rw->wtkt.t.le;
+  #elif defined(__BIG_ENDIAN__)
+    uint16_t * const ptr = &rw->wtkt.t.be;
+  #endif
+    const uint16_t n = *ptr + (uint16_t)1u;
+    rw->wlocked = 0;
+    if (rw->mode == PLASMA_SPIN_RWLOCK_PHASEFAIR) /* end writer phase */
+        plasma_atomic_fetch_and_u32(&rw->rin, ~PLASMA_SPIN_RWLOCK_PRES,
+                                    memory_order_release);
+    plasma_atomic_store_explicit(ptr, n, memory_order_release);
+}
+#endif
+
+__attribute_nonnull__()
+PLASMA_SPIN_C99INLINE
+void
+plasma_spin_rwlock_unlock (plasma_spin_rwlock_t * const restrict rw);
+#ifdef PLASMA_SPIN_C99INLINE_FUNCS
+PLASMA_SPIN_C99INLINE
+void
+plasma_spin_rwlock_unlock (plasma_spin_rwlock_t * const restrict rw)
+{
+    if (rw->wlocked)
+        plasma_spin_rwlock_wrunlock(rw);
+    else
+        plasma_spin_rwlock_rdunlock(rw);
+}
+#endif
+
+
+/* plasma_spin_cohortlock_*()  NUMA-aware cohort lock
+ * (see bottom of file for lock cohorting references)
+ *
+ * plasma_spin_cohortlock_init()
+ * plasma_spin_cohortlock_acquire()
+ * plasma_spin_cohortlock_release()
+ *
+ * Hierarchical lock composed of a global plasma_spin_tktlock and a per-NUMA
+ * node plasma_spin_tktlock.  Contender first acquires the ticket lock for the
+ * NUMA node on which the thread is running, and then the global lock, unless
+ * the global lock was passed to the node (cohort) by the previous holder.
+ * Upon release, if other threads on the same node are waiting, the global
+ * lock is passed within the node, up to batch consecutive times, before the
+ * global lock is released and lock ownership migrates to another node.
+ * Keeping lock (and data protected by lock) within a node for a batch reduces
+ * cache line transfers across the interconnect between sockets.  The batch
+ * bound maintains fairness between nodes, similar to how batches of tags in
+ * plasma_spin_taglock (PLASMA_SPIN_TAGLOCK_BATCH()) bound unfairness.
+ *
+ * batch 0 selects default: batch size of plasma_spin_taglock (~ num CPUs)
+ *
+ * Linux: NUMA node of thread is determined from CPU on which thread is running
+ * (sched_getcpu()) and map of CPUs to nodes (/sys/devices/system/node/)
+ * Other platforms: all threads are treated as running on a single node
+ *
+ * PLASMA_SPIN_COHORTLOCK_NODES is number of per-node locks in each cohort lock
+ * (node numbers greater than or equal to this are folded (modulo) into range)
+ *
+ * Note: lock is not recursive; lock must be released by thread which acquired
+ * it (holder node is stored in lock), and is larger than other plasma_spin
+ * locks (cache line per node); embed in objects sparingly.
+ */
+
+#ifndef PLASMA_SPIN_COHORTLOCK_NODES
+#define PLASMA_SPIN_COHORTLOCK_NODES 8
+#endif
+
+typedef __attribute_aligned__(64)
+struct plasma_spin_cohortlock_node_t {
+    plasma_spin_tktlock_t lck;
+    uint32_t global;  /* node (cohort) owns global lock */
+    uint32_t count;   /* consecutive handoffs of global lock within node */
+    char pad[64 - sizeof(plasma_spin_tktlock_t) - 2*sizeof(uint32_t)];
+} plasma_spin_cohortlock_node_t;
+
+typedef __attribute_aligned__(64)
+struct plasma_spin_cohortlock_t {
+    plasma_spin_tktlock_t global;
+    uint32_t batch;   /* max consecutive handoffs within node */
+    uint32_t node;    /* node of current lock holder (accessed only by holder)*/
+    char pad[64 - sizeof(plasma_spin_tktlock_t) - 2*sizeof(uint32_t)];
+    plasma_spin_cohortlock_node_t nodes[PLASMA_SPIN_COHORTLOCK_NODES];
+} plasma_spin_cohortlock_t;
+
+__attribute_nonnull__()
+void
+plasma_spin_cohortlock_init (plasma_spin_cohortlock_t * const restrict cohort,
+                             const uint32_t batch);
+
+/*(plasma_spin_cohortlock_acquire() always returns true)*/
+__attribute_nonnull__()
+bool
+plasma_spin_cohortlock_acquire (plasma_spin_cohortlock_t *
+                                  const restrict cohort);
+
+__attribute_nonnull__()
+void
+plasma_spin_cohortlock_release (plasma_spin_cohortlock_t *
+                                  const restrict cohort);
+
+
+/* plasma_spin_brlock_*()  big-reader lock (per-CPU reader slots)
+ *
+ * plasma_spin_brlock_init()
+ * plasma_spin_brlock_destroy()
+ * plasma_spin_brlock_rdlock()
+ * plasma_spin_brlock_tryrdlock()
+ * plasma_spin_brlock_rdunlock()
+ * plasma_spin_brlock_wrlock()
+ * plasma_spin_brlock_trywrlock()
+ * plasma_spin_brlock_wrunlock()
+ *
+ * Reader-writer lock for read-dominated data, where a single shared lock word
+ * (e.g. plasma_spin_rwlock) becomes a cache line hot spot with many readers.
+ * Readers modify only a cache-line-padded reader count in the slot for the CPU
+ * on which the thread is running, so read-side cost is constant regardless
+ * of the number of readers.  Writers are serialized with a plasma_spin_lock,
+ * announce intent in the shared writer flag, and then sweep all slots waiting
+ * for readers to drain, so write-side cost is proportional to number of slots.
+ * Writers have preference; arriving readers wait while writer flag is set.
+ *
+ * Number of slots is plasma_sysconf_nprocessors_onln() at init.
+ * Linux: slot selected by CPU on which thread is running (sched_getcpu())
+ * Other platforms: slot assigned per thread (round-robin at first use)
+ *
+ * plasma_spin_brlock_rdlock() returns slot which must be passed to
+ * plasma_spin_brlock_rdunlock() (thread might migrate to another CPU)
+ * plasma_spin_brlock_init() allocates slots; returns false if alloc fails
+ * Note: lock is not recursive
+ */
+
+typedef __attribute_aligned__(64)
+struct plasma_spin_brlock_slot_t {
+    uint32_t readers;
+    char pad[64 - sizeof(uint32_t)];
+} plasma_spin_brlock_slot_t;
+
+typedef __attribute_aligned__(64)
+struct plasma_spin_brlock_t {
+    uint32_t wlocked;
+    uint32_t nslots;
+    plasma_spin_brlock_slot_t *slots;
+    plasma_spin_lock_t wlock; /* serialize writers */
+    uint32_t udata32; /* user data 4-bytes */
+    uint64_t udata64; /* user data 8-bytes */
+} plasma_spin_brlock_t;
+
+__attribute_nonnull__()
+bool
+plasma_spin_brlock_init (plasma_spin_brlock_t * const restrict br);
+
+__attribute_nonnull__()
+void
+plasma_spin_brlock_destroy (plasma_spin_brlock_t * const restrict br);
+
+__attribute_nonnull__()
+uint32_t
+plasma_spin_brlock_rdlock (plasma_spin_brlock_t * const restrict br);
+
+__attribute_nonnull__()
+bool
+plasma_spin_brlock_tryrdlock (plasma_spin_brlock_t * const restrict br,
+                              uint32_t * const restrict slot);
+
+__attribute_nonnull__()
+PLASMA_SPIN_C99INLINE
+void
+plasma_spin_brlock_rdunlock (plasma_spin_brlock_t * const restrict br,
+                             const uint32_t slot);
+#ifdef PLASMA_SPIN_C99INLINE_FUNCS
+PLASMA_SPIN_C99INLINE
+void
+plasma_spin_brlock_rdunlock (plasma_spin_brlock_t * const restrict br,
+                             const uint32_t slot)
+{
+    plasma_atomic_fetch_sub_u32(&br->slots[slot].readers, 1,
+                                memory_order_release);
+}
+#endif
+
+/*(plasma_spin_brlock_wrlock() always returns true)*/
+__attribute_nonnull__()
+bool
+plasma_spin_brlock_wrlock (plasma_spin_brlock_t * const restrict br);
+
+__attribute_nonnull__()
+bool
+plasma_spin_brlock_trywrlock (plasma_spin_brlock_t * const restrict br);
+
+__attribute_nonnull__()
+PLASMA_SPIN_C99INLINE
+void
+plasma_spin_brlock_wrunlock (plasma_spin_brlock_t * const restrict br);
+#ifdef PLASMA_SPIN_C99INLINE_FUNCS
+PLASMA_SPIN_C99INLINE
+void
+plasma_spin_brlock_wrunlock (plasma_spin_brlock_t * const restrict br)
+{
+    plasma_atomic_store_explicit(&br->wlocked, 0, memory_order_release);
+    plasma_spin_lock_release(&br->wlock);
+}
+#endif
+
+
+/* plasma_spin_barrier_*()  spin barrier
+ * (see bottom of file for barrier references)
+ *
+ * plasma_spin_barrier_init()
+ * plasma_spin_barrier_destroy()
+ * plasma_spin_barrier_wait()
+ *
+ * Reusable barrier for nthreads threads which spins instead of sleeping in the
+ * kernel, so that threads are released from the barrier within a short time
+ * of each other.  Waiting threads spin (pause only) for up to
+ * PLASMA_SPIN_BARRIER_SPIN_NS nanoseconds, and then yield CPU between polls
+ * (immediately yield on single CPU systems).  Variants:
+ *
+ * PLASMA_SPIN_BARRIER_CENTRAL
+ *   centralized sense-reversing barrier; each thread decrements shared count
+ *   and last arrival flips shared sense to release spinning threads.
+ *   Shared count is a hot spot, but simplest and does not need thread id.
+ * PLASMA_SPIN_BARRIER_DISSEMINATION
+ *   ceil(log2(nthreads)) rounds; in round r, thread i signals thread
+ *   (i + 2^r) mod nthreads and waits for signal from (i - 2^r) mod nthreads.
+ *   No shared hot spot; O(n log n) total signals.
+ * PLASMA_SPIN_BARRIER_TREE
+ *   4-ary arrival tree (each thread waits for its children to arrive, then
+ *   signals its parent) and binary wakeup tree from root (thread 0).
+ *   O(n) total signals, each thread spins only on its own node.
+ *
+ * plasma_spin_barrier_wait() id is thread index in [0, nthreads), required
+ * for DISSEMINATION and TREE, and each thread must pass a distinct id
+ * (id ignored for CENTRAL).  Returns true in exactly one thread each time
+ * barrier is passed (similar to PTHREAD_BARRIER_SERIAL_THREAD).
+ * plasma_spin_barrier_init() returns false if nthreads is 0, or type invalid,
+ * or if allocation of per-thread nodes (DISSEMINATION and TREE) fails.
+ *
+ * Note: as with all spin locks, intended for use when threads arrive close
+ * together and when threads do not outnumber CPUs.
+ */
+
+#ifndef PLASMA_SPIN_BARRIER_SPIN_NS
+#define PLASMA_SPIN_BARRIER_SPIN_NS 100000
+#endif
+
+#define PLASMA_SPIN_BARRIER_CENTRAL       0
+#define PLASMA_SPIN_BARRIER_DISSEMINATION 1
+#define PLASMA_SPIN_BARRIER_TREE          2
+
+struct plasma_spin_barrier_node_t;  /*(opaque)*/
+
+typedef __attribute_aligned__(64)
+struct plasma_spin_barrier_t {
+    uint32_t count;   /* CENTRAL: arrivals remaining */
+    uint32_t sense;   /* CENTRAL: flips each time barrier is passed */
+    uint32_t nthreads;
+    uint32_t type;
+    uint32_t rounds;  /* DISSEMINATION: ceil(log2(nthreads)) */
+    uint32_t udata32; /* user data 4-bytes */
+    struct plasma_spin_barrier_node_t *nodes;
+    uint64_t udata64; /* user data 8-bytes */
+} plasma_spin_barrier_t;
+
+__attribute_nonnull__()
+bool
+plasma_spin_barrier_init (plasma_spin_barrier_t * const restrict barrier,
+                          const uint32_t nthreads, const uint32_t type);
+
+__attribute_nonnull__()
+void
+plasma_spin_barrier_destroy (plasma_spin_barrier_t * const restrict barrier);
+
+__attribute_nonnull__()
+bool
+plasma_spin_barrier_wait (plasma_spin_barrier_t * const restrict barrier,
+                          const uint32_t id);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+
+
+
+/* NOTES and REFERENCES
+ *
+ * Discussions about spinning and performance:
+ *
+ * http://www.1024cores.net/home/lock-free-algorithms/tricks/spinning
+ * http://software.intel.com/en-us/articles/implementing-scalable-atomic-locks-for-multi-core-intel-em64t-and-ia32-architectures/
+ * http://stackoverflow.com/questions/11923151/is-there-any-simple-way-to-improve-performance-of-this-spinlock-function
+ * http://stackoverflow.com/questions/11959374/fastest-inline-assembly-spinlock
+ * http://locklessinc.com/articles/priority_locks/
+ * http://locklessinc.com/articles/locks/
+ * http://www.embedded.com/electronics-blogs/beginner-s-corner/4023947/Introduction-to-Priority-Inversion
+ *
+ * http://www.1024cores.net/home/lock-free-algorithms/tricks/spinning
+ *   "On Linux passive spinning is implemented with pthread_yield(), or nanosleep() for "deeper" spin."  [Ed: pthread_yield() not portable; sched_yield() is]
+ *   "On Windows situation is a bit more involved. There is SwitchToThread() which is limited to the current processor. There is Sleep(0) which is limited to threads of no-less priority (it's unclear as to whether it's intra-processor or inter-processor). Finally, there is Sleep(1) which should cover all cases (all priorities/all processors)."
+ *    [See section Hybrid spinning for sample do_backoff() routine]
+ *
+ * http://cbloomrants.blogspot.com/2011/07/07-29-11-spinning.html
+ *   "Obviously a good software engineer doesn't just randomly stick calls to STT or whatever in their spin loops, they make a function like MySpinYield() and call their function so that they can encapsulate the tricky platform-specific knowledge in one place. It just staggers me how rarely I see anyone do things like this.
+ *   "But really you shouldn't EVER do a spin-wait on Windows. There's no reason for it. Any place you are tempted to use a spin-wait, use an "eventcount" instead and do a proper wait. (perhaps after a few spins, but only if you have very good reason to believe those spins actually help)
+ *   "BTW I've written about the balanced set manager in detail here :
+http://cbloomrants.blogspot.com/2010/09/09-12-10-defficiency-of-windows-multi.html "
+ *
+ * SwitchToThread()
+ * http://msdn.microsoft.com/en-us/library/windows/desktop/ms686352%28v=vs.85%29.aspx
+ *
+ * Sleep(1)
+ * http://msdn.microsoft.com/en-us/library/windows/desktop/ms686298%28v=vs.85%29.aspx
+ * http://www.bluebytesoftware.com/blog/2006/08/23/PriorityinducedStarvationWhySleep1IsBetterThanSleep0AndTheWindowsBalanceSetManager.aspx
+ *
+ * timeBeginPeriod(1)  (set default system quantum to 1ms instead of 10-15ms)
+ * (generally not a good idea to do this for extended periods of time)
+ * http://msdn.microsoft.com/en-us/library/windows/desktop/dd757624%28v=vs.85%29.aspx
+ * http://cbloomrants.blogspot.com/2010/09/09-12-10-defficiency-of-windows-multi.html
+ * http://msdn.microsoft.com/en-us/library/ms713413%28v=vs.85%29.aspx
+ * http://stackoverflow.com/questions/7590475/why-does-increasing-timer-resolution-via-timebeginperiod-impact-power-consumptio
+ * http://stackoverflow.com/questions/7685762/windows-7-timing-functions-how-to-use-getsystemtimeadjustment-correctly/11743614#11743614
+ * Timers, Timer Resolution, and Development of Efficient Code
+ * http://msdn.microsoft.com/en-us/windows/hardware/gg463266.aspx
  *
  * Apple OSAtomic.h Reference
  * https://developer.apple.com/library/mac/#documentation/System/Reference/OSAtomic_header_reference/Reference/reference.html#//apple_ref/doc/uid/TP40011482
@@ -672,4 +2108,47 @@ http://cbloomrants.blogspot.com/2010/09/09-12-10-defficiency-of-windows-multi.ht
  * http://en.wikipedia.org/wiki/Fetch-and-add
  * http://lwn.net/Articles/267968/   (including comments)
  * http://www.intel.com/content/dam/www/public/us/en/documents/white-papers/xeon-lock-scaling-analysis-paper.pdf
+ *
+ * MCS lock
+ * John M. Mellor-Crummey and Michael L. Scott, "Algorithms for Scalable
+ *   Synchronization on Shared-Memory Multiprocessors", ACM TOCS, Feb 1991
+ * http://www.cs.rochester.edu/research/synchronization/pseudocode/ss.html
+ * http://lwn.net/Articles/590243/
+ *
+ * CLH lock
+ * Travis S. Craig, "Building FIFO and Priority-Queuing Spin Locks from
+ *   Atomic Swap", University of Washington TR 93-02-02, Feb 1993
+ * Magnusson, Landin and Hagersten, "Queue Locks on Cache Coherent
+ *   Multiprocessors", IPPS 1994
+ * Michael L. Scott and William N. Scherer III, "Scalable Queue-Based Spin
+ *   Locks with Timeout", PPoPP 2001  (abortable CLH and MCS locks)
+ * Maurice Herlihy and Nir Shavit, "The Art of Multiprocessor Programming",
+ *   2008  (section 7.6, TOLock: abortable CLH lock)
+ * http://www.cs.rochester.edu/research/synchronization/pseudocode/ss.html
+ *
+ * futex
+ * Ulrich Drepper, "Futexes Are Tricky" (mutex, take 2 and take 3)
+ * http://www.akkadia.org/drepper/futex.pdf
+ * http://man7.org/linux/man-pages/man2/futex.2.html
+ *
+ * Reader-writer lock
+ * Bjorn B. Brandenburg and James H. Anderson, "Spin-Based Reader-Writer
+ *   Synchronization for Multiprocessor Real-Time Systems", Real-Time Systems
+ *   46(1), 2010  (phase-fair ticket lock, PF-T)
+ * http://www.cs.rochester.edu/research/synchronization/pseudocode/rw.html
+ *
+ * Proportional backoff
+ * John M. Mellor-Crummey and Michael L. Scott, "Algorithms for Scalable
+ *   Synchronization on Shared-Memory Multiprocessors", ACM TOCS 9(1), 1991
+ *   (section 2.2, ticket lock with proportional backoff)
+ *
+ * Barriers
+ * Mellor-Crummey and Scott, ACM TOCS 9(1), 1991 (see Proportional backoff)
+ *   (section 3: sense-reversing centralized, dissemination and tree barriers)
+ * Debra Hensgen, Raphael Finkel and Udi Manber, "Two Algorithms for Barrier
+ *   Synchronization", International Journal of Parallel Programming, 1988
+ *
+ * Lock cohorting
+ * David Dice, Virendra J. Marathe and Nir Shavit, "Lock Cohorting: A General
+ *   Technique for Designing NUMA Locks", PPoPP 2012  (C-TKT-TKT)
  */
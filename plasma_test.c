@@ -19,20 +19,30 @@
  *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-/* _XOPEN_SOURCE 600 for pthread_barrier_t */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE     /* syscall() */
+#endif
+/* _XOPEN_SOURCE 600 for pthread_setconcurrency() */
 #ifndef _XOPEN_SOURCE
 #define _XOPEN_SOURCE 600
 #endif
 
 #include "plasma_test.h"
+#include "plasma_atomic.h"
 #include "plasma_attr.h"
 #include "plasma_feature.h"
+#include "plasma_spin.h"
 #include "plasma_stdtypes.h"
 
 #include <errno.h>
 #include <stdio.h>    /* fprintf() */
 #include <stdlib.h>   /* malloc() free() calloc() realloc() abort() */
-#include <string.h>   /* strerror() */
+#include <string.h>   /* strerror() strrchr() */
+
+#ifdef __linux__
+#include <sys/syscall.h>  /* SYS_gettid */
+#include <unistd.h>       /* syscall() */
+#endif
 
 void
 plasma_test_free (void *ptr)
@@ -89,66 +99,6 @@ plasma_test_perror_abort (const char *func, const int line,
 #ifdef PLASMA_FEATURE_POSIX
 
 #include <pthread.h>
-#include <unistd.h>   /* _POSIX_BARRIERS (if supported) */
-
-/* pthread barriers are optional POSIX extension not implemented on Mac OSX */
-#if !defined(_POSIX_BARRIERS) || (_POSIX_BARRIERS-0) == -1
-
-/* Brent Priddy provides a simple implementation of pthread barriers in
- * http://stackoverflow.com/questions/3640853/performance-test-sem-t-v-s-dispatch-semaphore-t-and-pthread-once-t-v-s-dispat
- * Note: code has been modified from original posted on link above */
-
-typedef int pthread_barrierattr_t;
-typedef struct
-{
-    pthread_mutex_t mutex;
-    pthread_cond_t cond;
-    int count;
-    int tripCount;
-} pthread_barrier_t;
-
-static int
-pthread_barrier_init (pthread_barrier_t * const restrict barrier,
-                      const pthread_barrierattr_t * const restrict attr
-                        __attribute_unused__,
-                      const unsigned int count)
-{
-    if (    0 != count
-         && 0 == pthread_mutex_init(&barrier->mutex, 0)) {
-        if (0 == pthread_cond_init(&barrier->cond, 0)) {
-            barrier->tripCount = count;
-            barrier->count = 0;
-            return 0;
-        }
-        else
-            pthread_mutex_destroy(&barrier->mutex);
-    }
-    else if (count == 0)
-        errno = EINVAL;
-    return -1;
-}
-
-static int
-pthread_barrier_destroy (pthread_barrier_t * const restrict barrier)
-{
-    pthread_cond_destroy(&barrier->cond);
-    pthread_mutex_destroy(&barrier->mutex);
-    return 0;
-}
-
-static int
-pthread_barrier_wait (pthread_barrier_t * const restrict barrier)
-{
-    int rc=0; /*(rc 0 for waiters, non-zero for PTHREAD_BARRIER_SERIAL_THREAD)*/
-    pthread_mutex_lock(&barrier->mutex);
-    ++barrier->count < barrier->tripCount
-      ? pthread_cond_wait(&barrier->cond, &barrier->mutex)
-      : (pthread_cond_broadcast(&barrier->cond), (rc = 1));
-    pthread_mutex_unlock(&barrier->mutex);
-    return rc;
-}
-
-#endif /* !_POSIX_BARRIERS */
 
 #elif defined(_WIN32)
 
@@ -161,6 +111,9 @@ pthread_barrier_wait (pthread_barrier_t * const restrict barrier)
 /* simple convenience framework to assist in running multithreaded tests
  *
  * thr_func() may (optionally) employ plasma_test_barrier_wait();
+ * (spin barrier releases threads close together in time so that timed phases
+ *  start nearly simultaneously; plasma_test_barrier_wait() returns non-zero
+ *  in one thread, similar to PTHREAD_BARRIER_SERIAL_THREAD)
  * thr_arg might be struct that includes shared storage array for thread status,
  * as well as other data for thread, e.g. loop iterations for concurrent tests
  *
@@ -169,7 +122,7 @@ pthread_barrier_wait (pthread_barrier_t * const restrict barrier)
  *  stored back into that array upon pthread_join().)
  */
 
-static pthread_barrier_t plasma_test_barrier;
+static plasma_spin_barrier_t plasma_test_barrier;
 
 void
 plasma_test_nthreads (const int nthreads, void *(*thr_func)(void *),
@@ -185,9 +138,9 @@ plasma_test_nthreads (const int nthreads, void *(*thr_func)(void *),
         thr_rv = thr_args_alloc;
     if (thr_ids == NULL || thr_args == NULL || thr_rv == NULL)
         PLASMA_TEST_PERROR_ABORT("plasma_test_malloc", errno);
-    if (0 != (rc = pthread_barrier_init(&plasma_test_barrier, NULL,
-                                        (unsigned int)nthreads)))
-        PLASMA_TEST_PERROR_ABORT("pthread_barrier_init", rc);
+    if (!plasma_spin_barrier_init(&plasma_test_barrier, (uint32_t)nthreads,
+                                  PLASMA_SPIN_BARRIER_CENTRAL))
+        PLASMA_TEST_PERROR_ABORT("plasma_spin_barrier_init", EINVAL);
     pthread_setconcurrency(nthreads);
     for (n=0; n < nthreads; ++n) {
         if (0 != (rc = pthread_create(&thr_ids[n],NULL,thr_func,thr_args[n])))
@@ -198,7 +151,7 @@ plasma_test_nthreads (const int nthreads, void *(*thr_func)(void *),
             PLASMA_TEST_PERROR_ABORT("pthread_join", rc);
     }
     pthread_setconcurrency(0);
-    pthread_barrier_destroy(&plasma_test_barrier);
+    plasma_spin_barrier_destroy(&plasma_test_barrier);
     plasma_test_free(thr_args_alloc);
     plasma_test_free(thr_ids);
 }
@@ -206,5 +159,54 @@ plasma_test_nthreads (const int nthreads, void *(*thr_func)(void *),
 int
 plasma_test_barrier_wait (void)
 {
-    return pthread_barrier_wait(&plasma_test_barrier);
+    return plasma_spin_barrier_wait(&plasma_test_barrier, 0);
+}
+
+
+long
+plasma_test_thread_id (void)
+{
+  #ifdef __linux__
+    return (long)syscall(SYS_gettid);
+  #else
+    return 0;
+  #endif
+}
+
+bool
+plasma_test_wait_blocked (const long *tids, int n)
+{
+  #ifdef __linux__
+    char path[64], buf[512], *p;
+    FILE *fp;
+    size_t len;
+    while (n-- > 0) {
+        snprintf(path, sizeof(path), "/proc/self/task/%ld/stat", tids[n]);
+        for (;;) {
+            len = 0;
+            if ((fp = fopen(path, "r")) != NULL) {
+                len = fread(buf, 1, sizeof(buf)-1, fp);
+                fclose(fp);
+            }
+            buf[len] = '\0';
+            p = strrchr(buf, ')');  /* "pid (comm) state ..." */
+            if (p != NULL && p[1] == ' ' && p[2] == 'S')
+                break;
+            plasma_spin_yield();
+        }
+    }
+    return true;
+  #else
+    (void)tids;
+    (void)n;
+    plasma_spin_pause_ns(10000000); /*(can not observe blocking; settle)*/
+    return false;
+  #endif
+}
+
+void
+plasma_test_await_count (const uint32_t *counter, uint32_t n)
+{
+    while (plasma_atomic_load_explicit(counter, memory_order_seq_cst) < n)
+        plasma_spin_yield();
 }
@@ -112,6 +112,35 @@ int
 plasma_test_barrier_wait (void);
 
 
+/* plasma_test_thread_id()
+ * plasma_test_wait_blocked()
+ * plasma_test_await_count()
+ *
+ * Helpers for tests which check how many blocked threads a wake operation
+ * releases.  Each waiter records plasma_test_thread_id() before it blocks.
+ * A coordinator thread calls plasma_test_wait_blocked() to wait until all
+ * waiters are blocked (sleeping) in the kernel, e.g. parked in
+ * plasma_futex_wait(), before issuing a wake, and then counts waiters woken.
+ * plasma_test_wait_blocked() polls thread state 'S' in
+ * /proc/self/task/<tid>/stat on Linux, and returns true once all n threads
+ * have been observed blocked.  Elsewhere, thread state can not be observed;
+ * plasma_test_wait_blocked() pauses 10ms to let threads settle, and returns
+ * false.  plasma_test_thread_id() returns 0 where not supported.
+ * plasma_test_await_count() yields until *counter >= n.
+ */
+
+long
+plasma_test_thread_id (void);
+
+__attribute_nonnull__()
+bool
+plasma_test_wait_blocked (const long *tids, int n);
+
+__attribute_nonnull__()
+void
+plasma_test_await_count (const uint32_t *counter, uint32_t n);
+
+
 #ifdef __cplusplus
 }
 #endif
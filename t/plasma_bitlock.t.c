@@ -0,0 +1,216 @@
+/*
+ * plasma_bitlock.t.c - plasma_bitlock.[ch] tests
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ *   $ make libplasma.a
+ *   $ gcc -std=c11 -D_XOPEN_SOURCE=700 -O3 -pthread \
+ *       t/plasma_bitlock.t.c libplasma.a -o plasma_bitlock.t
+ *   $ ./plasma_bitlock.t [nthreads] [iterations]
+ */
+
+#ifndef _XOPEN_SOURCE
+#define _XOPEN_SOURCE 600
+#endif
+
+#include "../plasma_atomic.h"
+#include "../plasma_attr.h"
+#include "../plasma_bitlock.h"
+#include "../plasma_membar.h"
+#include "../plasma_spin.h"
+#include "../plasma_stdtypes.h"
+#include "../plasma_sysconf.h"
+#include "../plasma_test.h"
+
+#ifdef PLASMA_FEATURE_POSIX
+#include <unistd.h>  /* alarm() */
+#endif
+#include <stdlib.h>
+
+/* single thread: each bit is an independent lock; other bits preserved */
+static int
+plasma_bitlock_t_single (void)
+{
+    uint32_t w32 = 0x80000001u;
+    uint64_t w64 = UINT64_C(0x8000000000000001);
+    uint32_t obj[2];
+    void *ptr = &obj[0];
+    int rc = true;
+
+    rc &= PLASMA_TEST_COND(plasma_bitlock_acquire_try_u32(&w32, 4));
+    rc &= PLASMA_TEST_COND(!plasma_bitlock_acquire_try_u32(&w32, 4));
+    rc &= PLASMA_TEST_COND(plasma_bitlock_acquire_try_u32(&w32, 30));
+    rc &= PLASMA_TEST_COND(w32 == (0x80000001u | (1u << 4) | (1u << 30)));
+    plasma_bitlock_release_u32(&w32, 4);
+    rc &= PLASMA_TEST_COND(w32 == (0x80000001u | (1u << 30)));
+    plasma_bitlock_acquire_u32(&w32, 4);  /*(does not spin)*/
+    plasma_bitlock_release_u32(&w32, 4);
+    plasma_bitlock_release_u32(&w32, 30);
+    rc &= PLASMA_TEST_COND(w32 == 0x80000001u);
+
+    rc &= PLASMA_TEST_COND(plasma_bitlock_acquire_try_u64(&w64, 62));
+    rc &= PLASMA_TEST_COND(!plasma_bitlock_acquire_try_u64(&w64, 62));
+    rc &= PLASMA_TEST_COND(plasma_bitlock_acquire_try_u64(&w64, 33));
+    rc &= PLASMA_TEST_COND(w64 == (UINT64_C(0x8000000000000001)
+                                   | (UINT64_C(1) << 62)
+                                   | (UINT64_C(1) << 33)));
+    plasma_bitlock_release_u64(&w64, 62);
+    plasma_bitlock_acquire_u64(&w64, 62);  /*(does not spin)*/
+    plasma_bitlock_release_u64(&w64, 62);
+    plasma_bitlock_release_u64(&w64, 33);
+    rc &= PLASMA_TEST_COND(w64 == UINT64_C(0x8000000000000001));
+
+    rc &= PLASMA_TEST_COND(plasma_bitlock_acquire_try_ptr(&ptr));
+    rc &= PLASMA_TEST_COND(!plasma_bitlock_acquire_try_ptr(&ptr));
+    rc &= PLASMA_TEST_COND(plasma_bitlock_ptr_get(&ptr) == &obj[0]);
+    plasma_bitlock_ptr_set(&ptr, &obj[1]);
+    rc &= PLASMA_TEST_COND(plasma_bitlock_ptr_get(&ptr) == &obj[1]);
+    rc &= PLASMA_TEST_COND(!plasma_bitlock_acquire_try_ptr(&ptr));
+    plasma_bitlock_release_ptr(&ptr);
+    rc &= PLASMA_TEST_COND(ptr == &obj[1]);
+    plasma_bitlock_acquire_ptr(&ptr);  /*(does not spin)*/
+    plasma_bitlock_release_ptr(&ptr);
+    rc &= PLASMA_TEST_COND(ptr == &obj[1]);
+    return rc;
+}
+
+/* Threads contend for a bit lock in a 32-bit word, a 64-bit word, and a
+ * pointer, checking that at most one thread is inside each critical section,
+ * while (outside the critical section) concurrently toggling other bits of
+ * the 32-bit and 64-bit words with atomic operations.  Counters protected by
+ * each lock must total all increments, and toggled bits must be restored */
+#define PLASMA_BITLOCK_T_BIT32 7
+#define PLASMA_BITLOCK_T_BIT64 40
+#define PLASMA_BITLOCK_T_INIT32 0x5A5A5A00u
+#define PLASMA_BITLOCK_T_INIT64 \
+        (UINT64_C(0x5A5A5A5A5A5A5A5A)                                   \
+         & ~(UINT64_C(1) << PLASMA_BITLOCK_T_BIT64))
+
+static struct plasma_bitlock_t_shared {
+    uint32_t word32;
+    uint64_t word64;
+    void *ptr;
+    uint32_t counter32;
+    uint32_t counter64;
+    uint32_t counterptr;
+    uint32_t inside32;
+    uint32_t inside64;
+    uint32_t insideptr;
+    uint32_t overlaps;
+    uint32_t thrid;
+    uint32_t iters;
+} plasma_bitlock_t_shared;
+
+/* enter critical section; count if another thread is inside */
+#define plasma_bitlock_t_enter(inside, overlaps) \
+        ((overlaps) += (0 != plasma_atomic_fetch_add_u32((inside), 1,      \
+                                                memory_order_relaxed)))
+#define plasma_bitlock_t_leave(inside) \
+        plasma_atomic_fetch_sub_u32((inside), 1, memory_order_relaxed)
+
+static void *
+plasma_bitlock_t_thread (void * const thr_arg)
+{
+    struct plasma_bitlock_t_shared * const restrict s =
+      &plasma_bitlock_t_shared;
+    /* (bit toggled by this thread is not lock bit, in low 7 bits of word32
+     *  and in low 32 bits of word64) */
+    const uint32_t k =
+      plasma_atomic_fetch_add_u32(&s->thrid, 1, memory_order_relaxed) % 7;
+    const uint32_t m32 = (uint32_t)1u << k;
+    const uint64_t m64 = (uint64_t)1u << (k + 8);
+    uint32_t i, overlaps = 0;
+    (void)thr_arg;
+    plasma_test_barrier_wait();
+    for (i = 0; i < s->iters; ++i) {
+        plasma_atomic_fetch_xor_u32(&s->word32, m32, memory_order_relaxed);
+        plasma_bitlock_acquire_u32(&s->word32, PLASMA_BITLOCK_T_BIT32);
+        plasma_bitlock_t_enter(&s->inside32, overlaps);
+        ++s->counter32;
+        plasma_bitlock_t_leave(&s->inside32);
+        plasma_bitlock_release_u32(&s->word32, PLASMA_BITLOCK_T_BIT32);
+        plasma_atomic_fetch_xor_u32(&s->word32, m32, memory_order_relaxed);
+
+        plasma_atomic_fetch_xor_u64(&s->word64, m64, memory_order_relaxed);
+        plasma_bitlock_acquire_u64(&s->word64, PLASMA_BITLOCK_T_BIT64);
+        plasma_bitlock_t_enter(&s->inside64, overlaps);
+        ++s->counter64;
+        plasma_bitlock_t_leave(&s->inside64);
+        plasma_bitlock_release_u64(&s->word64, PLASMA_BITLOCK_T_BIT64);
+        plasma_atomic_fetch_xor_u64(&s->word64, m64, memory_order_relaxed);
+
+        plasma_bitlock_acquire_ptr(&s->ptr);
+        plasma_bitlock_t_enter(&s->insideptr, overlaps);
+        ++s->counterptr;
+        if ((i & 0xFF) == 0)
+            plasma_spin_yield(); /*(holder preempted; waiters must yield)*/
+        plasma_bitlock_t_leave(&s->insideptr);
+        plasma_bitlock_release_ptr(&s->ptr);
+    }
+    plasma_atomic_fetch_add_u32(&s->overlaps, overlaps, memory_order_relaxed);
+    return NULL;
+}
+
+static int
+plasma_bitlock_t_nthreads (const int nthreads, const int iters)
+{
+    struct plasma_bitlock_t_shared * const restrict s =
+      &plasma_bitlock_t_shared;
+    const int n = nthreads < 2 ? 2 : nthreads;
+    const uint32_t total = (uint32_t)iters * (uint32_t)n;
+    int rc = true;
+    s->word32 = PLASMA_BITLOCK_T_INIT32;
+    s->word64 = PLASMA_BITLOCK_T_INIT64;
+    s->ptr = &s->counterptr;
+    s->counter32 = s->counter64 = s->counterptr = 0;
+    s->inside32 = s->inside64 = s->insideptr = 0;
+    s->overlaps = 0;
+    s->thrid = 0;
+    s->iters = (uint32_t)iters;
+    plasma_test_nthreads(n, plasma_bitlock_t_thread, NULL, NULL);
+    rc &= PLASMA_TEST_COND(s->overlaps == 0);
+    rc &= PLASMA_TEST_COND(s->counter32 == total);
+    rc &= PLASMA_TEST_COND(s->counter64 == total);
+    rc &= PLASMA_TEST_COND(s->counterptr == total);
+    rc &= PLASMA_TEST_COND(s->word32 == PLASMA_BITLOCK_T_INIT32);
+    rc &= PLASMA_TEST_COND(s->word64 == PLASMA_BITLOCK_T_INIT64);
+    rc &= PLASMA_TEST_COND(s->ptr == &s->counterptr);
+    return rc;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int rc = true;
+    long nprocs = plasma_sysconf_nprocessors_onln();
+    int iters;
+    if (nprocs < 1)
+        nprocs = 1;
+    if (nprocs > 32)
+        nprocs = 32;  /*(place upper bound on num threads created in tests)*/
+    if (argc > 1 && atoi(argv[1]) > 0)
+        nprocs = atoi(argv[1]);
+    iters = (argc > 2 && atoi(argv[2]) > 0) ? atoi(argv[2]) : 100000;
+    alarm(120);
+
+    rc &= plasma_bitlock_t_single();
+    rc &= plasma_bitlock_t_nthreads((int)nprocs, iters);
+    return !rc;
+}
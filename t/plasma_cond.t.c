@@ -0,0 +1,350 @@
+/*
+ * plasma_cond.t.c - plasma_cond.[ch] tests
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ *   $ make libplasma.a
+ *   $ gcc -std=c11 -D_XOPEN_SOURCE=700 -O3 -pthread \
+ *       t/plasma_cond.t.c libplasma.a -o plasma_cond.t
+ *   $ ./plasma_cond.t [nthreads] [iterations]
+ *
+ * On Linux, tests confirm that waiters are parked in the kernel (thread state
+ * 'S' in /proc) before signal or broadcast, and check that signal returns
+ * exactly one waiter from plasma_cond_wait() and broadcast returns all.
+ * (Add -DPLASMA_FUTEX_CONDVAR if libplasma.a was built with it; condvar
+ *  fallback wakes all waiters in a bucket, so exact counts are not checked)
+ */
+
+#ifndef _XOPEN_SOURCE
+#define _XOPEN_SOURCE 600
+#endif
+
+#include "../plasma_atomic.h"
+#include "../plasma_attr.h"
+#include "../plasma_cond.h"
+#include "../plasma_futex.h"
+#include "../plasma_membar.h"
+#include "../plasma_spin.h"
+#include "../plasma_stdtypes.h"
+#include "../plasma_sysconf.h"
+#include "../plasma_test.h"
+
+#ifdef PLASMA_FEATURE_POSIX
+#include <unistd.h>  /* alarm() */
+#endif
+#include <stdlib.h>
+#include <string.h>  /* memset() */
+
+#if defined(__linux__) && !defined(PLASMA_FUTEX_CONDVAR)
+#define PLASMA_COND_T_EXACT
+#endif
+
+PLASMA_COND_LOCKFNS(plasma_cond_t_tktlock, plasma_spin_tktlock_t,
+                    plasma_spin_tktlock_acquire, plasma_spin_tktlock_release)
+
+/* timed wait times out with lock re-acquired; signal and broadcast without
+ * waiters do not advance sequence number (no wake) */
+static int
+plasma_cond_t_timedwait (void)
+{
+    plasma_cond_t cond = PLASMA_COND_INITIALIZER;
+    plasma_spin_tktlock_t tktlock = PLASMA_SPIN_TKTLOCK_INITIALIZER;
+    plasma_spin_futexlock_t futexlock = PLASMA_SPIN_FUTEXLOCK_INITIALIZER;
+    uint64_t t;
+    int rc = true;
+    plasma_spin_tktlock_acquire(&tktlock);
+    t = plasma_spin_clock_ns();
+    rc &= PLASMA_TEST_COND(!plasma_cond_timedwait(&cond, &tktlock,
+                                            plasma_cond_t_tktlock_acquire_cb,
+                                            plasma_cond_t_tktlock_release_cb,
+                                            1000000));
+    rc &= PLASMA_TEST_COND(plasma_spin_clock_ns() - t >= 500000);
+    rc &= PLASMA_TEST_COND(!plasma_spin_tktlock_is_free(&tktlock));
+    plasma_spin_tktlock_release(&tktlock);
+    rc &= PLASMA_TEST_COND(cond.waiters == 0);
+
+    plasma_spin_futexlock_acquire(&futexlock);
+    rc &= PLASMA_TEST_COND(!plasma_cond_timedwait_futexlock(&cond, &futexlock,
+                                                            1000000));
+    rc &= PLASMA_TEST_COND(!plasma_spin_futexlock_is_free(&futexlock));
+    plasma_spin_futexlock_release(&futexlock);
+    rc &= PLASMA_TEST_COND(plasma_spin_futexlock_is_free(&futexlock));
+    rc &= PLASMA_TEST_COND(cond.waiters == 0);
+
+    plasma_cond_signal(&cond);
+    plasma_cond_broadcast(&cond);
+    plasma_cond_broadcast_requeue(&cond, &futexlock);
+    rc &= PLASMA_TEST_COND(cond.seq == 0);
+    return rc;
+}
+
+/* Waiters each wait (under tktlock) until a ticket is available, counting
+ * each return from plasma_cond_wait() as a wakeup, and then take a ticket and
+ * wait on release.  Thread 0 is the coordinator, which adds tickets and
+ * signals or broadcasts, and records wakeups and tickets taken after each
+ * step, once all waiters are again blocked */
+#define PLASMA_COND_T_WAITERS 6
+
+static struct plasma_cond_t_waiters {
+    plasma_cond_t cond;
+    plasma_spin_tktlock_t tktlock;
+    uint32_t tickets;
+    uint32_t taken;
+    uint32_t wakeups;
+    uint32_t release;
+    uint32_t taken_signal;
+    uint32_t wakeups_signal;
+    uint32_t taken_signal2;
+    uint32_t wakeups_signal2;
+    uint32_t taken_broadcast;
+    uint32_t wakeups_broadcast;
+    long tids[PLASMA_COND_T_WAITERS+1];
+} plasma_cond_t_waiters;
+
+/* wait until all waiters are blocked in kernel (waiters block only in
+ * plasma_cond_wait() or, after taking a ticket, on release) */
+static void
+plasma_cond_t_all_blocked (void)
+{
+    struct plasma_cond_t_waiters * const restrict s = &plasma_cond_t_waiters;
+    (void)plasma_test_wait_blocked(s->tids+1, PLASMA_COND_T_WAITERS);
+}
+
+static void
+plasma_cond_t_post (const uint32_t n, const bool all)
+{
+    struct plasma_cond_t_waiters * const restrict s = &plasma_cond_t_waiters;
+    plasma_spin_tktlock_acquire(&s->tktlock);
+    s->tickets += n;
+    if (all)
+        plasma_cond_broadcast(&s->cond);
+    else
+        plasma_cond_signal(&s->cond);
+    plasma_spin_tktlock_release(&s->tktlock);
+}
+
+static void
+plasma_cond_t_coordinator (void)
+{
+    struct plasma_cond_t_waiters * const restrict s = &plasma_cond_t_waiters;
+    while (plasma_atomic_load_explicit(&s->cond.waiters, memory_order_seq_cst)
+           != PLASMA_COND_T_WAITERS)
+        plasma_spin_yield();
+    plasma_cond_t_all_blocked();
+
+    plasma_cond_t_post(1, false);
+    plasma_test_await_count(&s->taken, 1);
+    plasma_cond_t_all_blocked();
+    s->taken_signal   = s->taken;
+    s->wakeups_signal = s->wakeups;
+
+    plasma_cond_t_post(1, false);
+    plasma_test_await_count(&s->taken, 2);
+    plasma_cond_t_all_blocked();
+    s->taken_signal2   = s->taken;
+    s->wakeups_signal2 = s->wakeups;
+
+    plasma_cond_t_post(PLASMA_COND_T_WAITERS - 2, true);
+    plasma_test_await_count(&s->taken, PLASMA_COND_T_WAITERS);
+    plasma_cond_t_all_blocked();
+    s->taken_broadcast   = s->taken;
+    s->wakeups_broadcast = s->wakeups;
+
+    plasma_atomic_store_explicit(&s->release, 1, memory_order_release);
+    plasma_futex_wake_all(&s->release);
+}
+
+static void *
+plasma_cond_t_waiter (void * const thr_arg)
+{
+    struct plasma_cond_t_waiters * const restrict s = &plasma_cond_t_waiters;
+    const int id = (int)(uintptr_t)thr_arg;
+    if (id == 0) {
+        plasma_cond_t_coordinator();
+        return NULL;
+    }
+    s->tids[id] = plasma_test_thread_id();
+    plasma_spin_tktlock_acquire(&s->tktlock);
+    while (s->tickets == 0) {
+        plasma_cond_wait(&s->cond, &s->tktlock,
+                         plasma_cond_t_tktlock_acquire_cb,
+                         plasma_cond_t_tktlock_release_cb);
+        ++s->wakeups;
+    }
+    --s->tickets;
+    plasma_atomic_fetch_add_u32(&s->taken, 1, memory_order_seq_cst);
+    plasma_spin_tktlock_release(&s->tktlock);
+    while (!plasma_atomic_load_explicit(&s->release, memory_order_acquire))
+        plasma_futex_wait(&s->release, 0, PLASMA_FUTEX_INFINITE);
+    return NULL;
+}
+
+/* signal releases one waiter; broadcast releases all waiters */
+static int
+plasma_cond_t_wake_counts (void)
+{
+    struct plasma_cond_t_waiters * const restrict s = &plasma_cond_t_waiters;
+    void *args[PLASMA_COND_T_WAITERS+1];
+    int i, rc = true;
+    memset(s, 0, sizeof(*s));
+    plasma_cond_init(&s->cond);
+    plasma_spin_tktlock_init(&s->tktlock);
+    for (i = 0; i <= PLASMA_COND_T_WAITERS; ++i)
+        args[i] = (void *)(uintptr_t)i;
+    plasma_test_nthreads(PLASMA_COND_T_WAITERS+1, plasma_cond_t_waiter,
+                         args, NULL);
+    rc &= PLASMA_TEST_COND(s->taken_signal == 1);
+    rc &= PLASMA_TEST_COND(s->taken_signal2 == 2);
+    rc &= PLASMA_TEST_COND(s->taken_broadcast == PLASMA_COND_T_WAITERS);
+  #ifdef PLASMA_COND_T_EXACT
+    rc &= PLASMA_TEST_COND(s->wakeups_signal == 1);
+    rc &= PLASMA_TEST_COND(s->wakeups_signal2 == 2);
+    rc &= PLASMA_TEST_COND(s->wakeups_broadcast == PLASMA_COND_T_WAITERS);
+  #endif
+    rc &= PLASMA_TEST_COND(s->tickets == 0);
+    rc &= PLASMA_TEST_COND(s->cond.waiters == 0);
+    rc &= PLASMA_TEST_COND(plasma_spin_tktlock_is_free(&s->tktlock));
+    return rc;
+}
+
+/* producer/consumers with tktlock (signal), and then generations of
+ * broadcast to waiters using futexlock (broadcast with requeue); each
+ * waiter must pass each generation exactly once */
+static struct plasma_cond_t_shared {
+    plasma_cond_t cond;
+    plasma_cond_t gencond;
+    plasma_spin_tktlock_t tktlock;
+    plasma_spin_futexlock_t futexlock;
+    uint32_t avail;
+    uint32_t consumed;
+    uint32_t gen;
+    uint32_t passed;
+    uint32_t skipped;
+    uint32_t iters;
+    uint32_t nthreads;
+} plasma_cond_t_shared;
+
+#define PLASMA_COND_T_GENS 16
+
+static void
+plasma_cond_t_producer (void)
+{
+    struct plasma_cond_t_shared * const restrict s = &plasma_cond_t_shared;
+    uint32_t i, n;
+    for (i = 0, n = s->iters * (s->nthreads - 1); i < n; ++i) {
+        plasma_spin_tktlock_acquire(&s->tktlock);
+        ++s->avail;
+        plasma_cond_signal(&s->cond);
+        plasma_spin_tktlock_release(&s->tktlock);
+    }
+    for (i = 1; i <= PLASMA_COND_T_GENS; ++i) {
+        /* (wait until all waiters passed previous generation) */
+        while (plasma_atomic_load_explicit(&s->passed, memory_order_acquire)
+               != (i - 1) * (s->nthreads - 1))
+            plasma_spin_yield();
+        plasma_spin_futexlock_acquire(&s->futexlock);
+        ++s->gen;
+        plasma_cond_broadcast_requeue(&s->gencond, &s->futexlock);
+        plasma_spin_futexlock_release(&s->futexlock);
+    }
+}
+
+static void *
+plasma_cond_t_nthreads (void * const thr_arg)
+{
+    struct plasma_cond_t_shared * const restrict s = &plasma_cond_t_shared;
+    uint32_t i;
+    if (thr_arg != NULL) {
+        plasma_cond_t_producer();
+        return NULL;
+    }
+    for (i = 0; i < s->iters; ++i) {
+        plasma_spin_tktlock_acquire(&s->tktlock);
+        while (s->avail == 0)
+            plasma_cond_wait(&s->cond, &s->tktlock,
+                             plasma_cond_t_tktlock_acquire_cb,
+                             plasma_cond_t_tktlock_release_cb);
+        --s->avail;
+        ++s->consumed;
+        plasma_spin_tktlock_release(&s->tktlock);
+    }
+    for (i = 1; i <= PLASMA_COND_T_GENS; ++i) {
+        plasma_spin_futexlock_acquire(&s->futexlock);
+        while (s->gen < i)
+            plasma_cond_wait_futexlock(&s->gencond, &s->futexlock);
+        if (s->gen != i)
+            ++s->skipped;
+        plasma_atomic_fetch_add_u32(&s->passed, 1, memory_order_release);
+        plasma_spin_futexlock_release(&s->futexlock);
+    }
+    return NULL;
+}
+
+static int
+plasma_cond_t_nthreads_run (const int nthreads, const int iters)
+{
+    struct plasma_cond_t_shared * const restrict s = &plasma_cond_t_shared;
+    void *args[33];
+    int i, rc = true;
+    plasma_cond_init(&s->cond);
+    plasma_cond_init(&s->gencond);
+    plasma_spin_tktlock_init(&s->tktlock);
+    plasma_spin_futexlock_init(&s->futexlock);
+    s->avail = 0;
+    s->consumed = 0;
+    s->gen = 0;
+    s->passed = 0;
+    s->skipped = 0;
+    s->iters = (uint32_t)iters;
+    s->nthreads = (uint32_t)(nthreads < 2 ? 2 : nthreads > 33 ? 33 : nthreads);
+    for (i = 0; i < (int)s->nthreads; ++i)
+        args[i] = NULL;
+    args[0] = (void *)s;  /*(producer)*/
+    plasma_test_nthreads((int)s->nthreads, plasma_cond_t_nthreads, args, NULL);
+    rc &= PLASMA_TEST_COND(s->avail == 0);
+    rc &= PLASMA_TEST_COND(s->consumed == s->iters * (s->nthreads - 1));
+    rc &= PLASMA_TEST_COND(s->passed == (s->nthreads-1) * PLASMA_COND_T_GENS);
+    rc &= PLASMA_TEST_COND(s->skipped == 0);
+    rc &= PLASMA_TEST_COND(plasma_spin_tktlock_is_free(&s->tktlock));
+    rc &= PLASMA_TEST_COND(plasma_spin_futexlock_is_free(&s->futexlock));
+    rc &= PLASMA_TEST_COND(s->cond.waiters == 0 && s->gencond.waiters == 0);
+    return rc;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int rc = true;
+    long nprocs = plasma_sysconf_nprocessors_onln();
+    int iters;
+    if (nprocs < 1)
+        nprocs = 1;
+    if (nprocs > 32)
+        nprocs = 32;  /*(place upper bound on num threads created in tests)*/
+    if (argc > 1 && atoi(argv[1]) > 0)
+        nprocs = atoi(argv[1]);
+    iters = (argc > 2 && atoi(argv[2]) > 0) ? atoi(argv[2]) : 10000;
+    alarm(120);
+
+    rc &= plasma_cond_t_timedwait();
+    rc &= plasma_cond_t_wake_counts();
+    rc &= plasma_cond_t_nthreads_run((int)nprocs + 1, iters);
+    return !rc;
+}
@@ -0,0 +1,274 @@
+/*
+ * plasma_eventcount.t.c - plasma_eventcount.[ch] tests
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ *   $ make libplasma.a
+ *   $ gcc -std=c11 -D_XOPEN_SOURCE=700 -O3 -pthread \
+ *       t/plasma_eventcount.t.c libplasma.a -o plasma_eventcount.t
+ *   $ ./plasma_eventcount.t [nthreads] [iterations]
+ *
+ * On Linux, tests confirm that waiters are parked in the kernel (thread state
+ * 'S' in /proc) before notify, and check that notify() returns exactly one
+ * waiter from plasma_eventcount_commit_wait().
+ * (Add -DPLASMA_FUTEX_CONDVAR if libplasma.a was built with it; condvar
+ *  fallback wakes all waiters in a bucket, so exact counts are not checked)
+ */
+
+#ifndef _XOPEN_SOURCE
+#define _XOPEN_SOURCE 600
+#endif
+
+#include "../plasma_atomic.h"
+#include "../plasma_attr.h"
+#include "../plasma_eventcount.h"
+#include "../plasma_futex.h"
+#include "../plasma_membar.h"
+#include "../plasma_spin.h"
+#include "../plasma_stdtypes.h"
+#include "../plasma_sysconf.h"
+#include "../plasma_test.h"
+
+#ifdef PLASMA_FEATURE_POSIX
+#include <unistd.h>  /* alarm() */
+#endif
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>  /* memset() */
+
+#if defined(__linux__) && !defined(PLASMA_FUTEX_CONDVAR)
+#define PLASMA_EVENTCOUNT_T_EXACT
+#endif
+
+/* single thread: notify without waiters leaves epoch alone (fast path);
+ * notify after prepare_wait makes key stale, so commit_wait returns at once*/
+static int
+plasma_eventcount_t_keys (void)
+{
+    plasma_eventcount_t ec = PLASMA_EVENTCOUNT_INITIALIZER;
+    uint32_t key;
+    int rc = true;
+
+    plasma_eventcount_notify(&ec);
+    plasma_eventcount_notify_all(&ec);
+    rc &= PLASMA_TEST_COND(ec.epoch == 0 && ec.waiters == 0);
+
+    key = plasma_eventcount_prepare_wait(&ec);
+    rc &= PLASMA_TEST_COND(key == 0 && ec.waiters == 1);
+    plasma_eventcount_cancel_wait(&ec);
+    rc &= PLASMA_TEST_COND(ec.waiters == 0);
+
+    key = plasma_eventcount_prepare_wait(&ec);
+    plasma_eventcount_notify(&ec);
+    rc &= PLASMA_TEST_COND(ec.epoch == key + 1);
+    plasma_eventcount_commit_wait(&ec, key);  /*(hangs if key not stale)*/
+    rc &= PLASMA_TEST_COND(ec.waiters == 0);
+    return rc;
+}
+
+/* Waiters register and commit to waiting, count themselves returned, and
+ * then wait on release (so that they never again wait on eventcount).
+ * Thread 0 is the notifier, which waits until all waiters are blocked in the
+ * kernel before notify() and again before notify_all().  notify() returns
+ * at least one waiter (exactly one with Linux futex), and notify_all() then
+ * returns all remaining waiters (lost wakeup hangs, and test is killed by
+ * alarm()).  (Condvar fallback of plasma_futex wakes all waiters in bucket,
+ * which all observe the advanced epoch, so notify_all() might then find no
+ * waiters and leave epoch unchanged) */
+#define PLASMA_EVENTCOUNT_T_WAITERS 4
+
+static struct plasma_eventcount_t_waiters {
+    plasma_eventcount_t ec;
+    uint32_t release;
+    uint32_t returned;
+    uint32_t after_notify;
+    long tids[PLASMA_EVENTCOUNT_T_WAITERS+1];
+} plasma_eventcount_t_waiters;
+
+static void
+plasma_eventcount_t_notifier (void)
+{
+    struct plasma_eventcount_t_waiters * const restrict s =
+      &plasma_eventcount_t_waiters;
+    while (plasma_atomic_load_explicit(&s->ec.waiters, memory_order_seq_cst)
+           != PLASMA_EVENTCOUNT_T_WAITERS)
+        plasma_spin_yield();
+    (void)plasma_test_wait_blocked(s->tids+1, PLASMA_EVENTCOUNT_T_WAITERS);
+    plasma_eventcount_notify(&s->ec);
+    plasma_test_await_count(&s->returned, 1);
+    (void)plasma_test_wait_blocked(s->tids+1, PLASMA_EVENTCOUNT_T_WAITERS);
+    s->after_notify =
+      plasma_atomic_load_explicit(&s->returned, memory_order_seq_cst);
+    plasma_eventcount_notify_all(&s->ec);
+    plasma_test_await_count(&s->returned, PLASMA_EVENTCOUNT_T_WAITERS);
+    plasma_atomic_store_explicit(&s->release, 1, memory_order_release);
+    plasma_futex_wake_all(&s->release);
+}
+
+static void *
+plasma_eventcount_t_waiter (void * const thr_arg)
+{
+    struct plasma_eventcount_t_waiters * const restrict s =
+      &plasma_eventcount_t_waiters;
+    const int id = (int)(uintptr_t)thr_arg;
+    if (id == 0) {
+        plasma_eventcount_t_notifier();
+        return NULL;
+    }
+    s->tids[id] = plasma_test_thread_id();
+    plasma_eventcount_commit_wait(&s->ec,
+                                  plasma_eventcount_prepare_wait(&s->ec));
+    plasma_atomic_fetch_add_u32(&s->returned, 1, memory_order_seq_cst);
+    while (!plasma_atomic_load_explicit(&s->release, memory_order_acquire))
+        plasma_futex_wait(&s->release, 0, PLASMA_FUTEX_INFINITE);
+    return NULL;
+}
+
+static int
+plasma_eventcount_t_notify (void)
+{
+    struct plasma_eventcount_t_waiters * const restrict s =
+      &plasma_eventcount_t_waiters;
+    void *args[PLASMA_EVENTCOUNT_T_WAITERS+1];
+    int i, rc = true;
+    memset(s, 0, sizeof(*s));
+    plasma_eventcount_init(&s->ec);
+    for (i = 0; i <= PLASMA_EVENTCOUNT_T_WAITERS; ++i)
+        args[i] = (void *)(uintptr_t)i;
+    plasma_test_nthreads(PLASMA_EVENTCOUNT_T_WAITERS+1,
+                         plasma_eventcount_t_waiter, args, NULL);
+    rc &= PLASMA_TEST_COND(s->returned == PLASMA_EVENTCOUNT_T_WAITERS);
+    rc &= PLASMA_TEST_COND(s->ec.waiters == 0);
+  #ifdef PLASMA_EVENTCOUNT_T_EXACT
+    rc &= PLASMA_TEST_COND(s->after_notify == 1);
+    rc &= PLASMA_TEST_COND(s->ec.epoch == 2); /* one notify, one notify_all */
+  #else
+    rc &= PLASMA_TEST_COND(s->after_notify >= 1);
+    rc &= PLASMA_TEST_COND(s->ec.epoch == 1 || s->ec.epoch == 2);
+  #endif
+    return rc;
+}
+
+/* one producer publishes items (seq_cst fetch_add) and notifies; consumers
+ * take items (CAS), blocking on eventcount when none available, until the
+ * producer is done and no items remain.  Items taken by all consumers must
+ * sum to items produced */
+static struct plasma_eventcount_t_queue {
+    plasma_eventcount_t ec;
+    uint32_t items;
+    uint32_t produce;
+    uint32_t done;
+} plasma_eventcount_t_queue;
+
+static void *
+plasma_eventcount_t_consumer (void * const thr_arg)
+{
+    struct plasma_eventcount_t_queue * const restrict q =
+      &plasma_eventcount_t_queue;
+    uint32_t * const consumed = thr_arg;
+    uint32_t i, n, key;
+    if (consumed == NULL) {  /* producer */
+        for (i = 0; i < q->produce; ++i) {
+            plasma_atomic_fetch_add_u32(&q->items, 1, memory_order_seq_cst);
+            plasma_eventcount_notify(&q->ec);
+        }
+        plasma_atomic_store_explicit(&q->done, 1, memory_order_seq_cst);
+        plasma_eventcount_notify_all(&q->ec);
+        return NULL;
+    }
+    for (;;) {
+        n = plasma_atomic_load_explicit(&q->items, memory_order_acquire);
+        if (n != 0) {
+            if (plasma_atomic_CAS_32(&q->items, n, n-1))
+                ++*consumed;
+            continue;
+        }
+        if (plasma_atomic_load_explicit(&q->done, memory_order_acquire)
+            && 0 == plasma_atomic_load_explicit(&q->items,
+                                                memory_order_acquire))
+            break;
+        key = plasma_eventcount_prepare_wait(&q->ec);
+        if (plasma_atomic_load_explicit(&q->items, memory_order_seq_cst)
+            || plasma_atomic_load_explicit(&q->done, memory_order_seq_cst))
+            plasma_eventcount_cancel_wait(&q->ec);
+        else
+            plasma_eventcount_commit_wait(&q->ec, key);
+    }
+    return NULL;
+}
+
+static int
+plasma_eventcount_t_producer_consumers (const int nconsumers, const int iters)
+{
+    struct plasma_eventcount_t_queue * const restrict q =
+      &plasma_eventcount_t_queue;
+    uint32_t * const consumed =
+      plasma_test_calloc((size_t)nconsumers, sizeof(uint32_t));
+    void ** const args =
+      plasma_test_calloc((size_t)nconsumers + 1, sizeof(void *));
+    uint64_t t, total = 0;
+    int i, rc = true;
+    if (consumed == NULL || args == NULL)
+        PLASMA_TEST_PERROR_ABORT("plasma_test_calloc", errno);
+    for (i = 0; i < nconsumers; ++i)
+        args[i+1] = &consumed[i];  /* args[0] == NULL is producer */
+    plasma_eventcount_init(&q->ec);
+    q->items = 0;
+    q->done = 0;
+    q->produce = (uint32_t)iters * (uint32_t)nconsumers;
+
+    t = plasma_spin_clock_ns();
+    plasma_test_nthreads(nconsumers + 1, plasma_eventcount_t_consumer,
+                         args, NULL);
+    t = plasma_spin_clock_ns() - t;
+    fprintf(stderr, "plasma_eventcount 1 producer, %d consumers x %d items: "
+                    "%.6f s\n", nconsumers, iters, (double)t / 1000000000.0);
+
+    for (i = 0; i < nconsumers; ++i)
+        total += consumed[i];
+    rc &= PLASMA_TEST_COND(total == q->produce);
+    rc &= PLASMA_TEST_COND(q->items == 0);
+    rc &= PLASMA_TEST_COND(q->ec.waiters == 0);
+    plasma_test_free(args);
+    plasma_test_free(consumed);
+    return rc;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int rc = true;
+    long nprocs = plasma_sysconf_nprocessors_onln();
+    int iters;
+    if (nprocs < 2)
+        nprocs = 2;
+    if (nprocs > 32)
+        nprocs = 32;  /*(place upper bound on num threads created in tests)*/
+    if (argc > 1 && atoi(argv[1]) > 0)
+        nprocs = atoi(argv[1]);
+    iters = (argc > 2 && atoi(argv[2]) > 0) ? atoi(argv[2]) : 100000;
+    alarm(120);
+
+    rc &= plasma_eventcount_t_keys();
+    rc &= plasma_eventcount_t_notify();
+    rc &= plasma_eventcount_t_producer_consumers((int)nprocs - 1, iters);
+    return !rc;
+}
@@ -0,0 +1,223 @@
+/*
+ * plasma_futex.t.c - plasma_futex.[ch] tests
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ *   $ make libplasma.a
+ *   $ gcc -std=c11 -D_XOPEN_SOURCE=700 -O3 -pthread \
+ *       t/plasma_futex.t.c libplasma.a -o plasma_futex.t
+ *   $ ./plasma_futex.t [iterations]
+ *
+ * On Linux, tests confirm that waiters are parked in the kernel (thread state
+ * 'S' in /proc) before waking, and check exact counts of threads woken by
+ * plasma_futex_wake_one(), plasma_futex_wake_n() and plasma_futex_requeue().
+ * (Add -DPLASMA_FUTEX_CONDVAR if libplasma.a was built with it; condvar
+ *  fallback wakes all waiters in a bucket, so exact counts are not checked)
+ */
+
+#ifndef _XOPEN_SOURCE
+#define _XOPEN_SOURCE 600
+#endif
+
+#include "../plasma_atomic.h"
+#include "../plasma_attr.h"
+#include "../plasma_futex.h"
+#include "../plasma_membar.h"
+#include "../plasma_spin.h"
+#include "../plasma_stdtypes.h"
+#include "../plasma_sysconf.h"
+#include "../plasma_test.h"
+
+#ifdef PLASMA_FEATURE_POSIX
+#include <unistd.h>  /* alarm() */
+#endif
+#include <stdlib.h>
+
+#if defined(__linux__) && !defined(PLASMA_FUTEX_CONDVAR)
+#define PLASMA_FUTEX_T_EXACT
+#endif
+
+/* timeouts, and return without waiting if *addr != val */
+static int
+plasma_futex_t_timeout (void)
+{
+    uint32_t word = 0;
+    uint64_t t;
+    int rc = true;
+    rc &= PLASMA_TEST_COND(plasma_futex_wait(&word, 1, PLASMA_FUTEX_INFINITE));
+    rc &= PLASMA_TEST_COND(plasma_futex_wait_shared(&word, 1, 0));
+    t = plasma_spin_clock_ns();
+    rc &= PLASMA_TEST_COND(!plasma_futex_wait(&word, 0, 2000000));
+    rc &= PLASMA_TEST_COND(plasma_spin_clock_ns() - t >= 1000000);
+    plasma_futex_wake_one(&word);  /*(no waiters)*/
+    plasma_futex_wake_n(&word, 2); /*(no waiters)*/
+    plasma_futex_wake_all(&word);  /*(no waiters)*/
+    return rc;
+}
+
+/* two threads alternate incrementing word, each waking the other with
+ * plasma_futex_wake_one() and waiting for its turn; lost wakeup hangs */
+static uint32_t plasma_futex_t_pingpong_word;
+static uint32_t plasma_futex_t_pingpong_end;
+
+static void *
+plasma_futex_t_pingpong (void * const thr_arg)
+{
+    uint32_t * const word = &plasma_futex_t_pingpong_word;
+    const uint32_t parity = (uint32_t)(uintptr_t)thr_arg;
+    const uint32_t end = plasma_futex_t_pingpong_end;
+    uint32_t v;
+    plasma_test_barrier_wait();
+    while ((v = plasma_atomic_load_explicit(word, memory_order_acquire)) < end){
+        if ((v & 1) == parity) {
+            plasma_atomic_store_explicit(word, v+1, memory_order_release);
+            plasma_futex_wake_one(word);
+        }
+        else
+            plasma_futex_wait(word, v, PLASMA_FUTEX_INFINITE);
+    }
+    return NULL;
+}
+
+static int
+plasma_futex_t_pingpong_run (const int iters)
+{
+    void *args[2] = { (void *)(uintptr_t)0, (void *)(uintptr_t)1 };
+    int rc = true;
+    plasma_futex_t_pingpong_word = 0;
+    plasma_futex_t_pingpong_end = 2u * (uint32_t)iters;
+    plasma_test_nthreads(2, plasma_futex_t_pingpong, args, NULL);
+    rc &= PLASMA_TEST_COND(plasma_futex_t_pingpong_word == 2u*(uint32_t)iters);
+    return rc;
+}
+
+/* Waiters each call plasma_futex_wait() once on word, count themselves woken,
+ * and then wait on release (so that they never again wait on word).
+ * Thread 0 is the waker, which wakes waiters in steps and records the number
+ * of waiters woken after each step, once all waiters are again blocked */
+#define PLASMA_FUTEX_T_WAITERS 6
+
+static struct plasma_futex_t_waiters {
+    uint32_t word;
+    uint32_t word2;    /* requeue target */
+    uint32_t release;
+    uint32_t arrived;
+    uint32_t woken;
+    uint32_t after_one;
+    uint32_t after_n;
+    uint32_t after_requeue;
+    uint32_t after_wake_all_empty;
+    uint32_t after_wake_all;
+    long tids[PLASMA_FUTEX_T_WAITERS+1];
+} plasma_futex_t_waiters;
+
+/* wait until all waiters are blocked in kernel (in plasma_futex_wait();
+ * waiters block nowhere else) and then return count of waiters woken */
+static uint32_t
+plasma_futex_t_all_blocked (void)
+{
+    struct plasma_futex_t_waiters * const restrict s = &plasma_futex_t_waiters;
+    (void)plasma_test_wait_blocked(s->tids+1, PLASMA_FUTEX_T_WAITERS);
+    return plasma_atomic_load_explicit(&s->woken, memory_order_seq_cst);
+}
+
+static void
+plasma_futex_t_waker (void)
+{
+    struct plasma_futex_t_waiters * const restrict s = &plasma_futex_t_waiters;
+    while (plasma_atomic_load_explicit(&s->arrived, memory_order_seq_cst)
+           != PLASMA_FUTEX_T_WAITERS)
+        plasma_spin_yield();
+  #ifdef PLASMA_FUTEX_T_EXACT
+    (void)plasma_futex_t_all_blocked();
+    plasma_futex_wake_one(&s->word);
+    plasma_test_await_count(&s->woken, 1);
+    s->after_one = plasma_futex_t_all_blocked();
+    plasma_futex_wake_n(&s->word, 2);
+    plasma_test_await_count(&s->woken, 3);
+    s->after_n = plasma_futex_t_all_blocked();
+    /* wake 1; move remaining waiters to word2 */
+    plasma_futex_requeue(&s->word, 0, 1, &s->word2);
+    plasma_test_await_count(&s->woken, 4);
+    s->after_requeue = plasma_futex_t_all_blocked();
+    plasma_futex_wake_all(&s->word);
+    s->after_wake_all_empty = plasma_futex_t_all_blocked();
+    plasma_futex_wake_all(&s->word2);
+  #else
+    (void)plasma_futex_t_all_blocked();
+    plasma_atomic_store_explicit(&s->word, 1, memory_order_seq_cst);
+    plasma_futex_wake_all(&s->word);
+  #endif
+    plasma_test_await_count(&s->woken, PLASMA_FUTEX_T_WAITERS);
+    s->after_wake_all = plasma_futex_t_all_blocked();
+    plasma_atomic_store_explicit(&s->release, 1, memory_order_release);
+    plasma_futex_wake_all(&s->release);
+}
+
+static void *
+plasma_futex_t_waiter (void * const thr_arg)
+{
+    struct plasma_futex_t_waiters * const restrict s = &plasma_futex_t_waiters;
+    const int id = (int)(uintptr_t)thr_arg;
+    if (id == 0) {
+        plasma_futex_t_waker();
+        return NULL;
+    }
+    s->tids[id] = plasma_test_thread_id();
+    plasma_atomic_fetch_add_u32(&s->arrived, 1, memory_order_seq_cst);
+    plasma_futex_wait(&s->word, 0, PLASMA_FUTEX_INFINITE);
+    plasma_atomic_fetch_add_u32(&s->woken, 1, memory_order_seq_cst);
+    while (!plasma_atomic_load_explicit(&s->release, memory_order_acquire))
+        plasma_futex_wait(&s->release, 0, PLASMA_FUTEX_INFINITE);
+    return NULL;
+}
+
+static int
+plasma_futex_t_wake_counts (void)
+{
+    struct plasma_futex_t_waiters * const restrict s = &plasma_futex_t_waiters;
+    void *args[PLASMA_FUTEX_T_WAITERS+1];
+    int i, rc = true;
+    for (i = 0; i <= PLASMA_FUTEX_T_WAITERS; ++i)
+        args[i] = (void *)(uintptr_t)i;
+    plasma_test_nthreads(PLASMA_FUTEX_T_WAITERS+1, plasma_futex_t_waiter,
+                         args, NULL);
+  #ifdef PLASMA_FUTEX_T_EXACT
+    rc &= PLASMA_TEST_COND(s->after_one == 1);
+    rc &= PLASMA_TEST_COND(s->after_n == 3);
+    rc &= PLASMA_TEST_COND(s->after_requeue == 4);
+    rc &= PLASMA_TEST_COND(s->after_wake_all_empty == 4);
+  #endif
+    rc &= PLASMA_TEST_COND(s->after_wake_all == PLASMA_FUTEX_T_WAITERS);
+    return rc;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int rc = true;
+    int iters = (argc > 1 && atoi(argv[1]) > 0) ? atoi(argv[1]) : 10000;
+    alarm(120);
+
+    rc &= plasma_futex_t_timeout();
+    rc &= plasma_futex_t_pingpong_run(iters);
+    rc &= plasma_futex_t_wake_counts();
+    return !rc;
+}
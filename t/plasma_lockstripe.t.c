@@ -0,0 +1,261 @@
+/*
+ * plasma_lockstripe.t.c - plasma_lockstripe.[ch] tests
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ *   $ make libplasma.a
+ *   $ gcc -std=c11 -D_XOPEN_SOURCE=700 -O3 -pthread \
+ *       t/plasma_lockstripe.t.c libplasma.a -o plasma_lockstripe.t
+ *   $ ./plasma_lockstripe.t [nthreads] [iterations]
+ */
+
+#ifndef _XOPEN_SOURCE
+#define _XOPEN_SOURCE 600
+#endif
+
+#include "../plasma_atomic.h"
+#include "../plasma_attr.h"
+#include "../plasma_lockstripe.h"
+#include "../plasma_membar.h"
+#include "../plasma_spin.h"
+#include "../plasma_stdtypes.h"
+#include "../plasma_sysconf.h"
+#include "../plasma_test.h"
+
+#ifdef PLASMA_FEATURE_POSIX
+#include <unistd.h>  /* alarm() */
+#endif
+#include <stdlib.h>
+
+PLASMA_LOCKSTRIPE_LOCKFNS(plasma_lockstripe_t_tktstripe, plasma_spin_tktlock_t,
+                          plasma_spin_tktlock_acquire,
+                          plasma_spin_tktlock_release)
+
+/* nstripes rounding, stripe alignment, and lock ordering */
+static int
+plasma_lockstripe_t_init (void)
+{
+    plasma_lockstripe_t ls;
+    uint32_t i, n = plasma_lockstripe_nstripes(0);
+    uint32_t idx[4] = { 5, 1, 5, 3 };
+    int rc = true;
+    rc &= PLASMA_TEST_COND(n != 0 && (n & (n-1)) == 0);
+    rc &= PLASMA_TEST_COND(n <= PLASMA_LOCKSTRIPE_MAX);
+    rc &= PLASMA_TEST_COND(plasma_lockstripe_order(idx, 4) == 3);
+    rc &= PLASMA_TEST_COND(idx[0] == 1 && idx[1] == 3 && idx[2] == 5);
+
+    if (!plasma_lockstripe_init(&ls, 5, sizeof(plasma_spin_tktlock_t)))
+        return PLASMA_TEST_COND(false);
+    rc &= PLASMA_TEST_COND(plasma_lockstripe_count(&ls) == 8);
+    rc &= PLASMA_TEST_COND(ls.stride == PLASMA_LOCKSTRIPE_ALIGN);
+    for (i = 0; i < plasma_lockstripe_count(&ls); ++i) {
+        rc &= PLASMA_TEST_COND(
+                (uintptr_t)plasma_lockstripe_lock_at(&ls, i)
+                  % PLASMA_LOCKSTRIPE_ALIGN == 0);
+        rc &= PLASMA_TEST_COND(plasma_spin_tktlock_is_free(
+                (plasma_spin_tktlock_t *)plasma_lockstripe_lock_at(&ls, i)));
+    }
+    rc &= PLASMA_TEST_COND(plasma_lockstripe_t_tktstripe_lock_for(&ls, &ls)
+                           == plasma_lockstripe_t_tktstripe_lock_for_hash(
+                                &ls, (uint64_t)(uintptr_t)&ls));
+    plasma_lockstripe_destroy(&ls);
+
+    /* (lock larger than PLASMA_LOCKSTRIPE_ALIGN padded to multiple) */
+    if (!plasma_lockstripe_init(&ls, 1, PLASMA_LOCKSTRIPE_ALIGN + 1))
+        return PLASMA_TEST_COND(false);
+    rc &= PLASMA_TEST_COND(plasma_lockstripe_count(&ls) == 1);
+    rc &= PLASMA_TEST_COND(ls.stride == 2 * PLASMA_LOCKSTRIPE_ALIGN);
+    plasma_lockstripe_destroy(&ls);
+
+    if (!plasma_lockstripe_init(&ls, 0, sizeof(plasma_spin_tktlock_t)))
+        return PLASMA_TEST_COND(false);
+    rc &= PLASMA_TEST_COND(plasma_lockstripe_count(&ls) == n);
+    plasma_lockstripe_destroy(&ls);
+    return rc;
+}
+
+/* index is top log2(nstripes) bits of Fibonacci hash; aligned addresses
+ * (low bits zero) spread across all stripes */
+static int
+plasma_lockstripe_t_index (void)
+{
+    static const uint32_t nstripes[] = { 1, 2, 8, 64, 1024 };
+    static uint32_t hist[1024];
+    plasma_lockstripe_t ls;
+    uint32_t i, j, k, log2, n, x, min, max;
+    uint64_t h;
+    int rc = true;
+    for (i = 0; i < sizeof(nstripes)/sizeof(*nstripes); ++i) {
+        n = nstripes[i];
+        for (log2 = 0; (1u << log2) < n; ++log2) ;
+        if (!plasma_lockstripe_init(&ls, n, sizeof(plasma_spin_tktlock_t)))
+            return PLASMA_TEST_COND(false);
+        rc &= PLASMA_TEST_COND(plasma_lockstripe_count(&ls) == n);
+        for (j = 0; j < n; ++j)
+            hist[j] = 0;
+        for (j = 0; j < 64 * n; ++j) {
+            h = (uint64_t)j * 4096;  /*(page-aligned "addresses")*/
+            x = plasma_lockstripe_index(&ls, h);
+            rc &= PLASMA_TEST_COND(x < n);
+            rc &= PLASMA_TEST_COND(x == (log2 == 0
+                    ? 0
+                    : (uint32_t)((h * UINT64_C(0x9E3779B97F4A7C15))
+                                 >> (64 - log2))));
+            ++hist[x];
+            /* (low bits of hash do not select stripe alone) */
+            x = plasma_lockstripe_index(&ls, (uint64_t)j);
+            rc &= PLASMA_TEST_COND(x < n);
+        }
+        rc &= PLASMA_TEST_COND(
+                plasma_lockstripe_index_ptr(&ls, &ls)
+                  == plasma_lockstripe_index(&ls, (uint64_t)(uintptr_t)&ls));
+        /* (each stripe receives between 1/2 and 2x its even share of 64) */
+        for (min = ~0u, max = 0, k = 0; k < n; ++k) {
+            if (min > hist[k]) min = hist[k];
+            if (max < hist[k]) max = hist[k];
+        }
+        rc &= PLASMA_TEST_COND(min >= 32 && max <= 128);
+        plasma_lockstripe_destroy(&ls);
+        if (!rc)
+            break;
+    }
+    return rc;
+}
+
+/* zero-filled plasma_spin_rwlock_t stripes are PLASMA_SPIN_RWLOCK_WRPREF */
+static int
+plasma_lockstripe_t_rwlock (void)
+{
+    plasma_lockstripe_t ls;
+    plasma_spin_rwlock_t *rw;
+    uint32_t i;
+    int rc = true;
+    if (!plasma_lockstripe_init(&ls, 4, sizeof(plasma_spin_rwlock_t)))
+        return PLASMA_TEST_COND(false);
+    rc &= PLASMA_TEST_COND(ls.stride % PLASMA_LOCKSTRIPE_ALIGN == 0);
+    for (i = 0; i < plasma_lockstripe_count(&ls); ++i) {
+        rw = (plasma_spin_rwlock_t *)plasma_lockstripe_lock_at(&ls, i);
+        rc &= PLASMA_TEST_COND(rw->mode == PLASMA_SPIN_RWLOCK_WRPREF);
+        rc &= PLASMA_TEST_COND(plasma_spin_rwlock_rdlock(rw));
+        rc &= PLASMA_TEST_COND(plasma_spin_rwlock_tryrdlock(rw));
+        rc &= PLASMA_TEST_COND(!plasma_spin_rwlock_trywrlock(rw));
+        plasma_spin_rwlock_unlock(rw);
+        plasma_spin_rwlock_unlock(rw);
+        rc &= PLASMA_TEST_COND(plasma_spin_rwlock_wrlock(rw));
+        rc &= PLASMA_TEST_COND(!plasma_spin_rwlock_tryrdlock(rw));
+        plasma_spin_rwlock_unlock(rw);
+        rc &= PLASMA_TEST_COND(plasma_spin_rwlock_trywrlock(rw));
+        plasma_spin_rwlock_unlock(rw);
+    }
+    /* (stripes independent) */
+    rw = (plasma_spin_rwlock_t *)plasma_lockstripe_lock_at(&ls, 0);
+    rc &= PLASMA_TEST_COND(plasma_spin_rwlock_wrlock(rw));
+    rc &= PLASMA_TEST_COND(plasma_spin_rwlock_trywrlock(
+            (plasma_spin_rwlock_t *)plasma_lockstripe_lock_at(&ls, 1)));
+    plasma_spin_rwlock_unlock(
+      (plasma_spin_rwlock_t *)plasma_lockstripe_lock_at(&ls, 1));
+    plasma_spin_rwlock_unlock(rw);
+    plasma_lockstripe_destroy(&ls);
+    return rc;
+}
+
+/* each thread moves units between two stripes' counters, acquiring both
+ * stripes (ordered); total is conserved */
+#define PLASMA_LOCKSTRIPE_T_STRIPES 8
+
+static struct plasma_lockstripe_t_shared {
+    plasma_lockstripe_t ls;
+    uint32_t counts[PLASMA_LOCKSTRIPE_T_STRIPES];
+    uint32_t thrid;
+    uint32_t iters;
+} plasma_lockstripe_t_shared;
+
+static void *
+plasma_lockstripe_t_thread (void * const thr_arg)
+{
+    struct plasma_lockstripe_t_shared * const restrict s =
+      &plasma_lockstripe_t_shared;
+    const uint32_t k = plasma_atomic_fetch_add_u32(&s->thrid, 1,
+                                                   memory_order_relaxed);
+    uint32_t i, n, idx[3];
+    (void)thr_arg;
+    plasma_test_barrier_wait();
+    for (i = 0; i < s->iters; ++i) {
+        /* (reverse order in alternate threads; duplicate index) */
+        idx[0] = (k & 1) ? (i + 1) & (PLASMA_LOCKSTRIPE_T_STRIPES-1)
+                         : (i * 3) & (PLASMA_LOCKSTRIPE_T_STRIPES-1);
+        idx[1] = (k & 1) ? (i * 3) & (PLASMA_LOCKSTRIPE_T_STRIPES-1)
+                         : (i + 1) & (PLASMA_LOCKSTRIPE_T_STRIPES-1);
+        idx[2] = idx[0];
+        n = plasma_lockstripe_t_tktstripe_acquire_n(&s->ls, idx, 3);
+        --s->counts[idx[0]];
+        ++s->counts[idx[n-1]];
+        plasma_lockstripe_t_tktstripe_release_n(&s->ls, idx, n);
+    }
+    return NULL;
+}
+
+static int
+plasma_lockstripe_t_nthreads (const int nthreads, const int iters)
+{
+    struct plasma_lockstripe_t_shared * const restrict s =
+      &plasma_lockstripe_t_shared;
+    uint32_t i, sum = 0;
+    int rc = true;
+    if (!plasma_lockstripe_init(&s->ls, PLASMA_LOCKSTRIPE_T_STRIPES,
+                                sizeof(plasma_spin_tktlock_t)))
+        return PLASMA_TEST_COND(false);
+    for (i = 0; i < PLASMA_LOCKSTRIPE_T_STRIPES; ++i)
+        s->counts[i] = 1000;
+    s->thrid = 0;
+    s->iters = (uint32_t)iters;
+    plasma_test_nthreads(nthreads < 2 ? 2 : nthreads,
+                         plasma_lockstripe_t_thread, NULL, NULL);
+    for (i = 0; i < PLASMA_LOCKSTRIPE_T_STRIPES; ++i) {
+        sum += s->counts[i];
+        rc &= PLASMA_TEST_COND(plasma_spin_tktlock_is_free(
+                (plasma_spin_tktlock_t *)plasma_lockstripe_lock_at(&s->ls, i)));
+    }
+    rc &= PLASMA_TEST_COND(sum == 1000 * PLASMA_LOCKSTRIPE_T_STRIPES);
+    plasma_lockstripe_destroy(&s->ls);
+    return rc;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int rc = true;
+    long nprocs = plasma_sysconf_nprocessors_onln();
+    int iters;
+    if (nprocs < 1)
+        nprocs = 1;
+    if (nprocs > 32)
+        nprocs = 32;  /*(place upper bound on num threads created in tests)*/
+    if (argc > 1 && atoi(argv[1]) > 0)
+        nprocs = atoi(argv[1]);
+    iters = (argc > 2 && atoi(argv[2]) > 0) ? atoi(argv[2]) : 100000;
+    alarm(120);
+
+    rc &= plasma_lockstripe_t_init();
+    rc &= plasma_lockstripe_t_index();
+    rc &= plasma_lockstripe_t_rwlock();
+    rc &= plasma_lockstripe_t_nthreads((int)nprocs, iters);
+    return !rc;
+}
@@ -0,0 +1,172 @@
+/*
+ * plasma_once.t.c - plasma_once.[ch] tests
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ *   $ make libplasma.a
+ *   $ gcc -std=c11 -D_XOPEN_SOURCE=700 -O3 -pthread \
+ *       t/plasma_once.t.c libplasma.a -o plasma_once.t
+ *   $ ./plasma_once.t [nthreads] [rounds]
+ */
+
+#ifndef _XOPEN_SOURCE
+#define _XOPEN_SOURCE 600
+#endif
+
+#include "../plasma_atomic.h"
+#include "../plasma_attr.h"
+#include "../plasma_membar.h"
+#include "../plasma_once.h"
+#include "../plasma_spin.h"
+#include "../plasma_stdtypes.h"
+#include "../plasma_sysconf.h"
+#include "../plasma_test.h"
+
+#ifdef PLASMA_FEATURE_POSIX
+#include <unistd.h>  /* alarm() */
+#endif
+#include <stdlib.h>
+
+static uint32_t plasma_once_t_calls;
+static uint32_t plasma_once_t_calls2;
+
+static void
+plasma_once_t_func (void)
+{
+    ++plasma_once_t_calls;
+}
+
+static void
+plasma_once_t_func2 (void)
+{
+    ++plasma_once_t_calls2;
+}
+
+/* single thread: func runs on first call only; flags are independent */
+static int
+plasma_once_t_single (void)
+{
+    plasma_once_t once  = PLASMA_ONCE_INITIALIZER;
+    plasma_once_t once2 = PLASMA_ONCE_INITIALIZER;
+    int rc = true;
+    plasma_once_t_calls = 0;
+    plasma_once_t_calls2 = 0;
+    rc &= PLASMA_TEST_COND(!plasma_once_is_done(&once));
+    plasma_call_once(&once, plasma_once_t_func);
+    rc &= PLASMA_TEST_COND(plasma_once_is_done(&once));
+    rc &= PLASMA_TEST_COND(plasma_once_t_calls == 1);
+    plasma_call_once(&once, plasma_once_t_func);
+    plasma_call_once(&once, plasma_once_t_func2);
+    rc &= PLASMA_TEST_COND(plasma_once_t_calls == 1);
+    rc &= PLASMA_TEST_COND(plasma_once_t_calls2 == 0);
+    rc &= PLASMA_TEST_COND(!plasma_once_is_done(&once2));
+    plasma_call_once(&once2, plasma_once_t_func2);
+    rc &= PLASMA_TEST_COND(plasma_once_t_calls2 == 1);
+    plasma_once_init(&once);
+    rc &= PLASMA_TEST_COND(!plasma_once_is_done(&once));
+    plasma_call_once(&once, plasma_once_t_func);
+    rc &= PLASMA_TEST_COND(plasma_once_t_calls == 2);
+    return rc;
+}
+
+/* Threads race to plasma_call_once().  func runs while all other threads are
+ * inside plasma_call_once(), and does not complete until some thread has
+ * marked flag PLASMA_ONCE_WAITERS (i.e. is about to block), so concurrent
+ * callers are always exercised.  Every caller must observe stores made by
+ * func, and func must run exactly once per round */
+static struct plasma_once_t_shared {
+    plasma_once_t once;
+    uint32_t entered;
+    uint32_t nthreads;
+    uint32_t calls;
+    uint32_t value;
+    uint32_t stale;   /* callers which returned before observing value */
+} plasma_once_t_shared;
+
+static void
+plasma_once_t_racefunc (void)
+{
+    struct plasma_once_t_shared * const restrict s = &plasma_once_t_shared;
+    plasma_atomic_fetch_add_u32(&s->calls, 1, memory_order_relaxed);
+    while (plasma_atomic_load_explicit(&s->entered, memory_order_relaxed)
+           != s->nthreads)
+        plasma_spin_yield();
+    while (plasma_atomic_load_explicit(&s->once.state, memory_order_relaxed)
+           != PLASMA_ONCE_WAITERS)
+        plasma_spin_yield();
+    s->value = 42;
+}
+
+static void *
+plasma_once_t_race (void * const thr_arg)
+{
+    struct plasma_once_t_shared * const restrict s = &plasma_once_t_shared;
+    (void)thr_arg;
+    plasma_test_barrier_wait();
+    plasma_atomic_fetch_add_u32(&s->entered, 1, memory_order_relaxed);
+    plasma_call_once(&s->once, plasma_once_t_racefunc);
+    if (s->value != 42)
+        plasma_atomic_fetch_add_u32(&s->stale, 1, memory_order_relaxed);
+    return NULL;
+}
+
+static int
+plasma_once_t_nthreads (const int nthreads, const int rounds)
+{
+    struct plasma_once_t_shared * const restrict s = &plasma_once_t_shared;
+    int i, rc = true;
+    s->nthreads = (uint32_t)(nthreads < 2 ? 2 : nthreads);
+    for (i = 0; i < rounds; ++i) {
+        plasma_once_init(&s->once);
+        s->entered = 0;
+        s->calls = 0;
+        s->value = 0;
+        s->stale = 0;
+        plasma_test_nthreads((int)s->nthreads, plasma_once_t_race, NULL, NULL);
+        rc &= PLASMA_TEST_COND(s->calls == 1);
+        rc &= PLASMA_TEST_COND(s->stale == 0);
+        rc &= PLASMA_TEST_COND(plasma_once_is_done(&s->once));
+        plasma_call_once(&s->once, plasma_once_t_racefunc);
+        rc &= PLASMA_TEST_COND(s->calls == 1);
+        if (!rc)
+            break;
+    }
+    return rc;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int rc = true;
+    long nprocs = plasma_sysconf_nprocessors_onln();
+    int rounds;
+    if (nprocs < 1)
+        nprocs = 1;
+    if (nprocs > 32)
+        nprocs = 32;  /*(place upper bound on num threads created in tests)*/
+    if (argc > 1 && atoi(argv[1]) > 0)
+        nprocs = atoi(argv[1]);
+    rounds = (argc > 2 && atoi(argv[2]) > 0) ? atoi(argv[2]) : 100;
+    alarm(120);
+
+    rc &= plasma_once_t_single();
+    rc &= plasma_once_t_nthreads((int)nprocs, rounds);
+    return !rc;
+}
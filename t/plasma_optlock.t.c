@@ -0,0 +1,206 @@
+/*
+ * plasma_optlock.t.c - plasma_optlock.[ch] tests
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ *   $ make libplasma.a
+ *   $ gcc -std=c11 -D_XOPEN_SOURCE=700 -O3 -pthread \
+ *       t/plasma_optlock.t.c libplasma.a -o plasma_optlock.t
+ *   $ ./plasma_optlock.t [nthreads] [iterations]
+ */
+
+#ifndef _XOPEN_SOURCE
+#define _XOPEN_SOURCE 600
+#endif
+
+#include "../plasma_atomic.h"
+#include "../plasma_attr.h"
+#include "../plasma_membar.h"
+#include "../plasma_optlock.h"
+#include "../plasma_stdtypes.h"
+#include "../plasma_sysconf.h"
+#include "../plasma_test.h"
+
+#ifdef PLASMA_FEATURE_POSIX
+#include <unistd.h>  /* alarm() */
+#endif
+#include <stdlib.h>
+
+/* single thread: version advances on each write; validate fails across a
+ * write; upgrade succeeds only from an unchanged, unlocked version; obsolete
+ * node refuses readers and writers */
+static int
+plasma_optlock_t_single (void)
+{
+    plasma_optlock_t ol = PLASMA_OPTLOCK_INITIALIZER;
+    uint64_t v, v2, v3;
+    int rc = true;
+
+    rc &= PLASMA_TEST_COND(plasma_optlock_read_begin(&ol, &v));
+    rc &= PLASMA_TEST_COND(v == 0);
+    rc &= PLASMA_TEST_COND(plasma_optlock_read_validate(&ol, v));
+    rc &= PLASMA_TEST_COND(plasma_optlock_write_lock(&ol));
+    rc &= PLASMA_TEST_COND(plasma_optlock_is_locked(ol.word));
+    rc &= PLASMA_TEST_COND(!plasma_optlock_read_validate(&ol, v));
+    rc &= PLASMA_TEST_COND(!plasma_optlock_upgrade(&ol, v));  /*(locked)*/
+    plasma_optlock_write_unlock(&ol);
+    rc &= PLASMA_TEST_COND(!plasma_optlock_is_locked(ol.word));
+    rc &= PLASMA_TEST_COND(!plasma_optlock_read_validate(&ol, v));
+    rc &= PLASMA_TEST_COND(!plasma_optlock_upgrade(&ol, v));  /*(stale)*/
+
+    rc &= PLASMA_TEST_COND(plasma_optlock_read_begin(&ol, &v2) && v2 != v);
+    rc &= PLASMA_TEST_COND(v2 == v + 2 * PLASMA_OPTLOCK_LOCKED);
+    rc &= PLASMA_TEST_COND(plasma_optlock_read_begin(&ol, &v3) && v3 == v2);
+    rc &= PLASMA_TEST_COND(plasma_optlock_upgrade(&ol, v2));
+    rc &= PLASMA_TEST_COND(!plasma_optlock_upgrade(&ol, v3)); /*(one winner)*/
+    plasma_optlock_write_unlock(&ol);
+    rc &= PLASMA_TEST_COND(!plasma_optlock_upgrade(&ol, v3));
+
+    rc &= PLASMA_TEST_COND(plasma_optlock_read_begin(&ol, &v2));
+    rc &= PLASMA_TEST_COND(plasma_optlock_upgrade(&ol, v2));
+    plasma_optlock_write_unlock_obsolete(&ol);
+    rc &= PLASMA_TEST_COND(plasma_optlock_is_obsolete(ol.word));
+    rc &= PLASMA_TEST_COND(!plasma_optlock_is_locked(ol.word));
+    rc &= PLASMA_TEST_COND(!plasma_optlock_read_validate(&ol, v2));
+    rc &= PLASMA_TEST_COND(!plasma_optlock_read_begin(&ol, &v));
+    rc &= PLASMA_TEST_COND(!plasma_optlock_write_lock(&ol));
+    rc &= PLASMA_TEST_COND(!plasma_optlock_upgrade(&ol, v2));
+
+    plasma_optlock_init(&ol);
+    rc &= PLASMA_TEST_COND(ol.word == 0);
+    return rc;
+}
+
+/* Writers (odd thread ids) move units between two fields (sum conserved)
+ * with write_lock or upgrade of a snapshot; readers (even thread ids) read
+ * both fields optimistically.  Snapshots must never be locked, validated
+ * reads must never be torn, a successful upgrade must find the fields as read
+ * under the snapshot, and the version must advance once per write */
+static struct plasma_optlock_t_shared {
+    plasma_optlock_t ol;
+    uint32_t a;
+    uint32_t b;
+    uint32_t thrid;
+    uint32_t iters;
+    uint32_t validated;
+    uint32_t writes;
+    uint32_t upgrades;
+    uint32_t fails;
+} plasma_optlock_t_shared;
+
+static void *
+plasma_optlock_t_thread (void * const thr_arg)
+{
+    struct plasma_optlock_t_shared * const restrict s =
+      &plasma_optlock_t_shared;
+    const uint32_t k = plasma_atomic_fetch_add_u32(&s->thrid, 1,
+                                                   memory_order_relaxed);
+    uint32_t i, a, b, nvalid = 0, nwrite = 0, nupgrade = 0, nfail = 0;
+    uint64_t v;
+    (void)thr_arg;
+    plasma_test_barrier_wait();
+    for (i = 0; i < s->iters; ++i) {
+        if (!plasma_optlock_read_begin(&s->ol, &v)) {
+            ++nfail;  /*(not expected; node never obsoleted here)*/
+            continue;
+        }
+        if (plasma_optlock_is_locked(v))
+            ++nfail;
+        a = plasma_atomic_load_explicit(&s->a, memory_order_relaxed);
+        b = plasma_atomic_load_explicit(&s->b, memory_order_relaxed);
+        if (!(k & 1)) {  /* reader */
+            if (plasma_optlock_read_validate(&s->ol, v)) {
+                ++nvalid;
+                if (a + b != 1000)
+                    ++nfail;
+            }
+            continue;
+        }
+        /* writer: upgrade snapshot on alternate iterations, else lock */
+        if ((i & 1) && plasma_optlock_upgrade(&s->ol, v)) {
+            ++nupgrade;
+            if (a != plasma_atomic_load_explicit(&s->a, memory_order_relaxed)
+             || b != plasma_atomic_load_explicit(&s->b, memory_order_relaxed))
+                ++nfail;
+        }
+        else {
+            plasma_optlock_write_lock(&s->ol);
+            a = plasma_atomic_load_explicit(&s->a, memory_order_relaxed);
+            b = plasma_atomic_load_explicit(&s->b, memory_order_relaxed);
+        }
+        plasma_atomic_store_explicit(&s->a, a - 1, memory_order_relaxed);
+        plasma_atomic_store_explicit(&s->b, b + 1, memory_order_relaxed);
+        plasma_optlock_write_unlock(&s->ol);
+        ++nwrite;
+    }
+    plasma_atomic_fetch_add_u32(&s->validated, nvalid, memory_order_relaxed);
+    plasma_atomic_fetch_add_u32(&s->writes, nwrite, memory_order_relaxed);
+    plasma_atomic_fetch_add_u32(&s->upgrades, nupgrade, memory_order_relaxed);
+    plasma_atomic_fetch_add_u32(&s->fails, nfail, memory_order_relaxed);
+    return NULL;
+}
+
+static int
+plasma_optlock_t_nthreads (const int nthreads, const int iters)
+{
+    struct plasma_optlock_t_shared * const restrict s =
+      &plasma_optlock_t_shared;
+    const int n = nthreads < 2 ? 2 : nthreads;
+    int rc = true;
+    plasma_optlock_init(&s->ol);
+    s->a = 1000;
+    s->b = 0;
+    s->thrid = 0;
+    s->iters = (uint32_t)iters;
+    s->validated = 0;
+    s->writes = 0;
+    s->upgrades = 0;
+    s->fails = 0;
+    plasma_test_nthreads(n, plasma_optlock_t_thread, NULL, NULL);
+    rc &= PLASMA_TEST_COND(s->fails == 0);
+    rc &= PLASMA_TEST_COND(s->validated != 0);
+    rc &= PLASMA_TEST_COND(s->upgrades != 0);
+    rc &= PLASMA_TEST_COND(s->writes == s->iters * (uint32_t)(n / 2));
+    rc &= PLASMA_TEST_COND(s->a + s->b == 1000);
+    rc &= PLASMA_TEST_COND(s->b == s->writes);
+    rc &= PLASMA_TEST_COND(s->ol.word
+                           == (uint64_t)s->writes * 2 * PLASMA_OPTLOCK_LOCKED);
+    return rc;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int rc = true;
+    long nprocs = plasma_sysconf_nprocessors_onln();
+    int iters;
+    if (nprocs < 1)
+        nprocs = 1;
+    if (nprocs > 32)
+        nprocs = 32;  /*(place upper bound on num threads created in tests)*/
+    if (argc > 1 && atoi(argv[1]) > 0)
+        nprocs = atoi(argv[1]);
+    iters = (argc > 2 && atoi(argv[2]) > 0) ? atoi(argv[2]) : 100000;
+    alarm(120);
+
+    rc &= plasma_optlock_t_single();
+    rc &= plasma_optlock_t_nthreads((int)nprocs, iters);
+    return !rc;
+}
@@ -0,0 +1,373 @@
+/*
+ * plasma_parkinglot.t.c - plasma_parkinglot.[ch] tests
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ *   $ make libplasma.a
+ *   $ gcc -std=c11 -D_XOPEN_SOURCE=700 -O3 -pthread \
+ *       t/plasma_parkinglot.t.c libplasma.a -o plasma_parkinglot.t
+ *   $ ./plasma_parkinglot.t [nthreads] [iterations]
+ *
+ * On Linux, tests confirm that parked threads are blocked in the kernel
+ * (thread state 'S' in /proc) before unparking.  Elsewhere, tests pause to
+ * let threads park (parked threads are queued before they block, so counts
+ * are exact either way).
+ */
+
+#ifndef _XOPEN_SOURCE
+#define _XOPEN_SOURCE 600
+#endif
+
+#include "../plasma_atomic.h"
+#include "../plasma_attr.h"
+#include "../plasma_futex.h"
+#include "../plasma_membar.h"
+#include "../plasma_parkinglot.h"
+#include "../plasma_spin.h"
+#include "../plasma_stdtypes.h"
+#include "../plasma_sysconf.h"
+#include "../plasma_test.h"
+
+#ifdef PLASMA_FEATURE_POSIX
+#include <unistd.h>  /* alarm() */
+#endif
+#include <stdlib.h>
+#include <string.h>  /* memset() */
+
+static bool
+plasma_parkinglot_t_false (void * const arg)
+{
+    (void)arg;
+    return false;
+}
+
+/* single thread: timeout, validate, unpark with no parked threads */
+static int
+plasma_parkinglot_t_basic (void)
+{
+    uint32_t word = 0;
+    uint64_t t;
+    int rc = true;
+    t = plasma_spin_clock_ns();
+    rc &= PLASMA_TEST_COND(plasma_parkinglot_park(&word, NULL, NULL, 1000000)
+                           == PLASMA_PARKINGLOT_TIMEOUT);
+    rc &= PLASMA_TEST_COND(plasma_spin_clock_ns() - t >= 500000);
+    rc &= PLASMA_TEST_COND(plasma_parkinglot_park(&word,
+                                                  plasma_parkinglot_t_false,
+                                                  NULL, PLASMA_FUTEX_INFINITE)
+                           == PLASMA_PARKINGLOT_INVALID);
+    rc &= PLASMA_TEST_COND(!plasma_parkinglot_unpark_one(&word, NULL, NULL));
+    rc &= PLASMA_TEST_COND(plasma_parkinglot_unpark_all(&word) == 0);
+    /* (timed out thread must have been dequeued) */
+    rc &= PLASMA_TEST_COND(plasma_parkinglot_unpark_all(&word) == 0);
+    return rc;
+}
+
+/* Parkers park on addr (or, the last parker, on addr2), recording the order
+ * in which they were queued (validate runs under bucket lock), and then wait
+ * on release.  Thread 0 is the coordinator, which unparks in steps and
+ * records the threads unparked after each step, once all parkers are again
+ * blocked */
+#define PLASMA_PARKINGLOT_T_PARKERS 6
+
+static struct plasma_parkinglot_t_parkers {
+    uint32_t addr;
+    uint32_t addr2;
+    uint32_t release;
+    uint32_t queued;
+    uint32_t woken;
+    uint32_t results;     /* parkers with PLASMA_PARKINGLOT_UNPARKED result */
+    uint32_t first;       /* queue position of first unparked thread */
+    uint32_t after_one;
+    uint32_t unpark_one_rc;
+    uint32_t cb_calls;
+    uint32_t cb_did_unpark;
+    uint32_t cb_may_have_more;
+    uint32_t after_all;
+    uint32_t unpark_all_rc;
+    uint32_t unpark_none_rc;
+    uint32_t after_all2;
+    uint32_t unpark_all2_rc;
+    uint32_t pos[PLASMA_PARKINGLOT_T_PARKERS+1];
+    long tids[PLASMA_PARKINGLOT_T_PARKERS+1];
+} plasma_parkinglot_t_parkers;
+
+/* wait until all parkers are blocked in kernel and then return count of
+ * parkers unparked (parkers which are unparked block only on release) */
+static uint32_t
+plasma_parkinglot_t_all_blocked (void)
+{
+    struct plasma_parkinglot_t_parkers * const restrict s =
+      &plasma_parkinglot_t_parkers;
+    (void)plasma_test_wait_blocked(s->tids+1, PLASMA_PARKINGLOT_T_PARKERS);
+    return plasma_atomic_load_explicit(&s->woken, memory_order_seq_cst);
+}
+
+static bool
+plasma_parkinglot_t_validate (void * const arg)
+{
+    /* (runs under bucket lock, in order parkers are queued) */
+    *(uint32_t *)arg = plasma_parkinglot_t_parkers.queued++;
+    return true;
+}
+
+static void
+plasma_parkinglot_t_callback (void * const arg, const bool did_unpark,
+                              const bool may_have_more)
+{
+    struct plasma_parkinglot_t_parkers * const restrict s =
+      (struct plasma_parkinglot_t_parkers *)arg;
+    ++s->cb_calls;
+    s->cb_did_unpark    += did_unpark;
+    s->cb_may_have_more += may_have_more;
+}
+
+static void
+plasma_parkinglot_t_coordinator (void)
+{
+    struct plasma_parkinglot_t_parkers * const restrict s =
+      &plasma_parkinglot_t_parkers;
+    while (plasma_atomic_load_explicit(&s->queued, memory_order_seq_cst)
+           != PLASMA_PARKINGLOT_T_PARKERS)
+        plasma_spin_yield();
+    (void)plasma_parkinglot_t_all_blocked();
+    s->unpark_one_rc =
+      plasma_parkinglot_unpark_one(&s->addr, plasma_parkinglot_t_callback, s);
+    plasma_test_await_count(&s->woken, 1);
+    s->after_one = plasma_parkinglot_t_all_blocked();
+    s->unpark_all_rc = plasma_parkinglot_unpark_all(&s->addr);
+    plasma_test_await_count(&s->woken, PLASMA_PARKINGLOT_T_PARKERS - 1);
+    s->after_all = plasma_parkinglot_t_all_blocked();
+    /* (callback is called even if no thread unparked) */
+    s->unpark_none_rc =
+      plasma_parkinglot_unpark_one(&s->addr, plasma_parkinglot_t_callback, s);
+    s->unpark_all2_rc = plasma_parkinglot_unpark_all(&s->addr2);
+    plasma_test_await_count(&s->woken, PLASMA_PARKINGLOT_T_PARKERS);
+    s->after_all2 = plasma_parkinglot_t_all_blocked();
+    plasma_atomic_store_explicit(&s->release, 1, memory_order_release);
+    plasma_futex_wake_all(&s->release);
+}
+
+static void *
+plasma_parkinglot_t_parker (void * const thr_arg)
+{
+    struct plasma_parkinglot_t_parkers * const restrict s =
+      &plasma_parkinglot_t_parkers;
+    const int id = (int)(uintptr_t)thr_arg;
+    uint32_t * const addr =
+      (id == PLASMA_PARKINGLOT_T_PARKERS) ? &s->addr2 : &s->addr;
+    if (id == 0) {
+        plasma_parkinglot_t_coordinator();
+        return NULL;
+    }
+    s->tids[id] = plasma_test_thread_id();
+    if (id == PLASMA_PARKINGLOT_T_PARKERS) {
+        /* (park on addr2 after all others have queued on addr) */
+        while (plasma_atomic_load_explicit(&s->queued, memory_order_seq_cst)
+               != PLASMA_PARKINGLOT_T_PARKERS - 1)
+            plasma_spin_yield();
+    }
+    if (plasma_parkinglot_park(addr, plasma_parkinglot_t_validate, &s->pos[id],
+                               PLASMA_FUTEX_INFINITE)
+        == PLASMA_PARKINGLOT_UNPARKED)
+        plasma_atomic_fetch_add_u32(&s->results, 1, memory_order_relaxed);
+    if (plasma_atomic_fetch_add_u32(&s->woken, 1, memory_order_seq_cst) == 0)
+        s->first = s->pos[id];
+    while (!plasma_atomic_load_explicit(&s->release, memory_order_acquire))
+        plasma_futex_wait(&s->release, 0, PLASMA_FUTEX_INFINITE);
+    return NULL;
+}
+
+/* unpark_one unparks first queued thread (FIFO) and reports to callback;
+ * unpark_all unparks all threads parked on addr (and not on other addr) */
+static int
+plasma_parkinglot_t_unpark (void)
+{
+    struct plasma_parkinglot_t_parkers * const restrict s =
+      &plasma_parkinglot_t_parkers;
+    void *args[PLASMA_PARKINGLOT_T_PARKERS+1];
+    int i, rc = true;
+    memset(s, 0, sizeof(*s));
+    for (i = 0; i <= PLASMA_PARKINGLOT_T_PARKERS; ++i)
+        args[i] = (void *)(uintptr_t)i;
+    plasma_test_nthreads(PLASMA_PARKINGLOT_T_PARKERS+1,
+                         plasma_parkinglot_t_parker, args, NULL);
+    rc &= PLASMA_TEST_COND(s->unpark_one_rc == 1);
+    rc &= PLASMA_TEST_COND(s->after_one == 1);
+    rc &= PLASMA_TEST_COND(s->first == 0);
+    rc &= PLASMA_TEST_COND(s->unpark_all_rc == PLASMA_PARKINGLOT_T_PARKERS-2);
+    rc &= PLASMA_TEST_COND(s->after_all == PLASMA_PARKINGLOT_T_PARKERS - 1);
+    rc &= PLASMA_TEST_COND(s->unpark_none_rc == 0);
+    rc &= PLASMA_TEST_COND(s->unpark_all2_rc == 1);
+    rc &= PLASMA_TEST_COND(s->after_all2 == PLASMA_PARKINGLOT_T_PARKERS);
+    rc &= PLASMA_TEST_COND(s->results == PLASMA_PARKINGLOT_T_PARKERS);
+    rc &= PLASMA_TEST_COND(s->cb_calls == 2);
+    rc &= PLASMA_TEST_COND(s->cb_did_unpark == 1);
+    rc &= PLASMA_TEST_COND(s->cb_may_have_more == 1);
+    return rc;
+}
+
+/* Threads repeatedly park with short timeouts while thread 0 repeatedly
+ * calls unpark_all; timeouts race with unpark_all detaching nodes.
+ * Every park must return exactly once, either unparked or timed out, and
+ * the number unparked must equal the total reported by unpark_all */
+static struct plasma_parkinglot_t_race {
+    uint32_t addr;
+    uint32_t done;
+    uint32_t running;
+    uint32_t unparked;
+    uint32_t timeouts;
+    uint32_t other;
+    uint64_t unpark_all_total;
+    uint32_t nparkers;
+    uint32_t iters;
+} plasma_parkinglot_t_race;
+
+static void *
+plasma_parkinglot_t_race_thread (void * const thr_arg)
+{
+    struct plasma_parkinglot_t_race * const restrict s =
+      &plasma_parkinglot_t_race;
+    uint32_t i, unparked = 0, timeouts = 0, other = 0;
+    if (thr_arg != NULL) {
+        uint64_t total = 0;
+        while (plasma_atomic_load_explicit(&s->running, memory_order_acquire))
+        {
+            total += plasma_parkinglot_unpark_all(&s->addr);
+            plasma_spin_yield();
+        }
+        s->unpark_all_total = total;
+        return NULL;
+    }
+    for (i = 0; i < s->iters; ++i) {
+        switch (plasma_parkinglot_park(&s->addr, NULL, NULL,
+                                       (uint64_t)(i & 7) * 10000)) {
+          case PLASMA_PARKINGLOT_UNPARKED: ++unparked; break;
+          case PLASMA_PARKINGLOT_TIMEOUT:  ++timeouts; break;
+          default:                         ++other;    break;
+        }
+    }
+    plasma_atomic_fetch_add_u32(&s->unparked, unparked, memory_order_relaxed);
+    plasma_atomic_fetch_add_u32(&s->timeouts, timeouts, memory_order_relaxed);
+    plasma_atomic_fetch_add_u32(&s->other, other, memory_order_relaxed);
+    if (plasma_atomic_fetch_add_u32(&s->done, 1, memory_order_acq_rel) + 1
+        == s->nparkers)
+        plasma_atomic_store_explicit(&s->running, 0, memory_order_release);
+    return NULL;
+}
+
+static int
+plasma_parkinglot_t_race_run (const int nthreads, const int iters)
+{
+    struct plasma_parkinglot_t_race * const restrict s =
+      &plasma_parkinglot_t_race;
+    void **args;
+    int i, n = nthreads < 2 ? 3 : nthreads + 1;
+    int rc = true;
+    memset(s, 0, sizeof(*s));
+    s->iters = (uint32_t)iters;
+    s->nparkers = (uint32_t)(n - 1);
+    s->running = 1;
+    args = plasma_test_calloc((size_t)n, sizeof(void *));
+    args[0] = (void *)s;  /*(thread 0 calls unpark_all)*/
+    for (i = 1; i < n; ++i)
+        args[i] = NULL;
+    plasma_test_nthreads(n, plasma_parkinglot_t_race_thread, args, NULL);
+    plasma_test_free(args);
+    rc &= PLASMA_TEST_COND(s->other == 0);
+    rc &= PLASMA_TEST_COND(s->unparked + s->timeouts
+                           == s->iters * s->nparkers);
+    rc &= PLASMA_TEST_COND(s->unparked == s->unpark_all_total);
+    rc &= PLASMA_TEST_COND(plasma_parkinglot_unpark_all(&s->addr) == 0);
+    return rc;
+}
+
+/* plasma_parklock: counter protected by plasma_parklock (two bits of a word
+ * whose other bits are preserved) */
+static struct plasma_parkinglot_t_lockshared {
+    uint32_t word;
+    uint32_t counter;
+    uint32_t iters;
+} plasma_parkinglot_t_lockshared;
+
+#define PLASMA_PARKINGLOT_T_UDATA 0xABCD0000u
+
+static void *
+plasma_parkinglot_t_parklock_thread (void * const thr_arg)
+{
+    struct plasma_parkinglot_t_lockshared * const restrict s =
+      &plasma_parkinglot_t_lockshared;
+    uint32_t i;
+    (void)thr_arg;
+    for (i = 0; i < s->iters; ++i) {
+        plasma_parklock_acquire(&s->word);
+        ++s->counter;
+        if ((i & 0x3ff) == 0)
+            plasma_spin_yield(); /*(encourage contention and parking)*/
+        plasma_parklock_release(&s->word);
+    }
+    return NULL;
+}
+
+static int
+plasma_parkinglot_t_parklock (const int nthreads, const int iters)
+{
+    struct plasma_parkinglot_t_lockshared * const restrict s =
+      &plasma_parkinglot_t_lockshared;
+    const int n = nthreads < 2 ? 2 : nthreads;
+    int rc = true;
+    s->word = PLASMA_PARKINGLOT_T_UDATA;
+    s->counter = 0;
+    s->iters = (uint32_t)iters;
+    rc &= PLASMA_TEST_COND(plasma_parklock_is_free(&s->word));
+    rc &= PLASMA_TEST_COND(plasma_parklock_acquire_try(&s->word));
+    rc &= PLASMA_TEST_COND(!plasma_parklock_acquire_try(&s->word));
+    rc &= PLASMA_TEST_COND(!plasma_parklock_is_free(&s->word));
+    plasma_parklock_release(&s->word);
+    rc &= PLASMA_TEST_COND(s->word == PLASMA_PARKINGLOT_T_UDATA);
+
+    plasma_test_nthreads(n, plasma_parkinglot_t_parklock_thread, NULL, NULL);
+    rc &= PLASMA_TEST_COND(s->counter == s->iters * (uint32_t)n);
+    rc &= PLASMA_TEST_COND(s->word == PLASMA_PARKINGLOT_T_UDATA);
+    rc &= PLASMA_TEST_COND(plasma_parkinglot_unpark_all(&s->word) == 0);
+    return rc;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int rc = true;
+    long nprocs = plasma_sysconf_nprocessors_onln();
+    int iters;
+    if (nprocs < 1)
+        nprocs = 1;
+    if (nprocs > 32)
+        nprocs = 32;  /*(place upper bound on num threads created in tests)*/
+    if (argc > 1 && atoi(argv[1]) > 0)
+        nprocs = atoi(argv[1]);
+    iters = (argc > 2 && atoi(argv[2]) > 0) ? atoi(argv[2]) : 100000;
+    alarm(120);
+
+    rc &= plasma_parkinglot_t_basic();
+    rc &= plasma_parkinglot_t_unpark();
+    rc &= plasma_parkinglot_t_race_run((int)nprocs, iters / 100 + 1);
+    rc &= plasma_parkinglot_t_parklock((int)nprocs, iters);
+    return !rc;
+}
@@ -0,0 +1,294 @@
+/*
+ * plasma_sem.t.c - plasma_sem.[ch] tests
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ *   $ make libplasma.a
+ *   $ gcc -std=c11 -D_XOPEN_SOURCE=700 -O3 -pthread \
+ *       t/plasma_sem.t.c libplasma.a -o plasma_sem.t
+ *   $ ./plasma_sem.t [nthreads] [iterations]
+ *
+ * On Linux, tests confirm that waiters are parked in the kernel (thread state
+ * 'S' in /proc) before plasma_sem_post() or plasma_latch_count_down(), so that
+ * counts of waiters released are checked against parked (not spinning)
+ * waiters.  Elsewhere, tests pause to let waiters park.
+ */
+
+#ifndef _XOPEN_SOURCE
+#define _XOPEN_SOURCE 600
+#endif
+
+#include "../plasma_atomic.h"
+#include "../plasma_attr.h"
+#include "../plasma_futex.h"
+#include "../plasma_membar.h"
+#include "../plasma_sem.h"
+#include "../plasma_spin.h"
+#include "../plasma_stdtypes.h"
+#include "../plasma_sysconf.h"
+#include "../plasma_test.h"
+
+#ifdef PLASMA_FEATURE_POSIX
+#include <unistd.h>  /* alarm() */
+#endif
+#include <stdlib.h>
+#include <string.h>  /* memset() */
+
+/* single thread: trywait consumes available units and fails at zero;
+ * post without waiters only adds units (no wakeup tokens) */
+static int
+plasma_sem_t_trywait (void)
+{
+    plasma_sem_t sem = PLASMA_SEM_INITIALIZER(2);
+    plasma_latch_t latch = PLASMA_LATCH_INITIALIZER(2);
+    int rc = true;
+    rc &= PLASMA_TEST_COND(plasma_sem_trywait(&sem));
+    rc &= PLASMA_TEST_COND(plasma_sem_trywait(&sem));
+    rc &= PLASMA_TEST_COND(!plasma_sem_trywait(&sem));
+    rc &= PLASMA_TEST_COND(sem.count == 0);
+    plasma_sem_post(&sem, 3);
+    rc &= PLASMA_TEST_COND(sem.count == 3 && sem.tokens == 0);
+    plasma_sem_wait(&sem);  /*(does not block)*/
+    rc &= PLASMA_TEST_COND(plasma_sem_trywait(&sem));
+    rc &= PLASMA_TEST_COND(plasma_sem_trywait(&sem));
+    rc &= PLASMA_TEST_COND(!plasma_sem_trywait(&sem));
+    rc &= PLASMA_TEST_COND(sem.count == 0 && sem.tokens == 0);
+
+    rc &= PLASMA_TEST_COND(!plasma_latch_try_wait(&latch));
+    plasma_latch_count_down(&latch, 1);
+    rc &= PLASMA_TEST_COND(!plasma_latch_try_wait(&latch));
+    plasma_latch_arrive_and_wait(&latch, 1);  /*(does not block)*/
+    rc &= PLASMA_TEST_COND(plasma_latch_try_wait(&latch));
+    rc &= PLASMA_TEST_COND(latch.waiters == 0);
+    return rc;
+}
+
+/* Waiters each block once (in plasma_sem_wait() or plasma_latch_wait()),
+ * count themselves released, and then wait on release (so that they never
+ * again block on sem or latch).  Thread 0 is the coordinator, which posts or
+ * counts down in steps and records the number of waiters released after each
+ * step, once all waiters are again blocked */
+#define PLASMA_SEM_T_WAITERS 6
+
+static struct plasma_sem_t_waiters {
+    plasma_sem_t sem;
+    plasma_latch_t latch;
+    uint32_t release;
+    uint32_t arrived;
+    uint32_t woken;
+    uint32_t after_post2;
+    int32_t  count_post2;
+    uint32_t tokens_post2;
+    uint32_t after_post_all;
+    int32_t  count_post_all;
+    uint32_t tokens_post_all;
+    uint32_t after_count_down1;
+    uint32_t after_count_down2;
+    bool use_latch;  /* mode: latch (else sem) */
+    long tids[PLASMA_SEM_T_WAITERS+1];
+} plasma_sem_t_waiters;
+
+/* wait until all waiters are blocked in kernel and then return count of
+ * waiters released (waiters which are released block only on release) */
+static uint32_t
+plasma_sem_t_all_blocked (void)
+{
+    struct plasma_sem_t_waiters * const restrict s = &plasma_sem_t_waiters;
+    (void)plasma_test_wait_blocked(s->tids+1, PLASMA_SEM_T_WAITERS);
+    return plasma_atomic_load_explicit(&s->woken, memory_order_seq_cst);
+}
+
+static void
+plasma_sem_t_coordinator (void)
+{
+    struct plasma_sem_t_waiters * const restrict s = &plasma_sem_t_waiters;
+    while (plasma_atomic_load_explicit(&s->arrived, memory_order_seq_cst)
+           != PLASMA_SEM_T_WAITERS)
+        plasma_spin_yield();
+    if (!s->use_latch) {
+        /* (all waiters decremented count before parking) */
+        while ((int32_t)plasma_atomic_load_explicit(&s->sem.count,
+                                                    memory_order_seq_cst)
+               != -PLASMA_SEM_T_WAITERS)
+            plasma_spin_yield();
+        (void)plasma_sem_t_all_blocked();
+        plasma_sem_post(&s->sem, 2);
+        plasma_test_await_count(&s->woken, 2);
+        s->after_post2 = plasma_sem_t_all_blocked();
+        s->count_post2 = (int32_t)s->sem.count;
+        s->tokens_post2 = s->sem.tokens;
+        /* post more units than there are waiters; excess units remain */
+        plasma_sem_post(&s->sem, PLASMA_SEM_T_WAITERS);
+        plasma_test_await_count(&s->woken, PLASMA_SEM_T_WAITERS);
+        s->after_post_all = plasma_sem_t_all_blocked();
+        s->count_post_all = (int32_t)s->sem.count;
+        s->tokens_post_all = s->sem.tokens;
+    }
+    else {
+        (void)plasma_sem_t_all_blocked();
+        plasma_latch_count_down(&s->latch, 1);
+        s->after_count_down1 = plasma_sem_t_all_blocked();
+        plasma_latch_count_down(&s->latch, 1);
+        plasma_test_await_count(&s->woken, PLASMA_SEM_T_WAITERS);
+        s->after_count_down2 = plasma_sem_t_all_blocked();
+    }
+    plasma_atomic_store_explicit(&s->release, 1, memory_order_release);
+    plasma_futex_wake_all(&s->release);
+}
+
+static void *
+plasma_sem_t_waiter (void * const thr_arg)
+{
+    struct plasma_sem_t_waiters * const restrict s = &plasma_sem_t_waiters;
+    const int id = (int)(uintptr_t)thr_arg;
+    if (id == 0) {
+        plasma_sem_t_coordinator();
+        return NULL;
+    }
+    s->tids[id] = plasma_test_thread_id();
+    plasma_atomic_fetch_add_u32(&s->arrived, 1, memory_order_seq_cst);
+    if (!s->use_latch)
+        plasma_sem_wait(&s->sem);
+    else
+        plasma_latch_wait(&s->latch);
+    plasma_atomic_fetch_add_u32(&s->woken, 1, memory_order_seq_cst);
+    while (!plasma_atomic_load_explicit(&s->release, memory_order_acquire))
+        plasma_futex_wait(&s->release, 0, PLASMA_FUTEX_INFINITE);
+    return NULL;
+}
+
+static void
+plasma_sem_t_waiters_run (const bool latch)
+{
+    struct plasma_sem_t_waiters * const restrict s = &plasma_sem_t_waiters;
+    void *args[PLASMA_SEM_T_WAITERS+1];
+    int i;
+    memset(s, 0, sizeof(*s));
+    plasma_sem_init(&s->sem, 0);
+    plasma_latch_init(&s->latch, 2);
+    s->use_latch = latch;
+    for (i = 0; i <= PLASMA_SEM_T_WAITERS; ++i)
+        args[i] = (void *)(uintptr_t)i;
+    plasma_test_nthreads(PLASMA_SEM_T_WAITERS+1, plasma_sem_t_waiter,
+                         args, NULL);
+}
+
+/* post(n) releases exactly min(n, waiters) parked waiters */
+static int
+plasma_sem_t_post_n (void)
+{
+    struct plasma_sem_t_waiters * const restrict s = &plasma_sem_t_waiters;
+    int rc = true;
+    plasma_sem_t_waiters_run(false);
+    rc &= PLASMA_TEST_COND(s->after_post2 == 2);
+    rc &= PLASMA_TEST_COND(s->count_post2 == 2 - PLASMA_SEM_T_WAITERS);
+    rc &= PLASMA_TEST_COND(s->tokens_post2 == 0);
+    rc &= PLASMA_TEST_COND(s->after_post_all == PLASMA_SEM_T_WAITERS);
+    rc &= PLASMA_TEST_COND(s->count_post_all == 2);
+    rc &= PLASMA_TEST_COND(s->tokens_post_all == 0);
+    rc &= PLASMA_TEST_COND(plasma_sem_trywait(&s->sem));
+    rc &= PLASMA_TEST_COND(plasma_sem_trywait(&s->sem));
+    rc &= PLASMA_TEST_COND(!plasma_sem_trywait(&s->sem));
+    return rc;
+}
+
+/* latch releases no waiter until count reaches zero, and then all waiters */
+static int
+plasma_sem_t_latch (void)
+{
+    struct plasma_sem_t_waiters * const restrict s = &plasma_sem_t_waiters;
+    int rc = true;
+    plasma_sem_t_waiters_run(true);
+    rc &= PLASMA_TEST_COND(s->after_count_down1 == 0);
+    rc &= PLASMA_TEST_COND(s->after_count_down2 == PLASMA_SEM_T_WAITERS);
+    rc &= PLASMA_TEST_COND(plasma_latch_try_wait(&s->latch));
+    rc &= PLASMA_TEST_COND(s->latch.waiters != 0);  /*(waiters had parked)*/
+    return rc;
+}
+
+/* semaphore with 2 units admits at most 2 threads at a time */
+static struct plasma_sem_t_limit {
+    plasma_sem_t sem;
+    uint32_t inside;
+    uint32_t max_inside;
+    uint32_t iters;
+} plasma_sem_t_limit;
+
+static void *
+plasma_sem_t_limit_thread (void * const thr_arg)
+{
+    struct plasma_sem_t_limit * const restrict s = &plasma_sem_t_limit;
+    uint32_t i, n, max = 0;
+    (void)thr_arg;
+    plasma_test_barrier_wait();
+    for (i = 0; i < s->iters; ++i) {
+        plasma_sem_wait(&s->sem);
+        n = plasma_atomic_fetch_add_u32(&s->inside, 1, memory_order_relaxed)+1;
+        if (max < n)
+            max = n;
+        if ((i & 0xF) == 0)
+            plasma_spin_yield();  /*(let other threads contend while inside)*/
+        plasma_atomic_fetch_sub_u32(&s->inside, 1, memory_order_relaxed);
+        plasma_sem_post(&s->sem, 1);
+    }
+    for (n = s->max_inside; n < max; n = s->max_inside)
+        if (plasma_atomic_CAS_32(&s->max_inside, n, max))
+            break;
+    return NULL;
+}
+
+static int
+plasma_sem_t_limit_run (const int nthreads, const int iters)
+{
+    struct plasma_sem_t_limit * const restrict s = &plasma_sem_t_limit;
+    int rc = true;
+    plasma_sem_init(&s->sem, 2);
+    s->inside = 0;
+    s->max_inside = 0;
+    s->iters = (uint32_t)iters;
+    plasma_test_nthreads(nthreads < 3 ? 3 : nthreads,
+                         plasma_sem_t_limit_thread, NULL, NULL);
+    rc &= PLASMA_TEST_COND(s->max_inside >= 1 && s->max_inside <= 2);
+    rc &= PLASMA_TEST_COND(s->inside == 0);
+    rc &= PLASMA_TEST_COND(s->sem.count == 2 && s->sem.tokens == 0);
+    return rc;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int rc = true;
+    long nprocs = plasma_sysconf_nprocessors_onln();
+    int iters;
+    if (nprocs < 1)
+        nprocs = 1;
+    if (nprocs > 32)
+        nprocs = 32;  /*(place upper bound on num threads created in tests)*/
+    if (argc > 1 && atoi(argv[1]) > 0)
+        nprocs = atoi(argv[1]);
+    iters = (argc > 2 && atoi(argv[2]) > 0) ? atoi(argv[2]) : 10000;
+    alarm(120);
+
+    rc &= plasma_sem_t_trywait();
+    rc &= plasma_sem_t_post_n();
+    rc &= plasma_sem_t_latch();
+    rc &= plasma_sem_t_limit_run((int)nprocs, iters);
+    return !rc;
+}
@@ -0,0 +1,206 @@
+/*
+ * plasma_seqlock.t.c - plasma_seqlock.[ch] tests
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * One writer repeatedly stores a multi-word payload (every word set to the
+ * same generation number, one word at a time) while readers snapshot the
+ * payload with plasma_seqlock_read_begin() and plasma_seqlock_read_retry().
+ * A snapshot accepted by read_retry() must never be torn (words from
+ * different generations), and generations accepted by a reader must never
+ * go backwards.
+ *
+ *   $ make libplasma.a
+ *   $ gcc -std=c11 -D_XOPEN_SOURCE=700 -O3 -pthread \
+ *       t/plasma_seqlock.t.c libplasma.a -o plasma_seqlock.t
+ *   $ ./plasma_seqlock.t [nthreads] [iterations]
+ */
+
+#ifndef _XOPEN_SOURCE
+#define _XOPEN_SOURCE 600
+#endif
+
+#include "../plasma_atomic.h"
+#include "../plasma_attr.h"
+#include "../plasma_membar.h"
+#include "../plasma_seqlock.h"
+#include "../plasma_spin.h"
+#include "../plasma_stdtypes.h"
+#include "../plasma_sysconf.h"
+#include "../plasma_test.h"
+
+#ifdef PLASMA_FEATURE_POSIX
+#include <unistd.h>  /* alarm() */
+#endif
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define PLASMA_SEQLOCK_T_WORDS 8
+
+static plasma_seqlock_t plasma_seqlock_t_sl = PLASMA_SEQLOCK_INITIALIZER;
+static uint64_t plasma_seqlock_t_payload[PLASMA_SEQLOCK_T_WORDS];
+static uint32_t plasma_seqlock_t_readers;
+static uint64_t plasma_seqlock_t_gen;
+
+struct plasma_seqlock_t_reader {
+    uint64_t reads;
+    uint64_t accepted;
+    uint64_t retries;
+    uint64_t torn;
+    uint64_t regressed;
+    uint64_t last;
+};
+
+/* writer stores new generations until all readers have finished */
+static void
+plasma_seqlock_t_writer (void)
+{
+    uint64_t gen = 0;
+    int i;
+    while (plasma_atomic_load_explicit(&plasma_seqlock_t_readers,
+                                       memory_order_acquire)) {
+        ++gen;
+        plasma_seqlock_write_begin(&plasma_seqlock_t_sl);
+        for (i = 0; i < PLASMA_SEQLOCK_T_WORDS; ++i) {
+            plasma_atomic_store_explicit(&plasma_seqlock_t_payload[i], gen,
+                                         memory_order_relaxed);
+            if ((gen & 0x3FF) == 0 && i == PLASMA_SEQLOCK_T_WORDS/2)
+                plasma_spin_yield(); /*(widen window for readers mid-write)*/
+        }
+        plasma_seqlock_write_end(&plasma_seqlock_t_sl);
+        /* (readers spin while write in progress; keep writer from hogging
+         *  CPU and starving readers when threads outnumber CPUs) */
+        plasma_spin_yield();
+    }
+    plasma_seqlock_t_gen = gen;
+}
+
+static void
+plasma_seqlock_t_read (struct plasma_seqlock_t_reader * const restrict r)
+{
+    uint64_t snap[PLASMA_SEQLOCK_T_WORDS];
+    uint32_t seq;
+    int i, torn;
+    for (;;) {
+        seq = plasma_seqlock_read_begin(&plasma_seqlock_t_sl);
+        for (i = 0; i < PLASMA_SEQLOCK_T_WORDS; ++i)
+            snap[i] = plasma_atomic_load_explicit(&plasma_seqlock_t_payload[i],
+                                                  memory_order_relaxed);
+        if (!plasma_seqlock_read_retry(&plasma_seqlock_t_sl, seq))
+            break;
+        ++r->retries;
+    }
+
+    for (i = 1, torn = 0; i < PLASMA_SEQLOCK_T_WORDS; ++i)
+        torn |= (snap[i] != snap[0]);
+    r->torn += (uint64_t)torn;
+    r->regressed += (snap[0] < r->last);
+    r->last = snap[0];
+    ++r->accepted;
+}
+
+static void *
+plasma_seqlock_t_thread (void * const thr_arg)
+{
+    struct plasma_seqlock_t_reader * const restrict r = thr_arg;
+    plasma_test_barrier_wait();
+    if (r == NULL) {
+        plasma_seqlock_t_writer();
+        return NULL;
+    }
+    while (plasma_atomic_load_explicit(&plasma_seqlock_t_sl.seq,
+                                       memory_order_relaxed) == 0)
+        plasma_spin_yield();    /* wait for writer to start */
+    while (r->accepted < r->reads) {
+        plasma_seqlock_t_read(r);
+        if ((r->accepted & 0xF) == 0)
+            plasma_spin_yield();/*(interleave with writer on few-CPU systems)*/
+    }
+    plasma_atomic_fetch_sub_u32(&plasma_seqlock_t_readers, 1,
+                                memory_order_release);
+    return NULL;
+}
+
+static int
+plasma_seqlock_t_torn_reads (const int nreaders, const int iters)
+{
+    struct plasma_seqlock_t_reader * const rd =
+      plasma_test_calloc((size_t)nreaders, sizeof(*rd));
+    void ** const args = plasma_test_calloc((size_t)nreaders+1, sizeof(void*));
+    uint64_t accepted = 0, retries = 0;
+    int i, rc = true;
+    if (rd == NULL || args == NULL)
+        PLASMA_TEST_PERROR_ABORT("plasma_test_calloc", errno);
+    for (i = 0; i < nreaders; ++i) {
+        rd[i].reads = (uint64_t)iters;
+        args[i+1] = &rd[i];      /* args[0] == NULL is writer */
+    }
+
+    plasma_seqlock_init(&plasma_seqlock_t_sl);
+    for (i = 0; i < PLASMA_SEQLOCK_T_WORDS; ++i)
+        plasma_seqlock_t_payload[i] = 0;
+    plasma_seqlock_t_readers = (uint32_t)nreaders;
+    plasma_seqlock_t_gen = 0;
+    plasma_test_nthreads(nreaders+1, plasma_seqlock_t_thread, args, NULL);
+
+    for (i = 0; i < nreaders; ++i) {
+        rc &= PLASMA_TEST_COND_IDX(rd[i].torn == 0, i);
+        rc &= PLASMA_TEST_COND_IDX(rd[i].regressed == 0, i);
+        rc &= PLASMA_TEST_COND_IDX(rd[i].accepted == (uint64_t)iters, i);
+        rc &= PLASMA_TEST_COND_IDX(rd[i].last <= plasma_seqlock_t_gen, i);
+        accepted += rd[i].accepted;
+        retries  += rd[i].retries;
+    }
+    rc &= PLASMA_TEST_COND(plasma_seqlock_t_sl.seq
+                           == 2u * (uint32_t)plasma_seqlock_t_gen);
+    for (i = 0; i < PLASMA_SEQLOCK_T_WORDS; ++i)
+        rc &= PLASMA_TEST_COND_IDX(
+                plasma_seqlock_t_payload[i] == plasma_seqlock_t_gen, i);
+    rc &= PLASMA_TEST_COND(plasma_seqlock_t_sl.wrlock.lck == 0);
+    fprintf(stderr, "plasma_seqlock %d readers: %llu reads accepted, "
+                    "%llu retried; %llu writes\n",
+            nreaders, (unsigned long long)accepted,
+            (unsigned long long)retries,
+            (unsigned long long)plasma_seqlock_t_gen);
+
+    plasma_test_free(args);
+    plasma_test_free(rd);
+    return rc;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int rc = true;
+    long nprocs = plasma_sysconf_nprocessors_onln();
+    int iters;
+    if (nprocs < 1)
+        nprocs = 1;
+    if (nprocs > 32)
+        nprocs = 32;  /*(place upper bound on num threads created in tests)*/
+    if (argc > 1 && atoi(argv[1]) > 0)
+        nprocs = atoi(argv[1]);
+    iters = (argc > 2 && atoi(argv[2]) > 0) ? atoi(argv[2]) : 100000;
+    alarm(120);
+
+    rc &= plasma_seqlock_t_torn_reads((int)nprocs, iters);
+    return !rc;
+}
@@ -0,0 +1,1008 @@
+/*
+ * plasma_spin.t.c - plasma_spin.[ch] tests
+ *
+ * Copyright (c) 2013, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Exercise plasma_spin locks with multiple threads contending for each lock,
+ * verifying mutual exclusion and reporting elapsed time for each lock type
+ * (elapsed times are a coarse benchmark for choosing between lock types)
+ *
+ *   $ make libplasma.a
+ *   $ gcc -std=c11 -D_XOPEN_SOURCE=700 -O3 -pthread \
+ *       t/plasma_spin.t.c libplasma.a -o plasma_spin.t
+ *   $ ./plasma_spin.t [nthreads] [iterations]
+ */
+
+#ifndef _XOPEN_SOURCE
+#define _XOPEN_SOURCE 600
+#endif
+
+#include "../plasma_atomic.h"
+#include "../plasma_attr.h"
+#include "../plasma_membar.h"
+#include "../plasma_spin.h"
+#include "../plasma_stdtypes.h"
+#include "../plasma_sysconf.h"
+#include "../plasma_test.h"
+
+#ifdef PLASMA_FEATURE_POSIX
+#include <unistd.h>  /* alarm() */
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>  /* memset() */
+#include <time.h>    /* clock_gettime() */
+
+enum plasma_spin_t_locktype {
+    PLASMA_SPIN_T_LOCK = 0,
+    PLASMA_SPIN_T_LOCK_ADAPTIVE,
+    PLASMA_SPIN_T_TKTLOCK,
+    PLASMA_SPIN_T_TKTLOCK_BACKOFF,
+    PLASMA_SPIN_T_TKTLOCK64,
+    PLASMA_SPIN_T_TAGLOCK,
+    PLASMA_SPIN_T_TAGLOCK_BACKOFF,
+    PLASMA_SPIN_T_TAGLOCK32,
+    PLASMA_SPIN_T_MCSLOCK,
+    PLASMA_SPIN_T_CLHLOCK,
+    PLASMA_SPIN_T_FUTEXLOCK,
+    PLASMA_SPIN_T_FUTEXLOCK_ADAPTIVE,
+    PLASMA_SPIN_T_COHORTLOCK,
+    PLASMA_SPIN_T_LOCKTYPE_MAX
+};
+
+static const char * const plasma_spin_t_locknames[] = {
+    "plasma_spin_lock",
+    "plasma_spin_lock (adaptive)",
+    "plasma_spin_tktlock",
+    "plasma_spin_tktlock (backoff)",
+    "plasma_spin_tktlock64",
+    "plasma_spin_taglock",
+    "plasma_spin_taglock (backoff)",
+    "plasma_spin_taglock32",
+    "plasma_spin_mcslock",
+    "plasma_spin_clhlock",
+    "plasma_spin_futexlock",
+    "plasma_spin_futexlock (adaptive)",
+    "plasma_spin_cohortlock"
+};
+
+/* locks and protected counter each in separate cache lines (false sharing) */
+static struct plasma_spin_t_shared {
+    plasma_spin_lock_t    spin;    char pad0[128-sizeof(plasma_spin_lock_t)];
+    plasma_spin_lock_t    spin_ad; char pad0a[128-sizeof(plasma_spin_lock_t)];
+    plasma_spin_tktlock_t tktlock; char pad1[128-sizeof(plasma_spin_tktlock_t)];
+    plasma_spin_taglock_t taglock; char pad2[128-sizeof(plasma_spin_taglock_t)];
+    plasma_spin_tktlock_t tktlock_bo;
+                           char pad1b[128-sizeof(plasma_spin_tktlock_t)];
+    plasma_spin_tktlock64_t tktlock64;
+                           char pad1c[128-sizeof(plasma_spin_tktlock64_t)];
+    plasma_spin_taglock_t taglock_bo;
+                           char pad2b[128-sizeof(plasma_spin_taglock_t)];
+    plasma_spin_taglock32_t taglock32;
+                           char pad2c[128-sizeof(plasma_spin_taglock32_t)];
+    plasma_spin_mcslock_t mcslock; char pad3[128-sizeof(plasma_spin_mcslock_t)];
+    plasma_spin_clhlock_t clhlock; char pad4[128-sizeof(plasma_spin_clhlock_t)];
+    plasma_spin_futexlock_t futexlock;
+                           char pad5[128-sizeof(plasma_spin_futexlock_t)];
+    plasma_spin_futexlock_t futexlock_ad;
+                           char pad5a[128-sizeof(plasma_spin_futexlock_t)];
+    plasma_spin_cohortlock_t cohortlock;
+    uint64_t counter;              char pad6[128-sizeof(uint64_t)];
+} plasma_spin_t_shared;
+
+typedef struct plasma_spin_t_thr_arg {
+    enum plasma_spin_t_locktype locktype;
+    int iters;
+    int status;
+    int id;
+    int acquired;
+} plasma_spin_t_thr_arg;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+__attribute_noinline__
+static void *
+plasma_spin_t_nthreads_lock (void * const thr_arg)
+{
+    plasma_spin_t_thr_arg * const restrict d =
+      (plasma_spin_t_thr_arg *)thr_arg;
+    struct plasma_spin_t_shared * const restrict s = &plasma_spin_t_shared;
+    plasma_spin_mcslock_node_t mcsnode;
+    const int iters = d->iters;
+    int i, rc = true;
+    uint64_t c;
+    plasma_test_barrier_wait();
+    switch (d->locktype) {
+      case PLASMA_SPIN_T_LOCK:
+        for (i = 0; i < iters; ++i) {
+            (void)plasma_spin_lock_acquire(&s->spin);
+            c = s->counter;
+            s->counter = c + 1;
+            plasma_spin_lock_release(&s->spin);
+        }
+        break;
+      case PLASMA_SPIN_T_LOCK_ADAPTIVE:
+        for (i = 0; i < iters; ++i) {
+            (void)plasma_spin_lock_acquire_adaptive(&s->spin_ad);
+            c = s->counter;
+            s->counter = c + 1;
+            plasma_spin_lock_release(&s->spin_ad);
+        }
+        break;
+      case PLASMA_SPIN_T_TKTLOCK:
+        for (i = 0; i < iters; ++i) {
+            plasma_spin_tktlock_acquire(&s->tktlock);
+            c = s->counter;
+            s->counter = c + 1;
+            plasma_spin_tktlock_release(&s->tktlock);
+        }
+        break;
+      case PLASMA_SPIN_T_TKTLOCK_BACKOFF:
+        for (i = 0; i < iters; ++i) {
+            plasma_spin_tktlock_acquire_backoff(&s->tktlock_bo);
+            c = s->counter;
+            s->counter = c + 1;
+            plasma_spin_tktlock_release(&s->tktlock_bo);
+        }
+        break;
+      case PLASMA_SPIN_T_TKTLOCK64:
+        for (i = 0; i < iters; ++i) {
+            plasma_spin_tktlock64_acquire(&s->tktlock64);
+            c = s->counter;
+            s->counter = c + 1;
+            plasma_spin_tktlock64_release(&s->tktlock64);
+        }
+        break;
+      case PLASMA_SPIN_T_TAGLOCK:
+        for (i = 0; i < iters; ++i) {
+            plasma_spin_taglock_acquire(&s->taglock);
+            c = s->counter;
+            s->counter = c + 1;
+            plasma_spin_taglock_release(&s->taglock);
+        }
+        break;
+      case PLASMA_SPIN_T_TAGLOCK_BACKOFF:
+        for (i = 0; i < iters; ++i) {
+            plasma_spin_taglock_acquire_backoff(&s->taglock_bo);
+            c = s->counter;
+            s->counter = c + 1;
+            plasma_spin_taglock_release(&s->taglock_bo);
+        }
+        break;
+      case PLASMA_SPIN_T_TAGLOCK32:
+        for (i = 0; i < iters; ++i) {
+            if ((i & 15) == 0)  /* mix in urgent acquire (jumps queue) */
+                plasma_spin_taglock32_acquire_urgent(&s->taglock32);
+            else
+                plasma_spin_taglock32_acquire(&s->taglock32);
+            c = s->counter;
+            s->counter = c + 1;
+            plasma_spin_taglock32_release(&s->taglock32);
+        }
+        break;
+      case PLASMA_SPIN_T_MCSLOCK:
+        for (i = 0; i < iters; ++i) {
+            plasma_spin_mcslock_acquire(&s->mcslock, &mcsnode);
+            c = s->counter;
+            s->counter = c + 1;
+            plasma_spin_mcslock_release(&s->mcslock, &mcsnode);
+        }
+        break;
+      case PLASMA_SPIN_T_CLHLOCK:
+        for (i = 0; i < iters && rc; ++i) {
+            rc &= PLASMA_TEST_COND(plasma_spin_clhlock_acquire(&s->clhlock));
+            c = s->counter;
+            s->counter = c + 1;
+            plasma_spin_clhlock_release(&s->clhlock);
+        }
+        break;
+      case PLASMA_SPIN_T_FUTEXLOCK:
+        for (i = 0; i < iters; ++i) {
+            plasma_spin_futexlock_acquire(&s->futexlock);
+            c = s->counter;
+            s->counter = c + 1;
+            plasma_spin_futexlock_release(&s->futexlock);
+        }
+        break;
+      case PLASMA_SPIN_T_FUTEXLOCK_ADAPTIVE:
+        for (i = 0; i < iters; ++i) {
+            plasma_spin_futexlock_acquire_adaptive(&s->futexlock_ad);
+            c = s->counter;
+            s->counter = c + 1;
+            plasma_spin_futexlock_release(&s->futexlock_ad);
+        }
+        break;
+      case PLASMA_SPIN_T_COHORTLOCK:
+        for (i = 0; i < iters; ++i) {
+            plasma_spin_cohortlock_acquire(&s->cohortlock);
+            c = s->counter;
+            s->counter = c + 1;
+            plasma_spin_cohortlock_release(&s->cohortlock);
+        }
+        break;
+      default:
+        rc &= PLASMA_TEST_COND(d->locktype < PLASMA_SPIN_T_LOCKTYPE_MAX);
+        break;
+    }
+    d->status = rc;
+    return NULL;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+static double
+plasma_spin_t_elapsed (const struct timespec * const restrict b,
+                       const struct timespec * const restrict e)
+{
+    return (double)(e->tv_sec - b->tv_sec)
+         + (double)(e->tv_nsec - b->tv_nsec) / 1000000000.0;
+}
+
+__attribute_noinline__
+static int
+plasma_spin_t_nthreads (const int nthreads, const int iters)
+{
+    plasma_spin_t_thr_arg * const thr_structs =
+      plasma_test_malloc(nthreads * sizeof(plasma_spin_t_thr_arg));
+    void ** const restrict thr_args =
+      plasma_test_malloc(nthreads * sizeof(void *));
+    struct timespec b, e;
+    int rc = true;
+    int n, t;
+
+    if (thr_structs == NULL || thr_args == NULL)
+        PLASMA_TEST_PERROR_ABORT("plasma_test_malloc", 0);
+
+    for (n=0; n < nthreads; ++n)
+        thr_args[n] = &thr_structs[n];
+
+    plasma_spin_lock_init(&plasma_spin_t_shared.spin);
+    plasma_spin_lock_init(&plasma_spin_t_shared.spin_ad);
+    plasma_spin_tktlock_init(&plasma_spin_t_shared.tktlock);
+    plasma_spin_taglock_init(&plasma_spin_t_shared.taglock);
+    plasma_spin_tktlock_init(&plasma_spin_t_shared.tktlock_bo);
+    plasma_spin_tktlock64_init(&plasma_spin_t_shared.tktlock64);
+    /* (start tickets near 32-bit wraparound) */
+    plasma_spin_t_shared.tktlock64.lck.u = UINT64_C(0xFFFFFFF0FFFFFFF0);
+    plasma_spin_taglock_init(&plasma_spin_t_shared.taglock_bo);
+    plasma_spin_taglock32_init(&plasma_spin_t_shared.taglock32);
+    plasma_spin_mcslock_init(&plasma_spin_t_shared.mcslock);
+    plasma_spin_clhlock_init(&plasma_spin_t_shared.clhlock);
+    plasma_spin_futexlock_init(&plasma_spin_t_shared.futexlock);
+    plasma_spin_futexlock_init(&plasma_spin_t_shared.futexlock_ad);
+    plasma_spin_cohortlock_init(&plasma_spin_t_shared.cohortlock, 0);
+
+    for (t = 0; t < PLASMA_SPIN_T_LOCKTYPE_MAX; ++t) {
+        for (n=0; n < nthreads; ++n) {
+            ((plasma_spin_t_thr_arg *)thr_args[n])->locktype =
+              (enum plasma_spin_t_locktype)t;
+            ((plasma_spin_t_thr_arg *)thr_args[n])->iters    = iters;
+            ((plasma_spin_t_thr_arg *)thr_args[n])->status   = false;
+        }
+        plasma_spin_t_shared.counter = 0;
+        clock_gettime(CLOCK_MONOTONIC, &b);
+        plasma_test_nthreads(nthreads,
+                             plasma_spin_t_nthreads_lock, thr_args, NULL);
+        clock_gettime(CLOCK_MONOTONIC, &e);
+        for (n=0; n < nthreads; ++n)
+            rc &= ((plasma_spin_t_thr_arg *)thr_args[n])->status;
+        rc &= PLASMA_TEST_COND_IDX(plasma_spin_t_shared.counter
+                                   == (uint64_t)nthreads * (uint64_t)iters, t);
+        fprintf(stderr, "%-32s %3d thr x %d iters: %.6f s\n",
+                plasma_spin_t_locknames[t], nthreads, iters,
+                plasma_spin_t_elapsed(&b, &e));
+    }
+
+    rc &= PLASMA_TEST_COND(
+            plasma_spin_tktlock64_is_free(&plasma_spin_t_shared.tktlock64));
+    rc &= PLASMA_TEST_COND(
+            !plasma_spin_taglock32_is_contended(&plasma_spin_t_shared.taglock32)
+            && plasma_spin_taglock32_is_free(&plasma_spin_t_shared.taglock32));
+
+    plasma_test_free(thr_structs);
+    plasma_test_free(thr_args);
+    return rc;
+}
+
+__attribute_noinline__
+static int
+plasma_spin_t_uncontended (const int iters)
+{
+    /* uncontended acquire/release latency: tktlock vs tktlock64,
+     * and taglock (two words) vs taglock32 (single word) */
+    struct plasma_spin_t_shared * const restrict s = &plasma_spin_t_shared;
+    struct timespec b, e;
+    int i;
+    plasma_spin_tktlock_init(&s->tktlock);
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    for (i = 0; i < iters; ++i) {
+        plasma_spin_tktlock_acquire(&s->tktlock);
+        ++s->counter;
+        plasma_spin_tktlock_release(&s->tktlock);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &e);
+    fprintf(stderr, "%-32s uncontended: %.2f ns\n", "plasma_spin_tktlock",
+            plasma_spin_t_elapsed(&b, &e) * 1e9 / iters);
+    plasma_spin_tktlock64_init(&s->tktlock64);
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    for (i = 0; i < iters; ++i) {
+        plasma_spin_tktlock64_acquire(&s->tktlock64);
+        ++s->counter;
+        plasma_spin_tktlock64_release(&s->tktlock64);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &e);
+    fprintf(stderr, "%-32s uncontended: %.2f ns\n", "plasma_spin_tktlock64",
+            plasma_spin_t_elapsed(&b, &e) * 1e9 / iters);
+    plasma_spin_taglock_init(&s->taglock);
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    for (i = 0; i < iters; ++i) {
+        plasma_spin_taglock_acquire(&s->taglock);
+        ++s->counter;
+        plasma_spin_taglock_release(&s->taglock);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &e);
+    fprintf(stderr, "%-32s uncontended: %.2f ns\n", "plasma_spin_taglock",
+            plasma_spin_t_elapsed(&b, &e) * 1e9 / iters);
+    plasma_spin_taglock32_init(&s->taglock32);
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    for (i = 0; i < iters; ++i) {
+        plasma_spin_taglock32_acquire(&s->taglock32);
+        ++s->counter;
+        plasma_spin_taglock32_release(&s->taglock32);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &e);
+    fprintf(stderr, "%-32s uncontended: %.2f ns\n", "plasma_spin_taglock32",
+            plasma_spin_t_elapsed(&b, &e) * 1e9 / iters);
+    return PLASMA_TEST_COND(plasma_spin_tktlock_is_free(&s->tktlock))
+         & PLASMA_TEST_COND(plasma_spin_tktlock64_is_free(&s->tktlock64))
+         & PLASMA_TEST_COND(plasma_spin_taglock_is_free(&s->taglock))
+         & PLASMA_TEST_COND(plasma_spin_taglock32_is_free(&s->taglock32));
+}
+
+static int
+plasma_spin_t_pause_ns (void)
+{
+    /* calibrated pause cost; time-based spin approximates requested time
+     * (lower bound checked loosely; preemption may only lengthen spin) */
+    const uint64_t ns = 100000;
+    const uint32_t ps = plasma_spin_pause_cost_ps();
+    struct timespec b, e;
+    double elapsed;
+    uint32_t spins, budget, paused = 0;
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    plasma_spin_pause_ns(ns);
+    clock_gettime(CLOCK_MONOTONIC, &e);
+    elapsed = plasma_spin_t_elapsed(&b, &e) * 1e9;
+    fprintf(stderr, "%-32s cost: %.2f ns; pause_ns(%u): %.0f ns\n",
+            "plasma_spin_pause", ps / 1000.0, (unsigned)ns, elapsed);
+
+    /* spin-wait budget (no spinning on single CPU) is consumed exactly */
+    budget = (plasma_sysconf_nprocessors_onln() > 1)
+      ? plasma_spin_budget_ns(ns)
+      : 0;
+    spins = plasma_spin_wait_budget_ns(ns);
+    while (plasma_spin_wait_pause(&spins))
+        ++paused;
+    plasma_spin_wait_yield(&spins); /*(budget exhausted; yields)*/
+
+    return PLASMA_TEST_COND(ps != 0)
+         & PLASMA_TEST_COND(plasma_spin_budget_ns(0) == 1)
+         & PLASMA_TEST_COND(plasma_spin_budget_ns(UINT64_MAX) == UINT32_MAX)
+         & PLASMA_TEST_COND(elapsed >= (double)(ns / 4))
+         & PLASMA_TEST_COND(paused == budget && spins == 0);
+}
+
+/* reader-writer lock: writers modify two counters; readers expect equality */
+/* (rw test modes; rwlock modes and then brlock) */
+#define PLASMA_SPIN_T_RW_BRLOCK 2
+static const char * const plasma_spin_t_rwnames[] = {
+    "plasma_spin_rwlock (WP)",
+    "plasma_spin_rwlock (PF)",
+    "plasma_spin_brlock"
+};
+
+static struct plasma_spin_t_rwshared {
+    plasma_spin_rwlock_t rwlock;   char pad0[128-sizeof(plasma_spin_rwlock_t)];
+    plasma_spin_brlock_t brlock;   char pad1[128-sizeof(plasma_spin_brlock_t)];
+    uint64_t a;
+    uint64_t b;
+} plasma_spin_t_rwshared;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+__attribute_noinline__
+static void *
+plasma_spin_t_nthreads_rwlock (void * const thr_arg)
+{
+    plasma_spin_t_thr_arg * const restrict d =
+      (plasma_spin_t_thr_arg *)thr_arg;
+    struct plasma_spin_t_rwshared * const restrict s = &plasma_spin_t_rwshared;
+    const int iters = d->iters;
+    int i, rc = true;
+    uint32_t slot;
+    plasma_test_barrier_wait();
+    if (d->locktype == PLASMA_SPIN_T_RW_BRLOCK) {
+        for (i = 0; i < iters; ++i) {
+            if ((i & 7) == 0) {  /* 1 in 8 is writer */
+                if ((i & 15) == 0 || !plasma_spin_brlock_trywrlock(&s->brlock))
+                    plasma_spin_brlock_wrlock(&s->brlock);
+                ++s->a;
+                plasma_membar_ccfence();
+                ++s->b;
+                plasma_spin_brlock_wrunlock(&s->brlock);
+            }
+            else {
+                if ((i & 3) == 0
+                    || !plasma_spin_brlock_tryrdlock(&s->brlock, &slot))
+                    slot = plasma_spin_brlock_rdlock(&s->brlock);
+                rc &= PLASMA_TEST_COND_IDX(s->a == s->b, i);
+                plasma_spin_brlock_rdunlock(&s->brlock, slot);
+            }
+        }
+        d->status = rc;
+        return NULL;
+    }
+    for (i = 0; i < iters; ++i) {
+        if ((i & 7) == 0) {  /* 1 in 8 is writer */
+            if ((i & 15) == 0 || !plasma_spin_rwlock_trywrlock(&s->rwlock))
+                plasma_spin_rwlock_wrlock(&s->rwlock);
+            ++s->a;
+            plasma_membar_ccfence();
+            ++s->b;
+            plasma_spin_rwlock_unlock(&s->rwlock);
+        }
+        else {
+            if ((i & 3) == 0 || !plasma_spin_rwlock_tryrdlock(&s->rwlock))
+                plasma_spin_rwlock_rdlock(&s->rwlock);
+            rc &= PLASMA_TEST_COND_IDX(s->a == s->b, i);
+            plasma_spin_rwlock_unlock(&s->rwlock);
+        }
+    }
+    d->status = rc;
+    return NULL;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+__attribute_noinline__
+static int
+plasma_spin_t_nthreads_rw (const int nthreads, const int iters)
+{
+    plasma_spin_t_thr_arg * const thr_structs =
+      plasma_test_malloc(nthreads * sizeof(plasma_spin_t_thr_arg));
+    void ** const restrict thr_args =
+      plasma_test_malloc(nthreads * sizeof(void *));
+    const int modes[] = { PLASMA_SPIN_RWLOCK_WRPREF,
+                          PLASMA_SPIN_RWLOCK_PHASEFAIR,
+                          PLASMA_SPIN_T_RW_BRLOCK };
+    struct timespec b, e;
+    int rc = true;
+    int n, m;
+
+    if (thr_structs == NULL || thr_args == NULL)
+        PLASMA_TEST_PERROR_ABORT("plasma_test_malloc", 0);
+
+    for (n=0; n < nthreads; ++n)
+        thr_args[n] = &thr_structs[n];
+
+    for (m = 0; m < (int)(sizeof(modes)/sizeof(int)); ++m) {
+        if (modes[m] == PLASMA_SPIN_T_RW_BRLOCK) {
+            if (!plasma_spin_brlock_init(&plasma_spin_t_rwshared.brlock))
+                PLASMA_TEST_PERROR_ABORT("plasma_spin_brlock_init", 0);
+        }
+        else
+            plasma_spin_rwlock_init(&plasma_spin_t_rwshared.rwlock, modes[m]);
+        plasma_spin_t_rwshared.a = 0;
+        plasma_spin_t_rwshared.b = 0;
+        for (n=0; n < nthreads; ++n) {
+            ((plasma_spin_t_thr_arg *)thr_args[n])->locktype = modes[m];
+            ((plasma_spin_t_thr_arg *)thr_args[n])->iters  = iters;
+            ((plasma_spin_t_thr_arg *)thr_args[n])->status = false;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &b);
+        plasma_test_nthreads(nthreads,
+                             plasma_spin_t_nthreads_rwlock, thr_args, NULL);
+        clock_gettime(CLOCK_MONOTONIC, &e);
+        for (n=0; n < nthreads; ++n)
+            rc &= ((plasma_spin_t_thr_arg *)thr_args[n])->status;
+        rc &= PLASMA_TEST_COND_IDX(plasma_spin_t_rwshared.a
+                                   == (uint64_t)nthreads
+                                      * (uint64_t)((iters + 7) / 8), m);
+        if (modes[m] == PLASMA_SPIN_T_RW_BRLOCK)
+            plasma_spin_brlock_destroy(&plasma_spin_t_rwshared.brlock);
+        fprintf(stderr, "%-32s %3d thr x %d iters: %.6f s\n",
+                plasma_spin_t_rwnames[m],
+                nthreads, iters, plasma_spin_t_elapsed(&b, &e));
+    }
+
+    plasma_test_free(thr_structs);
+    plasma_test_free(thr_args);
+    return rc;
+}
+
+/* phase-fair rwlock regression: trywrlock which fails (readers present) takes
+ * and releases a writer ticket without a writer phase.  A reader waiting on
+ * the preceding writer phase must then still be admitted before the next
+ * writer phase; previously reader and next writer waited on each other (hang;
+ * test is killed by alarm()).  Each round: writer holds lock while reader
+ * arrives (and waits), writer unlocks, trywrlock (fails while reader waits),
+ * then wrlock, which must wait for (and not block) the waiting reader. */
+#define PLASMA_SPIN_T_RWPF_ROUNDS 256
+
+static struct plasma_spin_t_rwpfshared {
+    plasma_spin_rwlock_t rwlock;
+    uint32_t round;       /* round in which writer holds lock for reader */
+    uint32_t rdone;       /* rounds in which reader acquired (and released) */
+    uint32_t tryfails;    /* trywrlock failures (readers present) */
+} plasma_spin_t_rwpfshared;
+
+static void *
+plasma_spin_t_rwpf_reader (void * const thr_arg)
+{
+    struct plasma_spin_t_rwpfshared * const restrict s =
+      &plasma_spin_t_rwpfshared;
+    uint32_t i;
+    (void)thr_arg;
+    for (i = 1; i <= PLASMA_SPIN_T_RWPF_ROUNDS; ++i) {
+        while (plasma_atomic_load_explicit(&s->round, memory_order_acquire)
+               != i)
+            plasma_spin_yield();
+        plasma_spin_rwlock_rdlock(&s->rwlock);  /*(writer holds; reader waits)*/
+        plasma_spin_rwlock_rdunlock(&s->rwlock);
+        plasma_atomic_store_explicit(&s->rdone, i, memory_order_release);
+    }
+    return NULL;
+}
+
+static void *
+plasma_spin_t_rwpf_writer (void * const thr_arg)
+{
+    struct plasma_spin_t_rwpfshared * const restrict s =
+      &plasma_spin_t_rwpfshared;
+    plasma_spin_rwlock_t * const restrict rw = &s->rwlock;
+    uint32_t i, rin;
+    (void)thr_arg;
+    for (i = 1; i <= PLASMA_SPIN_T_RWPF_ROUNDS; ++i) {
+        plasma_spin_rwlock_wrlock(rw);
+        rin = PLASMA_SPIN_RWLOCK_RIN(
+                plasma_atomic_load_explicit(&rw->rin, memory_order_relaxed));
+        plasma_atomic_store_explicit(&s->round, i, memory_order_release);
+        /* wait for reader to arrive (and wait on this writer phase) */
+        while (PLASMA_SPIN_RWLOCK_RIN(
+                 plasma_atomic_load_explicit(&rw->rin, memory_order_relaxed))
+               == rin)
+            plasma_spin_yield();
+        plasma_spin_rwlock_wrunlock(rw);
+        if (plasma_spin_rwlock_trywrlock(rw))
+            plasma_spin_rwlock_wrunlock(rw);  /*(reader already departed)*/
+        else
+            ++s->tryfails;
+        plasma_spin_rwlock_wrlock(rw);
+        plasma_spin_rwlock_wrunlock(rw);
+        while (plasma_atomic_load_explicit(&s->rdone, memory_order_acquire)
+               != i)
+            plasma_spin_yield();
+    }
+    return NULL;
+}
+
+static void *
+plasma_spin_t_nthreads_rwpf (void * const thr_arg)
+{
+    /* (barrier returns true in exactly one thread; that thread is writer) */
+    if (plasma_test_barrier_wait())
+        return plasma_spin_t_rwpf_writer(thr_arg);
+    return plasma_spin_t_rwpf_reader(thr_arg);
+}
+
+static int
+plasma_spin_t_rwlock_pf_trywrlock (void)
+{
+    struct plasma_spin_t_rwpfshared * const restrict s =
+      &plasma_spin_t_rwpfshared;
+    plasma_spin_rwlock_init(&s->rwlock, PLASMA_SPIN_RWLOCK_PHASEFAIR);
+    s->round = 0;
+    s->rdone = 0;
+    s->tryfails = 0;
+    plasma_test_nthreads(2, plasma_spin_t_nthreads_rwpf, NULL, NULL);
+    fprintf(stderr, "%-32s %d rounds; trywrlock failed %u\n",
+            "plasma_spin_rwlock (PF trywr)", PLASMA_SPIN_T_RWPF_ROUNDS,
+            (unsigned)s->tryfails);
+    return PLASMA_TEST_COND(s->rdone == PLASMA_SPIN_T_RWPF_ROUNDS)
+         & PLASMA_TEST_COND(s->tryfails != 0)
+         & PLASMA_TEST_COND(PLASMA_SPIN_RWLOCK_RIN(s->rwlock.rin)
+                            == s->rwlock.rout)
+         & PLASMA_TEST_COND(!(s->rwlock.rin & PLASMA_SPIN_RWLOCK_PRES));
+}
+
+static const char * const plasma_spin_t_barriernames[] = {
+    "plasma_spin_barrier (central)",
+    "plasma_spin_barrier (dissem)",
+    "plasma_spin_barrier (tree)"
+};
+
+static struct plasma_spin_t_barshared {
+    plasma_spin_barrier_t barrier;
+                           char pad0[128-sizeof(plasma_spin_barrier_t)];
+    uint32_t arrived;      char pad1[128-sizeof(uint32_t)];
+    uint32_t serial;
+} plasma_spin_t_barshared;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+__attribute_noinline__
+static void *
+plasma_spin_t_nthreads_barrier (void * const thr_arg)
+{
+    plasma_spin_t_thr_arg * const restrict d =
+      (plasma_spin_t_thr_arg *)thr_arg;
+    struct plasma_spin_t_barshared * const restrict s =
+      &plasma_spin_t_barshared;
+    const uint32_t id = (uint32_t)d->id;
+    const uint32_t nthreads = s->barrier.nthreads;
+    const int iters = d->iters;
+    int i, rc = true;
+    uint32_t arrived;
+    for (i = 0; i < iters; ++i) {
+        plasma_atomic_fetch_add_u32(&s->arrived, 1, memory_order_relaxed);
+        if (plasma_spin_barrier_wait(&s->barrier, id))
+            plasma_atomic_fetch_add_u32(&s->serial, 1, memory_order_relaxed);
+        /* all threads arrived in this episode; none past next episode */
+        arrived = plasma_atomic_load_explicit(&s->arrived,memory_order_relaxed);
+        rc &= PLASMA_TEST_COND_IDX(arrived >= nthreads * (uint32_t)(i+1), i);
+        rc &= PLASMA_TEST_COND_IDX(arrived <= nthreads * (uint32_t)(i+2), i);
+    }
+    d->status = rc;
+    return NULL;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+__attribute_noinline__
+static int
+plasma_spin_t_nthreads_barriers (const int nthreads, const int iters)
+{
+    plasma_spin_t_thr_arg * const thr_structs =
+      plasma_test_malloc(nthreads * sizeof(plasma_spin_t_thr_arg));
+    void ** const restrict thr_args =
+      plasma_test_malloc(nthreads * sizeof(void *));
+    struct plasma_spin_t_barshared * const restrict s =
+      &plasma_spin_t_barshared;
+    struct timespec b, e;
+    int rc = true;
+    int n;
+    uint32_t t;
+
+    if (thr_structs == NULL || thr_args == NULL)
+        PLASMA_TEST_PERROR_ABORT("plasma_test_malloc", 0);
+
+    for (n=0; n < nthreads; ++n)
+        thr_args[n] = &thr_structs[n];
+
+    for (t = PLASMA_SPIN_BARRIER_CENTRAL; t <= PLASMA_SPIN_BARRIER_TREE; ++t) {
+        if (!plasma_spin_barrier_init(&s->barrier, (uint32_t)nthreads, t))
+            PLASMA_TEST_PERROR_ABORT("plasma_spin_barrier_init", 0);
+        s->arrived = 0;
+        s->serial  = 0;
+        for (n=0; n < nthreads; ++n) {
+            ((plasma_spin_t_thr_arg *)thr_args[n])->id     = n;
+            ((plasma_spin_t_thr_arg *)thr_args[n])->iters  = iters;
+            ((plasma_spin_t_thr_arg *)thr_args[n])->status = false;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &b);
+        plasma_test_nthreads(nthreads,
+                             plasma_spin_t_nthreads_barrier, thr_args, NULL);
+        clock_gettime(CLOCK_MONOTONIC, &e);
+        for (n=0; n < nthreads; ++n)
+            rc &= ((plasma_spin_t_thr_arg *)thr_args[n])->status;
+        rc &= PLASMA_TEST_COND_IDX(s->serial == (uint32_t)iters, (int)t);
+        fprintf(stderr, "%-32s %3d thr x %d iters: %.6f s\n",
+                plasma_spin_t_barriernames[t],
+                nthreads, iters, plasma_spin_t_elapsed(&b, &e));
+        plasma_spin_barrier_destroy(&s->barrier);
+    }
+
+    plasma_test_free(thr_structs);
+    plasma_test_free(thr_args);
+    return rc;
+}
+
+static const char * const plasma_spin_t_timednames[] = {
+    "plasma_spin_lock (timed)",
+    "plasma_spin_tktlock (timed)",
+    "plasma_spin_taglock (timed)",
+    "plasma_spin_clhtolock (timed)"
+};
+
+static struct plasma_spin_t_timedshared {
+    plasma_spin_lock_t    spin;    char pad0[128-sizeof(plasma_spin_lock_t)];
+    plasma_spin_tktlock_t tktlock; char pad1[128-sizeof(plasma_spin_tktlock_t)];
+    plasma_spin_taglock_t taglock; char pad2[128-sizeof(plasma_spin_taglock_t)];
+    plasma_spin_clhtolock_t clhtolock;
+                           char pad2a[128-sizeof(plasma_spin_clhtolock_t)];
+    uint64_t counter;              char pad3[128-sizeof(uint64_t)];
+    int locktype;
+} plasma_spin_t_timedshared;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+__attribute_noinline__
+static void *
+plasma_spin_t_nthreads_timedlock (void * const thr_arg)
+{
+    /* short timeouts (0 to 1.5us) and critical section with a few pauses
+     * so that many waiters abandon queue;
+     * tktlock and clhtolock mix plain acquire with timed acquire */
+    plasma_spin_t_thr_arg * const restrict d =
+      (plasma_spin_t_thr_arg *)thr_arg;
+    struct plasma_spin_t_timedshared * const restrict s =
+      &plasma_spin_t_timedshared;
+    const int iters = d->iters;
+    int i, j, acquired = 0;
+    uint64_t ns;
+    for (i = 0; i < iters; ++i) {
+        ns = (uint64_t)(i & 15) * 100;
+        switch (s->locktype) {
+          case 0:
+            if (!plasma_spin_lock_acquire_for(&s->spin, ns))
+                continue;
+            ++s->counter;
+            for (j = 0; j < 8; ++j) plasma_spin_pause();
+            plasma_spin_lock_release(&s->spin);
+            break;
+          case 1:
+            if ((i & 7) == 0)
+                plasma_spin_tktlock_acquire(&s->tktlock);
+            else if (!plasma_spin_tktlock_acquire_for(&s->tktlock, ns))
+                continue;
+            ++s->counter;
+            for (j = 0; j < 8; ++j) plasma_spin_pause();
+            plasma_spin_tktlock_release_timed(&s->tktlock);
+            break;
+          case 2:
+            if (!plasma_spin_taglock_acquire_for(&s->taglock, ns))
+                continue;
+            ++s->counter;
+            for (j = 0; j < 8; ++j) plasma_spin_pause();
+            plasma_spin_taglock_release(&s->taglock);
+            break;
+          case 3:
+            if ((i & 7) == 0) {
+                if (!plasma_spin_clhtolock_acquire(&s->clhtolock))
+                    continue;
+            }
+            else if (!plasma_spin_clhtolock_acquire_for(&s->clhtolock, ns))
+                continue;
+            ++s->counter;
+            for (j = 0; j < 8; ++j) plasma_spin_pause();
+            plasma_spin_clhtolock_release(&s->clhtolock);
+            break;
+          default:
+            break;
+        }
+        ++acquired;
+    }
+    d->acquired = acquired;
+    d->status = true;
+    return NULL;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+__attribute_noinline__
+static int
+plasma_spin_t_nthreads_timed (const int nthreads, const int iters)
+{
+    plasma_spin_t_thr_arg * const thr_structs =
+      plasma_test_malloc(nthreads * sizeof(plasma_spin_t_thr_arg));
+    void ** const restrict thr_args =
+      plasma_test_malloc(nthreads * sizeof(void *));
+    struct plasma_spin_t_timedshared * const restrict s =
+      &plasma_spin_t_timedshared;
+    struct timespec b, e;
+    uint64_t acquired;
+    int rc = true;
+    int n, t;
+
+    if (thr_structs == NULL || thr_args == NULL)
+        PLASMA_TEST_PERROR_ABORT("plasma_test_malloc", 0);
+
+    for (n=0; n < nthreads; ++n)
+        thr_args[n] = &thr_structs[n];
+
+    plasma_spin_lock_init(&s->spin);
+    plasma_spin_tktlock_init(&s->tktlock);
+    plasma_spin_taglock_init(&s->taglock);
+    plasma_spin_clhtolock_init(&s->clhtolock);
+
+    for (t = 0; t < 4; ++t) {
+        s->locktype = t;
+        s->counter  = 0;
+        for (n=0; n < nthreads; ++n) {
+            ((plasma_spin_t_thr_arg *)thr_args[n])->iters    = iters;
+            ((plasma_spin_t_thr_arg *)thr_args[n])->status   = false;
+            ((plasma_spin_t_thr_arg *)thr_args[n])->acquired = 0;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &b);
+        plasma_test_nthreads(nthreads,
+                             plasma_spin_t_nthreads_timedlock, thr_args, NULL);
+        clock_gettime(CLOCK_MONOTONIC, &e);
+        acquired = 0;
+        for (n=0; n < nthreads; ++n) {
+            rc &= ((plasma_spin_t_thr_arg *)thr_args[n])->status;
+            acquired +=
+              (uint64_t)((plasma_spin_t_thr_arg *)thr_args[n])->acquired;
+        }
+        rc &= PLASMA_TEST_COND_IDX(s->counter == acquired, t);
+        fprintf(stderr, "%-32s %3d thr x %d iters: %.6f s (%llu timeouts)\n",
+                plasma_spin_t_timednames[t], nthreads, iters,
+                plasma_spin_t_elapsed(&b, &e),
+                (unsigned long long)((uint64_t)nthreads*(uint64_t)iters
+                                     - acquired));
+    }
+
+    /* abandoned tickets and tags must not leave locks held */
+    rc &= PLASMA_TEST_COND(plasma_spin_tktlock_is_free(&s->tktlock));
+    rc &= PLASMA_TEST_COND(s->tktlock.udata64 == 0);
+    rc &= PLASMA_TEST_COND(plasma_spin_taglock_acquire_try(&s->taglock));
+    plasma_spin_taglock_release(&s->taglock);
+    rc &= PLASMA_TEST_COND(s->taglock.lck == s->taglock.tag);
+    rc &= PLASMA_TEST_COND(plasma_spin_lock_acquire_try(&s->spin));
+    plasma_spin_lock_release(&s->spin);
+    /* (tail might remain set to released node after waiter at tail aborts;
+     *  acquire_try passes through released node) */
+    rc &= PLASMA_TEST_COND(plasma_spin_clhtolock_acquire_try(&s->clhtolock));
+    /* (acquire_try while held aborts and swings tail back to holder node) */
+    rc &= PLASMA_TEST_COND(!plasma_spin_clhtolock_acquire_try(&s->clhtolock));
+    plasma_spin_clhtolock_release(&s->clhtolock);
+    rc &= PLASMA_TEST_COND(plasma_spin_clhtolock_is_free(&s->clhtolock));
+    rc &= PLASMA_TEST_COND(plasma_spin_clhtolock_acquire_try(&s->clhtolock));
+    plasma_spin_clhtolock_release(&s->clhtolock);
+    rc &= PLASMA_TEST_COND(plasma_spin_clhtolock_is_free(&s->clhtolock));
+
+    plasma_test_free(thr_structs);
+    plasma_test_free(thr_args);
+    return rc;
+}
+
+/* plasma_spin_mcslock and plasma_spin_clhlock park waiters: thread 0 holds
+ * lock until all other threads are queued and blocked in kernel (Linux; else
+ * pauses), and then releases; each handoff must wake parked successor (lost
+ * wakeup hangs; test is killed by alarm()) */
+#define PLASMA_SPIN_T_PARKERS 4
+
+static struct plasma_spin_t_parkshared {
+    plasma_spin_mcslock_t mcslock;
+    plasma_spin_clhlock_t clhlock;
+    uint32_t arrived;
+    uint32_t acquired;
+    uint32_t acquired_held;  /* acquired while thread 0 held lock */
+    bool clh;
+    long tids[PLASMA_SPIN_T_PARKERS+1];
+} plasma_spin_t_parkshared;
+
+static void *
+plasma_spin_t_nthreads_park (void * const thr_arg)
+{
+    struct plasma_spin_t_parkshared * const restrict s =
+      &plasma_spin_t_parkshared;
+    const int id = (int)(uintptr_t)thr_arg;
+    plasma_spin_mcslock_node_t mcsnode;
+    if (id == 0) {
+        if (s->clh)
+            plasma_spin_clhlock_acquire(&s->clhlock);
+        else
+            plasma_spin_mcslock_acquire(&s->mcslock, &mcsnode);
+        plasma_test_barrier_wait();
+        plasma_test_await_count(&s->arrived, PLASMA_SPIN_T_PARKERS);
+        (void)plasma_test_wait_blocked(s->tids+1, PLASMA_SPIN_T_PARKERS);
+        s->acquired_held =
+          plasma_atomic_load_explicit(&s->acquired, memory_order_seq_cst);
+        if (s->clh)
+            plasma_spin_clhlock_release(&s->clhlock);
+        else
+            plasma_spin_mcslock_release(&s->mcslock, &mcsnode);
+        return NULL;
+    }
+    s->tids[id] = plasma_test_thread_id();
+    plasma_test_barrier_wait();
+    plasma_atomic_fetch_add_u32(&s->arrived, 1, memory_order_seq_cst);
+    if (s->clh) {
+        plasma_spin_clhlock_acquire(&s->clhlock);
+        ++s->acquired;
+        plasma_spin_clhlock_release(&s->clhlock);
+    }
+    else {
+        plasma_spin_mcslock_acquire(&s->mcslock, &mcsnode);
+        ++s->acquired;
+        plasma_spin_mcslock_release(&s->mcslock, &mcsnode);
+    }
+    return NULL;
+}
+
+static int
+plasma_spin_t_queue_park (void)
+{
+    struct plasma_spin_t_parkshared * const restrict s =
+      &plasma_spin_t_parkshared;
+    void *args[PLASMA_SPIN_T_PARKERS+1];
+    int i, rc = true;
+    for (i = 0; i <= PLASMA_SPIN_T_PARKERS; ++i)
+        args[i] = (void *)(uintptr_t)i;
+    for (i = 0; i < 2; ++i) {
+        memset(s, 0, sizeof(*s));
+        plasma_spin_mcslock_init(&s->mcslock);
+        plasma_spin_clhlock_init(&s->clhlock);
+        s->clh = (i == 1);
+        plasma_test_nthreads(PLASMA_SPIN_T_PARKERS+1,
+                             plasma_spin_t_nthreads_park, args, NULL);
+        rc &= PLASMA_TEST_COND_IDX(s->acquired_held == 0, i);
+        rc &= PLASMA_TEST_COND_IDX(s->acquired == PLASMA_SPIN_T_PARKERS, i);
+        rc &= PLASMA_TEST_COND_IDX(s->clh
+                                   ? plasma_spin_clhlock_is_free(&s->clhlock)
+                                   : plasma_spin_mcslock_is_free(&s->mcslock),
+                                   i);
+    }
+    return rc;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int rc = true;
+    long nprocs = plasma_sysconf_nprocessors_onln();
+    int iters;
+    if (nprocs < 1)
+        nprocs = 1;
+    if (nprocs > 32)
+        nprocs = 32;  /*(place upper bound on num threads created in tests)*/
+    if (argc > 1 && atoi(argv[1]) > 0)
+        nprocs = atoi(argv[1]);
+    iters = (argc > 2 && atoi(argv[2]) > 0) ? atoi(argv[2]) : 100000;
+    /* expect all tests to complete in <2 mins  (revisit as necessary)
+     * (threaded tests take more time as CPU core count increases) */
+    alarm(120);
+
+    rc &= plasma_spin_t_pause_ns();
+    rc &= plasma_spin_t_uncontended(iters * 10);
+    rc &= plasma_spin_t_nthreads((int)nprocs, iters);
+    rc &= plasma_spin_t_nthreads_rw((int)nprocs, iters);
+    rc &= plasma_spin_t_rwlock_pf_trywrlock();
+    rc &= plasma_spin_t_nthreads_barriers((int)nprocs, iters / 100 + 1);
+    rc &= plasma_spin_t_nthreads_timed((int)nprocs, iters);
+    rc &= plasma_spin_t_queue_park();
+    return !rc;
+}
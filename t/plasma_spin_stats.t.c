@@ -0,0 +1,260 @@
+/*
+ * plasma_spin_stats.t.c - plasma_spin.[ch] PLASMA_SPIN_STATS tests
+ *
+ * Copyright (c) 2026, Glue Logic LLC. All rights reserved. code()gluelogic.com
+ *
+ *  This file is part of plasma.
+ *
+ *  plasma is free software: you can redistribute it and/or modify it under
+ *  the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 2.1 of the License, or
+ *  (at your option) any later version.
+ *
+ *  plasma is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with plasma.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Verify lock statistics counters recorded with PLASMA_SPIN_STATS.
+ * plasma_spin.c must be compiled with -DPLASMA_SPIN_STATS, so build
+ * plasma_spin.c along with the test (objects listed before libplasma.a
+ * take precedence over plasma_spin.o in the archive):
+ *
+ *   $ make libplasma.a
+ *   $ gcc -std=c11 -D_XOPEN_SOURCE=700 -O3 -pthread -DPLASMA_SPIN_STATS \
+ *       t/plasma_spin_stats.t.c plasma_spin.c libplasma.a \
+ *       -o plasma_spin_stats.t
+ *   $ ./plasma_spin_stats.t [nthreads] [iterations]
+ */
+
+#ifndef _XOPEN_SOURCE
+#define _XOPEN_SOURCE 600
+#endif
+
+#include "../plasma_atomic.h"
+#include "../plasma_attr.h"
+#include "../plasma_membar.h"
+#include "../plasma_spin.h"
+#include "../plasma_stdtypes.h"
+#include "../plasma_sysconf.h"
+#include "../plasma_test.h"
+
+#ifndef PLASMA_SPIN_STATS
+#error "compile with -DPLASMA_SPIN_STATS (see build instructions above)"
+#endif
+
+#ifdef PLASMA_FEATURE_POSIX
+#include <unistd.h>  /* alarm() */
+#endif
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* uncontended acquisitions are counted, and are not counted as contended */
+static int
+plasma_spin_stats_t_uncontended (const int iters)
+{
+    plasma_spin_lock_t spin = PLASMA_SPIN_LOCK_INITIALIZER;
+    plasma_spin_tktlock_t tkt = PLASMA_SPIN_TKTLOCK_INITIALIZER;
+    plasma_spin_stats_t st;
+    int i, rc = true;
+
+    rc &= PLASMA_TEST_COND(!plasma_spin_stats_get(&spin, &st));
+    for (i = 0; i < iters; ++i) {
+        (void)plasma_spin_lock_acquire(&spin);
+        plasma_spin_lock_release(&spin);
+        (void)plasma_spin_tktlock_acquire(&tkt);
+        plasma_spin_tktlock_release(&tkt);
+    }
+    rc &= PLASMA_TEST_COND(plasma_spin_stats_get(&spin, &st));
+    rc &= PLASMA_TEST_COND(st.lock == &spin);
+    rc &= PLASMA_TEST_COND(st.acquisitions == (uint64_t)iters);
+    rc &= PLASMA_TEST_COND(st.contended == 0);
+    rc &= PLASMA_TEST_COND(st.spins == 0 && st.yields == 0);
+    rc &= PLASMA_TEST_COND(plasma_spin_stats_get(&tkt, &st));
+    rc &= PLASMA_TEST_COND(st.acquisitions == (uint64_t)iters);
+    rc &= PLASMA_TEST_COND(st.contended == 0);
+
+    /* reset of one lock leaves stats for other locks intact */
+    plasma_spin_stats_reset(&spin);
+    rc &= PLASMA_TEST_COND(plasma_spin_stats_get(&spin, &st));
+    rc &= PLASMA_TEST_COND(st.acquisitions == 0 && st.hold_ns_total == 0);
+    rc &= PLASMA_TEST_COND(plasma_spin_stats_get(&tkt, &st));
+    rc &= PLASMA_TEST_COND(st.acquisitions == (uint64_t)iters);
+    plasma_spin_stats_reset(NULL);
+    rc &= PLASMA_TEST_COND(plasma_spin_stats_get(&tkt, &st));
+    rc &= PLASMA_TEST_COND(st.acquisitions == 0);
+    return rc;
+}
+
+/* Known contention: each round, holder thread acquires tktlock, lets waiter
+ * thread take a ticket, and releases only after waiter ticket is observed.
+ * Every waiter acquisition is contended; no holder acquisition is contended
+ * (holder acquires only after waiter has released lock for previous round)*/
+static struct plasma_spin_stats_t_rounds {
+    plasma_spin_tktlock_t tkt;
+    uint32_t round;     /* round begun by holder */
+    uint32_t done;      /* round completed by waiter */
+    uint32_t nrounds;
+} plasma_spin_stats_t_rounds;
+
+static void *
+plasma_spin_stats_t_roundthr (void * const thr_arg)
+{
+    struct plasma_spin_stats_t_rounds * const restrict s =
+      &plasma_spin_stats_t_rounds;
+    uint32_t i;
+    if (thr_arg != NULL) { /* holder */
+        for (i = 1; i <= s->nrounds; ++i) {
+            (void)plasma_spin_tktlock_acquire(&s->tkt);
+            plasma_atomic_store_explicit(&s->round, i, memory_order_release);
+            /* wait for waiter to take ticket (ticket count in high 16 bits)*/
+            while (PLASMA_SPIN_TKTLOCK_SHIFT(
+                     plasma_atomic_load_explicit(&s->tkt.lck.u,
+                                                 memory_order_acquire))
+                   == PLASMA_SPIN_TKTLOCK_MASK(s->tkt.lck.u) + 1u)
+                plasma_spin_yield();
+            plasma_spin_tktlock_release(&s->tkt);
+            while (plasma_atomic_load_explicit(&s->done,
+                                               memory_order_acquire) != i)
+                plasma_spin_yield();
+        }
+    }
+    else {                 /* waiter */
+        for (i = 1; i <= s->nrounds; ++i) {
+            while (plasma_atomic_load_explicit(&s->round,
+                                               memory_order_acquire) != i)
+                plasma_spin_yield();
+            (void)plasma_spin_tktlock_acquire(&s->tkt);
+            plasma_spin_tktlock_release(&s->tkt);
+            plasma_atomic_store_explicit(&s->done, i, memory_order_release);
+        }
+    }
+    return NULL;
+}
+
+static int
+plasma_spin_stats_t_contended (const int nrounds)
+{
+    struct plasma_spin_stats_t_rounds * const restrict s =
+      &plasma_spin_stats_t_rounds;
+    static int holder;
+    void *args[2] = { &holder, NULL };
+    plasma_spin_stats_t st, snap[4];
+    size_t n, i;
+    int found = 0, rc = true;
+
+    plasma_spin_tktlock_init(&s->tkt);
+    s->round = 0;
+    s->done = 0;
+    s->nrounds = (uint32_t)nrounds;
+    plasma_test_nthreads(2, plasma_spin_stats_t_roundthr, args, NULL);
+
+    rc &= PLASMA_TEST_COND(plasma_spin_stats_get(&s->tkt, &st));
+    rc &= PLASMA_TEST_COND(st.acquisitions == 2u * (uint64_t)nrounds);
+    rc &= PLASMA_TEST_COND(st.contended == (uint64_t)nrounds);
+    rc &= PLASMA_TEST_COND(st.spins + st.yields >= st.contended);
+    rc &= PLASMA_TEST_COND(st.wait_ns_total >= st.wait_ns_max);
+    rc &= PLASMA_TEST_COND(st.wait_ns_max != 0);
+    rc &= PLASMA_TEST_COND(st.hold_ns_total >= st.hold_ns_max);
+    fprintf(stderr, "plasma_spin_stats (tktlock) %d rounds: "
+                    "%llu acquired, %llu contended, %llu spins, %llu yields\n",
+            nrounds, (unsigned long long)st.acquisitions,
+            (unsigned long long)st.contended, (unsigned long long)st.spins,
+            (unsigned long long)st.yields);
+
+    /* snapshot includes lock (table also holds locks from uncontended test) */
+    n = plasma_spin_stats_snapshot(snap, sizeof(snap)/sizeof(*snap));
+    for (i = 0; i < n; ++i) {
+        if (snap[i].lock == &s->tkt) {
+            ++found;
+            rc &= PLASMA_TEST_COND(snap[i].contended == st.contended);
+        }
+    }
+    rc &= PLASMA_TEST_COND(found == 1);
+
+    plasma_spin_stats_reset(NULL);
+    rc &= PLASMA_TEST_COND(plasma_spin_stats_get(&s->tkt, &st));
+    rc &= PLASMA_TEST_COND(st.acquisitions == 0 && st.contended == 0);
+    rc &= PLASMA_TEST_COND(st.spins == 0 && st.yields == 0);
+    rc &= PLASMA_TEST_COND(st.wait_ns_total == 0 && st.wait_ns_max == 0);
+    rc &= PLASMA_TEST_COND(st.hold_ns_total == 0 && st.hold_ns_max == 0);
+    return rc;
+}
+
+/* free-running contention: every acquisition is counted exactly once */
+static plasma_spin_lock_t plasma_spin_stats_t_lock =
+  PLASMA_SPIN_LOCK_INITIALIZER;
+static uint64_t plasma_spin_stats_t_counter;
+
+static void *
+plasma_spin_stats_t_nthreads_lock (void * const thr_arg)
+{
+    const int iters = *(const int *)thr_arg;
+    int i;
+    plasma_test_barrier_wait();
+    for (i = 0; i < iters; ++i) {
+        (void)plasma_spin_lock_acquire(&plasma_spin_stats_t_lock);
+        ++plasma_spin_stats_t_counter;
+        plasma_spin_lock_release(&plasma_spin_stats_t_lock);
+    }
+    return NULL;
+}
+
+static int
+plasma_spin_stats_t_nthreads (const int nthreads, const int iters)
+{
+    void ** const args = plasma_test_calloc((size_t)nthreads, sizeof(void*));
+    plasma_spin_stats_t st;
+    int i, rc = true;
+    if (args == NULL)
+        PLASMA_TEST_PERROR_ABORT("plasma_test_calloc", errno);
+    for (i = 0; i < nthreads; ++i)
+        args[i] = (void *)&iters;
+    plasma_spin_stats_t_counter = 0;
+    plasma_test_nthreads(nthreads, plasma_spin_stats_t_nthreads_lock,
+                         args, NULL);
+    plasma_test_free(args);
+
+    rc &= PLASMA_TEST_COND(plasma_spin_stats_get(&plasma_spin_stats_t_lock,
+                                                 &st));
+    rc &= PLASMA_TEST_COND(st.acquisitions == plasma_spin_stats_t_counter);
+    rc &= PLASMA_TEST_COND(st.acquisitions
+                           == (uint64_t)nthreads * (uint64_t)iters);
+    rc &= PLASMA_TEST_COND(st.contended <= st.acquisitions);
+    fprintf(stderr, "plasma_spin_stats (lock) %d thr x %d iters: "
+                    "%llu acquired, %llu contended\n",
+            nthreads, iters, (unsigned long long)st.acquisitions,
+            (unsigned long long)st.contended);
+    plasma_spin_stats_reset(&plasma_spin_stats_t_lock);
+    rc &= PLASMA_TEST_COND(plasma_spin_stats_get(&plasma_spin_stats_t_lock,
+                                                 &st));
+    rc &= PLASMA_TEST_COND(st.acquisitions == 0 && st.contended == 0);
+    return rc;
+}
+
+int
+main (int argc, char *argv[])
+{
+    int rc = true;
+    long nprocs = plasma_sysconf_nprocessors_onln();
+    int iters;
+    if (nprocs < 2)
+        nprocs = 2;
+    if (nprocs > 32)
+        nprocs = 32;  /*(place upper bound on num threads created in tests)*/
+    if (argc > 1 && atoi(argv[1]) > 0)
+        nprocs = atoi(argv[1]);
+    iters = (argc > 2 && atoi(argv[2]) > 0) ? atoi(argv[2]) : 100000;
+    alarm(120);
+
+    rc &= plasma_spin_stats_t_uncontended(iters);
+    rc &= plasma_spin_stats_t_contended(iters / 100 + 1);
+    rc &= plasma_spin_stats_t_nthreads((int)nprocs, iters);
+    return !rc;
+}